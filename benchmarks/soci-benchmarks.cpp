@@ -0,0 +1,725 @@
+//
+// Copyright (C) 2004-2016 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Microbenchmarks for the core SOCI code paths.
+//
+// The benchmarks are run against the Empty backend, which measures the
+// overhead of SOCI itself, and, if available, against an in-memory SQLite3
+// database, which is the cheapest real backend. The results are written in
+// JSON format to make it simple to compare them between different builds.
+
+#include "soci/soci.h"
+#include "soci/connection-pool.h"
+#include "soci/version.h"
+#include "soci/empty/soci-empty.h"
+
+#ifdef SOCI_BENCHMARKS_HAVE_SQLITE3
+#include "soci/sqlite3/soci-sqlite3.h"
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <time.h>
+#endif
+
+using namespace soci;
+
+namespace // unnamed
+{
+
+// Number of rows in the table used by the fetch benchmarks.
+int const table_rows = 1000;
+
+// Number of rows inserted by a single execution of the bulk insert.
+int const bulk_rows = 100;
+
+// Size of the pool and number of threads competing for its sessions.
+std::size_t const pool_size = 4;
+int const pool_threads = 8;
+
+// Monotonic time in nanoseconds.
+double now_ns()
+{
+#ifdef _WIN32
+    static LARGE_INTEGER freq;
+    if (freq.QuadPart == 0)
+    {
+        QueryPerformanceFrequency(&freq);
+    }
+
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return static_cast<double>(counter.QuadPart) * 1e9 / freq.QuadPart;
+#else
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<double>(ts.tv_sec) * 1e9 + ts.tv_nsec;
+#endif
+}
+
+// Context passed to every benchmark.
+struct bench_context
+{
+    std::string backend;
+    std::string connectString;
+    backend_factory const * factory;
+
+    // Session opened before running the benchmark, possibly with a table
+    // already filled with the test data.
+    session * sql;
+
+    // Number of iterations requested by the user.
+    int iterations;
+};
+
+// Each benchmark performs the given number of iterations and returns the
+// total number of operations done, which is used to normalize the timings.
+typedef long (*bench_function)(bench_context & ctx);
+
+struct bench_info
+{
+    char const * name;
+    bench_function func;
+
+    // If true, the benchmark needs a real database returning rows.
+    bool needsRows;
+};
+
+// Record used to measure the cost of type_conversion<> and values.
+struct bench_record
+{
+    int id;
+    double val;
+    std::string txt;
+};
+
+} // unnamed namespace
+
+namespace soci
+{
+
+template <>
+struct type_conversion<bench_record>
+{
+    typedef values base_type;
+
+    static void from_base(values const & v, indicator /* ind */,
+        bench_record & r)
+    {
+        r.id = v.get<int>("id");
+        r.val = v.get<double>("val");
+        r.txt = v.get<std::string>("txt");
+    }
+
+    static void to_base(bench_record const & r, values & v, indicator & ind)
+    {
+        v.set("id", r.id);
+        v.set("val", r.val);
+        v.set("txt", r.txt);
+        ind = i_ok;
+    }
+};
+
+} // namespace soci
+
+namespace // unnamed
+{
+
+// Benchmarks themselves.
+
+long bench_one_shot_query(bench_context & ctx)
+{
+    session & sql = *ctx.sql;
+
+    int x = 0;
+    for (int i = 0; i != ctx.iterations; ++i)
+    {
+        sql << "select :x", use(i), into(x);
+    }
+
+    return ctx.iterations;
+}
+
+long bench_one_shot_query_cached(bench_context & ctx)
+{
+    session & sql = *ctx.sql;
+
+    sql.set_statement_cache_size(16);
+
+    int x = 0;
+    for (int i = 0; i != ctx.iterations; ++i)
+    {
+        sql << "select :x", use(i), into(x);
+    }
+
+    sql.set_statement_cache_size(0);
+
+    return ctx.iterations;
+}
+
+long bench_prepared_reexecution(bench_context & ctx)
+{
+    session & sql = *ctx.sql;
+
+    int i = 0;
+    int x = 0;
+    statement st = (sql.prepare << "select :x", use(i), into(x));
+    for (i = 0; i != ctx.iterations; ++i)
+    {
+        st.execute(true);
+    }
+
+    return ctx.iterations;
+}
+
+long bench_single_insert(bench_context & ctx)
+{
+    session & sql = *ctx.sql;
+
+    int id = 0;
+    double val = 0.5;
+    std::string txt("single");
+
+    transaction tr(sql);
+
+    statement st = (sql.prepare <<
+        "insert into soci_bench_ins(id, val, txt) values(:id, :val, :txt)",
+        use(id), use(val), use(txt));
+
+    long const rows = static_cast<long>(ctx.iterations) * bulk_rows;
+    for (long n = 0; n != rows; ++n)
+    {
+        id = static_cast<int>(n);
+        st.execute(true);
+    }
+
+    tr.rollback();
+
+    return rows;
+}
+
+long bench_bulk_insert(bench_context & ctx)
+{
+    session & sql = *ctx.sql;
+
+    std::vector<int> ids(bulk_rows);
+    std::vector<double> vals(bulk_rows, 0.5);
+    std::vector<std::string> txts(bulk_rows, "bulk");
+
+    transaction tr(sql);
+
+    statement st = (sql.prepare <<
+        "insert into soci_bench_ins(id, val, txt) values(:id, :val, :txt)",
+        use(ids), use(vals), use(txts));
+
+    for (int i = 0; i != ctx.iterations; ++i)
+    {
+        for (int n = 0; n != bulk_rows; ++n)
+        {
+            ids[n] = i * bulk_rows + n;
+        }
+
+        st.execute(true);
+    }
+
+    tr.rollback();
+
+    return static_cast<long>(ctx.iterations) * bulk_rows;
+}
+
+long bench_rowset_row(bench_context & ctx)
+{
+    session & sql = *ctx.sql;
+
+    long rows = 0;
+    long long sum = 0;
+    for (int i = 0; i != ctx.iterations; ++i)
+    {
+        rowset<row> rs = (sql.prepare << "select id, val, txt from soci_bench");
+        for (rowset<row>::const_iterator it = rs.begin(); it != rs.end(); ++it)
+        {
+            sum += it->get<int>(0);
+            ++rows;
+        }
+    }
+
+    return sum >= 0 ? rows : 0;
+}
+
+long bench_rowset_int(bench_context & ctx)
+{
+    session & sql = *ctx.sql;
+
+    long rows = 0;
+    long long sum = 0;
+    for (int i = 0; i != ctx.iterations; ++i)
+    {
+        rowset<int> rs = (sql.prepare << "select id from soci_bench");
+        for (rowset<int>::const_iterator it = rs.begin(); it != rs.end(); ++it)
+        {
+            sum += *it;
+            ++rows;
+        }
+    }
+
+    return sum >= 0 ? rows : 0;
+}
+
+long bench_rowset_int_batched(bench_context & ctx)
+{
+    session & sql = *ctx.sql;
+
+    long rows = 0;
+    long long sum = 0;
+    for (int i = 0; i != ctx.iterations; ++i)
+    {
+        rowset<int> rs = (sql.prepare << "select id from soci_bench",
+            fetch_size(bulk_rows));
+        for (rowset<int>::const_iterator it = rs.begin(); it != rs.end(); ++it)
+        {
+            sum += *it;
+            ++rows;
+        }
+    }
+
+    return sum >= 0 ? rows : 0;
+}
+
+long bench_vector_fetch(bench_context & ctx)
+{
+    session & sql = *ctx.sql;
+
+    long rows = 0;
+    long long sum = 0;
+    std::vector<int> ids(bulk_rows);
+    for (int i = 0; i != ctx.iterations; ++i)
+    {
+        ids.resize(bulk_rows);
+        statement st = (sql.prepare << "select id from soci_bench", into(ids));
+        st.execute();
+        while (st.fetch())
+        {
+            for (std::size_t n = 0; n != ids.size(); ++n)
+            {
+                sum += ids[n];
+            }
+
+            rows += static_cast<long>(ids.size());
+            ids.resize(bulk_rows);
+        }
+    }
+
+    return sum >= 0 ? rows : 0;
+}
+
+long bench_type_conversion(bench_context & ctx)
+{
+    session & sql = *ctx.sql;
+
+    long rows = 0;
+    long long sum = 0;
+    for (int i = 0; i != ctx.iterations; ++i)
+    {
+        rowset<bench_record> rs =
+            (sql.prepare << "select id, val, txt from soci_bench");
+        for (rowset<bench_record>::const_iterator it = rs.begin();
+             it != rs.end(); ++it)
+        {
+            sum += it->id;
+            ++rows;
+        }
+    }
+
+    return sum >= 0 ? rows : 0;
+}
+
+struct pool_thread_data
+{
+    connection_pool * pool;
+    int iterations;
+};
+
+#ifdef _WIN32
+DWORD WINAPI pool_thread_func(LPVOID arg)
+#else
+void * pool_thread_func(void * arg)
+#endif
+{
+    pool_thread_data * const data = static_cast<pool_thread_data *>(arg);
+
+    for (int i = 0; i != data->iterations; ++i)
+    {
+        std::size_t const pos = data->pool->lease();
+        data->pool->at(pos).get_backend();
+        data->pool->give_back(pos);
+    }
+
+    return 0;
+}
+
+long bench_pool_lease(bench_context & ctx)
+{
+    connection_pool pool(pool_size);
+    for (std::size_t n = 0; n != pool_size; ++n)
+    {
+        pool.at(n).open(*ctx.factory, ctx.connectString);
+    }
+
+    pool_thread_data data;
+    data.pool = &pool;
+    data.iterations = ctx.iterations;
+
+#ifdef _WIN32
+    HANDLE threads[pool_threads];
+    for (int t = 0; t != pool_threads; ++t)
+    {
+        threads[t] = CreateThread(NULL, 0, pool_thread_func, &data, 0, NULL);
+        if (threads[t] == NULL)
+        {
+            throw soci_error("Failed to create benchmark thread.");
+        }
+    }
+
+    WaitForMultipleObjects(pool_threads, threads, TRUE, INFINITE);
+    for (int t = 0; t != pool_threads; ++t)
+    {
+        CloseHandle(threads[t]);
+    }
+#else
+    pthread_t threads[pool_threads];
+    for (int t = 0; t != pool_threads; ++t)
+    {
+        if (pthread_create(&threads[t], NULL, pool_thread_func, &data) != 0)
+        {
+            throw soci_error("Failed to create benchmark thread.");
+        }
+    }
+
+    for (int t = 0; t != pool_threads; ++t)
+    {
+        pthread_join(threads[t], NULL);
+    }
+#endif
+
+    return static_cast<long>(ctx.iterations) * pool_threads;
+}
+
+bench_info const all_benchmarks[] =
+{
+    { "one_shot_query",         bench_one_shot_query,           false },
+    { "one_shot_query_cached",  bench_one_shot_query_cached,    false },
+    { "prepared_reexecution",   bench_prepared_reexecution,     false },
+    { "single_insert",          bench_single_insert,            false },
+    { "bulk_insert",            bench_bulk_insert,              false },
+    { "rowset_row",             bench_rowset_row,               true  },
+    { "rowset_int",             bench_rowset_int,               true  },
+    { "rowset_int_batched",     bench_rowset_int_batched,       true  },
+    { "vector_fetch",           bench_vector_fetch,             true  },
+    { "type_conversion",        bench_type_conversion,          true  },
+    { "pool_lease",             bench_pool_lease,               false }
+};
+
+std::size_t const num_benchmarks
+    = sizeof(all_benchmarks) / sizeof(all_benchmarks[0]);
+
+// Result of running a single benchmark several times.
+struct bench_result
+{
+    std::string name;
+    std::string backend;
+    int iterations;
+    int repetitions;
+    double nsPerOpMin;
+    double nsPerOpMedian;
+    double nsPerOpMean;
+};
+
+// Create the tables used by the benchmarks, if the backend supports them.
+void setup_session(bench_context & ctx, bool withRows)
+{
+    ctx.sql->open(*ctx.factory, ctx.connectString);
+
+    if (!withRows)
+    {
+        return;
+    }
+
+    session & sql = *ctx.sql;
+
+    sql << "create table soci_bench(id integer, val real, txt varchar(20))";
+    sql << "create table soci_bench_ins(id integer, val real, txt varchar(20))";
+
+    std::vector<int> ids(table_rows);
+    std::vector<double> vals(table_rows);
+    std::vector<std::string> txts(table_rows);
+    for (int n = 0; n != table_rows; ++n)
+    {
+        ids[n] = n;
+        vals[n] = n * 0.5;
+        txts[n] = "row";
+    }
+
+    transaction tr(sql);
+    sql << "insert into soci_bench(id, val, txt) values(:id, :val, :txt)",
+        use(ids), use(vals), use(txts);
+    tr.commit();
+}
+
+bench_result run_benchmark(bench_info const & info, bench_context & ctx,
+    int repetitions, bool withRows)
+{
+    std::vector<double> timings;
+    timings.reserve(repetitions);
+
+    // Do one untimed run first to warm up the caches.
+    for (int r = -1; r != repetitions; ++r)
+    {
+        session sql;
+        ctx.sql = &sql;
+        setup_session(ctx, withRows);
+
+        double const start = now_ns();
+        long const ops = info.func(ctx);
+        double const elapsed = now_ns() - start;
+
+        ctx.sql = NULL;
+
+        if (r >= 0 && ops > 0)
+        {
+            timings.push_back(elapsed / ops);
+        }
+    }
+
+    bench_result res;
+    res.name = info.name;
+    res.backend = ctx.backend;
+    res.iterations = ctx.iterations;
+    res.repetitions = repetitions;
+    res.nsPerOpMin = 0;
+    res.nsPerOpMedian = 0;
+    res.nsPerOpMean = 0;
+
+    if (!timings.empty())
+    {
+        std::sort(timings.begin(), timings.end());
+
+        double total = 0;
+        for (std::size_t n = 0; n != timings.size(); ++n)
+        {
+            total += timings[n];
+        }
+
+        std::size_t const mid = timings.size() / 2;
+
+        res.nsPerOpMin = timings.front();
+        res.nsPerOpMedian = timings.size() % 2
+                                ? timings[mid]
+                                : (timings[mid - 1] + timings[mid]) / 2;
+        res.nsPerOpMean = total / timings.size();
+    }
+
+    return res;
+}
+
+void write_json(std::FILE * out, std::vector<bench_result> const & results)
+{
+    std::fprintf(out, "{\n");
+    std::fprintf(out, "  \"soci_version\": \"%s\",\n", SOCI_LIB_VERSION);
+    std::fprintf(out, "  \"benchmarks\": [");
+
+    for (std::size_t n = 0; n != results.size(); ++n)
+    {
+        bench_result const & r = results[n];
+
+        std::fprintf(out, "%s\n    {\n", n ? "," : "");
+        std::fprintf(out, "      \"name\": \"%s\",\n", r.name.c_str());
+        std::fprintf(out, "      \"backend\": \"%s\",\n", r.backend.c_str());
+        std::fprintf(out, "      \"iterations\": %d,\n", r.iterations);
+        std::fprintf(out, "      \"repetitions\": %d,\n", r.repetitions);
+        std::fprintf(out, "      \"ns_per_op_min\": %.3f,\n", r.nsPerOpMin);
+        std::fprintf(out, "      \"ns_per_op_median\": %.3f,\n",
+            r.nsPerOpMedian);
+        std::fprintf(out, "      \"ns_per_op_mean\": %.3f\n", r.nsPerOpMean);
+        std::fprintf(out, "    }");
+    }
+
+    std::fprintf(out, "\n  ]\n}\n");
+}
+
+void usage(char const * argv0)
+{
+    std::cerr
+        << "Usage: " << argv0 << " [options]\n"
+        << "\n"
+        << "Options:\n"
+        << "  --iterations N      number of iterations per run (default 10000)\n"
+        << "  --repetitions N     number of timed runs (default 5)\n"
+        << "  --backend NAME      only run with the given backend\n"
+        << "  --filter TEXT       only run benchmarks containing TEXT\n"
+        << "  --output FILE       write JSON results to FILE instead of stdout\n"
+        << "\n"
+        << "Available backends: empty"
+#ifdef SOCI_BENCHMARKS_HAVE_SQLITE3
+        << ", sqlite3"
+#endif
+        << "\n";
+}
+
+int parse_positive(char const * s, char const * what)
+{
+    int const n = std::atoi(s);
+    if (n <= 0)
+    {
+        throw soci_error(std::string("Invalid number of ") + what + ".");
+    }
+
+    return n;
+}
+
+} // unnamed namespace
+
+int main(int argc, char** argv)
+{
+    int iterations = 10000;
+    int repetitions = 5;
+    std::string onlyBackend;
+    std::string filter;
+    std::string output;
+
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string const arg = argv[i];
+            if (arg == "--help" || arg == "-h")
+            {
+                usage(argv[0]);
+                return EXIT_SUCCESS;
+            }
+
+            if (i + 1 == argc)
+            {
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+
+            char const * const value = argv[++i];
+            if (arg == "--iterations")
+            {
+                iterations = parse_positive(value, "iterations");
+            }
+            else if (arg == "--repetitions")
+            {
+                repetitions = parse_positive(value, "repetitions");
+            }
+            else if (arg == "--backend")
+            {
+                onlyBackend = value;
+            }
+            else if (arg == "--filter")
+            {
+                filter = value;
+            }
+            else if (arg == "--output")
+            {
+                output = value;
+            }
+            else
+            {
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        }
+
+        std::vector<bench_context> backends;
+
+        bench_context ctx;
+        ctx.sql = NULL;
+        ctx.iterations = iterations;
+
+        ctx.backend = "empty";
+        ctx.connectString = "";
+        ctx.factory = &empty;
+        backends.push_back(ctx);
+
+#ifdef SOCI_BENCHMARKS_HAVE_SQLITE3
+        ctx.backend = "sqlite3";
+        ctx.connectString = ":memory:";
+        ctx.factory = &sqlite3;
+        backends.push_back(ctx);
+#endif
+
+        std::vector<bench_result> results;
+        for (std::size_t b = 0; b != backends.size(); ++b)
+        {
+            bench_context & bctx = backends[b];
+            if (!onlyBackend.empty() && onlyBackend != bctx.backend)
+            {
+                continue;
+            }
+
+            // The Empty backend never stops returning rows, so skip the
+            // benchmarks which fetch until the end of the result set.
+            bool const withRows = bctx.backend != "empty";
+
+            for (std::size_t n = 0; n != num_benchmarks; ++n)
+            {
+                bench_info const & info = all_benchmarks[n];
+                if (info.needsRows && !withRows)
+                {
+                    continue;
+                }
+
+                if (!filter.empty() &&
+                    std::string(info.name).find(filter) == std::string::npos)
+                {
+                    continue;
+                }
+
+                std::cerr << "Running " << bctx.backend << "/" << info.name
+                          << "...\n";
+
+                results.push_back(
+                    run_benchmark(info, bctx, repetitions, withRows));
+            }
+        }
+
+        if (output.empty())
+        {
+            write_json(stdout, results);
+        }
+        else
+        {
+            std::FILE * const out = std::fopen(output.c_str(), "w");
+            if (!out)
+            {
+                throw soci_error("Failed to open \"" + output + "\".");
+            }
+
+            write_json(out, results);
+            std::fclose(out);
+        }
+    }
+    catch (std::exception const & e)
+    {
+        std::cerr << "Error: " << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,51 @@
+//
+// Copyright (C) 2004-2016 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_PRIVATE_SOCI_CLOCK_H_INCLUDED
+#define SOCI_PRIVATE_SOCI_CLOCK_H_INCLUDED
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+namespace soci
+{
+
+namespace details
+{
+
+// Return the current value of a monotonic clock in nanoseconds.
+//
+// The absolute value is meaningless, only the difference between two values
+// returned by this function can be used, e.g. to measure durations.
+inline long long monotonic_time_ns()
+{
+#ifdef _WIN32
+    LARGE_INTEGER freq;
+    QueryPerformanceFrequency(&freq);
+
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+
+    // Avoid overflowing when multiplying the counter by 10^9.
+    long long const seconds = counter.QuadPart / freq.QuadPart;
+    long long const rest = counter.QuadPart % freq.QuadPart;
+    return seconds * 1000000000LL + rest * 1000000000LL / freq.QuadPart;
+#else
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<long long>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+#endif
+}
+
+} // namespace details
+
+} // namespace soci
+
+#endif // SOCI_PRIVATE_SOCI_CLOCK_H_INCLUDED
@@ -0,0 +1,58 @@
+//
+// Copyright (C) 2004-2016 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_PRIVATE_SOCI_QUERY_TIMEOUT_H_INCLUDED
+#define SOCI_PRIVATE_SOCI_QUERY_TIMEOUT_H_INCLUDED
+
+#include "soci/soci-backend.h"
+
+namespace soci
+{
+
+namespace details
+{
+
+// Cancels the operation executed by the statement if it doesn't complete
+// within the given timeout, which is done by a background thread shared by
+// all the guards.
+//
+// The guard is armed by its ctor, unless the timeout is not positive, and
+// disarmed by its dtor or an explicit call to disarm().
+class query_timeout_guard
+{
+public:
+    query_timeout_guard(statement_backend * backEnd, int timeoutMs);
+    ~query_timeout_guard() { disarm(); }
+
+    void disarm();
+
+    // Disarm the guard and throw query_timeout_error if the timeout expired.
+    // This is meant to be called when the operation fails, to report the
+    // failure caused by its cancellation as a timeout.
+    void throw_if_expired();
+
+    // These fields are only used by the watchdog thread, or with its mutex
+    // locked.
+    statement_backend * const backEnd_;
+    long long deadlineNs_;
+    bool expired_;
+
+    // True while the watchdog thread is cancelling the operation.
+    bool cancelling_;
+
+private:
+    int const timeoutMs_;
+    bool armed_;
+
+    SOCI_NOT_COPYABLE(query_timeout_guard)
+};
+
+} // namespace details
+
+} // namespace soci
+
+#endif // SOCI_PRIVATE_SOCI_QUERY_TIMEOUT_H_INCLUDED
@@ -0,0 +1,256 @@
+//
+// Copyright (C) 2004-2016 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_PRIVATE_SOCI_THREAD_H_INCLUDED
+#define SOCI_PRIVATE_SOCI_THREAD_H_INCLUDED
+
+#include "soci/error.h"
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <sys/time.h>
+#include <errno.h>
+#else
+#include <windows.h>
+#endif
+
+namespace soci
+{
+
+namespace details
+{
+
+// Minimal portable thread support.
+typedef void (*thread_func)(void * arg);
+
+struct thread_start
+{
+    thread_func func_;
+    void * arg_;
+};
+
+#ifndef _WIN32
+
+typedef pthread_t thread_handle;
+
+inline void * thread_entry(void * arg)
+{
+    thread_start const start = *static_cast<thread_start *>(arg);
+    delete static_cast<thread_start *>(arg);
+
+    start.func_(start.arg_);
+
+    return NULL;
+}
+
+#else
+
+typedef HANDLE thread_handle;
+
+inline DWORD WINAPI thread_entry(LPVOID arg)
+{
+    thread_start const start = *static_cast<thread_start *>(arg);
+    delete static_cast<thread_start *>(arg);
+
+    start.func_(start.arg_);
+
+    return 0;
+}
+
+#endif
+
+inline thread_handle start_thread(thread_func func, void * arg)
+{
+    thread_start * const start = new thread_start;
+    start->func_ = func;
+    start->arg_ = arg;
+
+#ifndef _WIN32
+    thread_handle thread;
+    if (pthread_create(&thread, NULL, thread_entry, start) != 0)
+#else
+    thread_handle const thread
+        = CreateThread(NULL, 0, thread_entry, start, 0, NULL);
+    if (thread == NULL)
+#endif
+    {
+        delete start;
+        throw soci_error("Failed to create thread");
+    }
+
+    return thread;
+}
+
+inline void join_thread(thread_handle thread)
+{
+#ifndef _WIN32
+    pthread_join(thread, NULL);
+#else
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+#endif
+}
+
+// Let the thread run on its own: it can't be joined after calling this.
+inline void detach_thread(thread_handle thread)
+{
+#ifndef _WIN32
+    pthread_detach(thread);
+#else
+    CloseHandle(thread);
+#endif
+}
+
+class thread_mutex
+{
+public:
+#ifndef _WIN32
+    thread_mutex() { pthread_mutex_init(&mutex_, NULL); }
+    ~thread_mutex() { pthread_mutex_destroy(&mutex_); }
+
+    void lock() { pthread_mutex_lock(&mutex_); }
+    void unlock() { pthread_mutex_unlock(&mutex_); }
+#else
+    thread_mutex() { InitializeCriticalSection(&mutex_); }
+    ~thread_mutex() { DeleteCriticalSection(&mutex_); }
+
+    void lock() { EnterCriticalSection(&mutex_); }
+    void unlock() { LeaveCriticalSection(&mutex_); }
+#endif
+
+private:
+#ifndef _WIN32
+    pthread_mutex_t mutex_;
+#else
+    CRITICAL_SECTION mutex_;
+#endif
+
+    SOCI_NOT_COPYABLE(thread_mutex)
+};
+
+class thread_lock
+{
+public:
+    explicit thread_lock(thread_mutex & m) : mutex_(m) { mutex_.lock(); }
+    ~thread_lock() { mutex_.unlock(); }
+
+private:
+    thread_mutex & mutex_;
+
+    SOCI_NOT_COPYABLE(thread_lock)
+};
+
+// Event which is signaled once and stays signaled until it's reset.
+class thread_event
+{
+public:
+#ifndef _WIN32
+    thread_event() : signaled_(false)
+    {
+        pthread_mutex_init(&mutex_, NULL);
+        pthread_cond_init(&cond_, NULL);
+    }
+
+    ~thread_event()
+    {
+        pthread_cond_destroy(&cond_);
+        pthread_mutex_destroy(&mutex_);
+    }
+
+    void set()
+    {
+        pthread_mutex_lock(&mutex_);
+        signaled_ = true;
+        pthread_cond_broadcast(&cond_);
+        pthread_mutex_unlock(&mutex_);
+    }
+
+    void reset()
+    {
+        pthread_mutex_lock(&mutex_);
+        signaled_ = false;
+        pthread_mutex_unlock(&mutex_);
+    }
+
+    bool is_set()
+    {
+        pthread_mutex_lock(&mutex_);
+        bool const signaled = signaled_;
+        pthread_mutex_unlock(&mutex_);
+        return signaled;
+    }
+
+    void wait()
+    {
+        pthread_mutex_lock(&mutex_);
+        while (!signaled_)
+        {
+            pthread_cond_wait(&cond_, &mutex_);
+        }
+        pthread_mutex_unlock(&mutex_);
+    }
+
+    // Wait for at most the given number of nanoseconds, return true if the
+    // event was signaled.
+    bool wait_for(long long timeoutNs)
+    {
+        struct timeval now;
+        gettimeofday(&now, NULL);
+
+        long long const deadlineUs
+            = now.tv_sec * 1000000LL + now.tv_usec + timeoutNs / 1000;
+
+        struct timespec deadline;
+        deadline.tv_sec = static_cast<time_t>(deadlineUs / 1000000LL);
+        deadline.tv_nsec = static_cast<long>(deadlineUs % 1000000LL * 1000);
+
+        pthread_mutex_lock(&mutex_);
+        while (!signaled_)
+        {
+            if (pthread_cond_timedwait(&cond_, &mutex_, &deadline) == ETIMEDOUT)
+            {
+                break;
+            }
+        }
+        bool const signaled = signaled_;
+        pthread_mutex_unlock(&mutex_);
+
+        return signaled;
+    }
+#else
+    thread_event() : event_(CreateEvent(NULL, TRUE, FALSE, NULL)) {}
+    ~thread_event() { CloseHandle(event_); }
+
+    void set() { SetEvent(event_); }
+    void reset() { ResetEvent(event_); }
+    bool is_set() { return WaitForSingleObject(event_, 0) == WAIT_OBJECT_0; }
+    void wait() { WaitForSingleObject(event_, INFINITE); }
+
+    bool wait_for(long long timeoutNs)
+    {
+        DWORD const timeoutMs = static_cast<DWORD>((timeoutNs + 999999) / 1000000);
+        return WaitForSingleObject(event_, timeoutMs) == WAIT_OBJECT_0;
+    }
+#endif
+
+private:
+#ifndef _WIN32
+    pthread_mutex_t mutex_;
+    pthread_cond_t cond_;
+    bool signaled_;
+#else
+    HANDLE event_;
+#endif
+
+    SOCI_NOT_COPYABLE(thread_event)
+};
+
+} // namespace details
+
+} // namespace soci
+
+#endif // SOCI_PRIVATE_SOCI_THREAD_H_INCLUDED
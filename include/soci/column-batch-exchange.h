@@ -0,0 +1,75 @@
+//
+// Copyright (C) 2004-2008 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_COLUMN_BATCH_EXCHANGE_H_INCLUDED
+#define SOCI_COLUMN_BATCH_EXCHANGE_H_INCLUDED
+
+#include "soci/into-type.h"
+#include "soci/exchange-traits.h"
+#include "soci/column-batch.h"
+#include "soci/statement.h"
+// std
+#include <cstddef>
+
+namespace soci
+{
+
+namespace details
+{
+
+// Support selecting into a column batch: the columns are described and the
+// batch is filled by the backend directly, without any other into elements.
+
+template <>
+class into_type<column_batch>
+    : public into_type_base // bypass the standard_into_type
+{
+public:
+    into_type(column_batch & b) : b_(b) {}
+    into_type(column_batch & b, indicator &) : b_(b) {}
+
+private:
+    void define(statement_impl & st, int & /* position */) SOCI_OVERRIDE
+    {
+        st.set_column_batch(&b_);
+
+        // actual description of the columns is performed
+        // as part of the statement execute
+    }
+
+    void pre_exec(int /* num */) SOCI_OVERRIDE { b_.clear_rows(); }
+    void pre_fetch() SOCI_OVERRIDE {}
+    void post_fetch(bool /* gotData */, bool /* calledFromFetch */) SOCI_OVERRIDE {}
+    void clean_up() SOCI_OVERRIDE {}
+
+    // The rows are appended to the batch by the backend, so the only thing
+    // to do here is to empty it when no rows were fetched.
+    std::size_t size() const SOCI_OVERRIDE { return b_.capacity(); }
+    void resize(std::size_t sz) SOCI_OVERRIDE
+    {
+        if (sz == 0)
+        {
+            b_.clear_rows();
+        }
+    }
+
+    column_batch & b_;
+
+    SOCI_NOT_COPYABLE(into_type)
+};
+
+template <>
+struct exchange_traits<column_batch>
+{
+    typedef basic_type_tag type_family;
+};
+
+} // namespace details
+
+} // namespace soci
+
+#endif // SOCI_COLUMN_BATCH_EXCHANGE_H_INCLUDED
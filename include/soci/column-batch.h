@@ -0,0 +1,149 @@
+//
+// Copyright (C) 2004-2008 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_COLUMN_BATCH_H_INCLUDED
+#define SOCI_COLUMN_BATCH_H_INCLUDED
+
+#include "soci/soci-backend.h"
+#include "soci/row.h" // for column_properties
+// std
+#include <cstddef>
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace soci
+{
+
+// Rows fetched by a bulk operation stored column by column.
+//
+// Each column is stored as a contiguous array of values of the type
+// corresponding to its data type, i.e. int for dt_integer, long long for
+// dt_long_long, unsigned long long for dt_unsigned_long_long, double for
+// dt_double and std::tm for dt_date, together with a bitmap indicating which
+// values are not null, with the bit (row % 8) of the byte (row / 8) set for
+// each row containing a non-null value. The values of string, blob and XML
+// columns are stored one after another in a single buffer of bytes and the
+// offset of the value of each row in it is given by an array of offsets
+// containing one more element than the number of rows, so that the length of
+// each value is the difference between two consecutive offsets.
+//
+// All the arrays keep their memory when the next batch is fetched, so that,
+// once they have grown large enough, fetching doesn't allocate any more.
+class SOCI_DECL column_batch
+{
+public:
+    // The batch can contain at most the given number of rows, which is used
+    // as the number of rows fetched at once, just as the size of the vectors
+    // used with into().
+    explicit column_batch(std::size_t capacity);
+
+    std::size_t capacity() const { return capacity_; }
+
+    // Number of rows in the batch.
+    std::size_t size() const { return size_; }
+
+    std::size_t get_number_of_columns() const { return columns_.size(); }
+
+    column_properties const & get_properties(std::size_t col) const;
+    column_properties const & get_properties(std::string const & name) const;
+
+    // Return the index of the column with the given name or throw.
+    std::size_t find_column(std::string const & name) const;
+
+    bool is_null(std::size_t col, std::size_t row) const;
+
+    // Return the bitmap of the non-null values of the column.
+    unsigned char const * get_validity(std::size_t col) const;
+
+    // Return the values of a column of fixed size type, the type T must
+    // correspond to its data type as described above. The elements for the
+    // null values are value-initialized.
+    template <typename T>
+    T const * get_values(std::size_t col) const;
+
+    // Return the offsets and the bytes of a column of string, blob or XML
+    // type. The bytes are not NUL-terminated.
+    std::size_t const * get_offsets(std::size_t col) const;
+    char const * get_bytes(std::size_t col) const;
+
+    // Return the pointer to the value of a string, blob or XML column in the
+    // given row, which remains valid until the next batch is fetched, and its
+    // length.
+    char const * get_string(std::size_t col, std::size_t row,
+        std::size_t & length) const;
+
+    // The functions below are used by the library and the backends for
+    // filling the batch.
+
+    void uppercase_column_names(bool forceToUpper);
+    void add_column(column_properties const & props);
+    void clean_up();
+
+    // Remove all rows from the batch, keeping the memory allocated for them.
+    void clear_rows();
+
+    // Values of each row must be appended to all the columns in order and
+    // then end_row() must be called. The type of the function used for
+    // appending a non-null value must correspond to the column data type.
+    void append_null(std::size_t col);
+    void append_int(std::size_t col, int value);
+    void append_long_long(std::size_t col, long long value);
+    void append_unsigned_long_long(std::size_t col, unsigned long long value);
+    void append_double(std::size_t col, double value);
+    void append_date(std::size_t col, std::tm const & value);
+    void append_string(std::size_t col, char const * data, std::size_t length);
+    void end_row();
+
+private:
+    struct column
+    {
+        column_properties props_;
+
+        std::vector<unsigned char> validity_;
+
+        // Only one of these is used, depending on the data type.
+        std::vector<int> ints_;
+        std::vector<long long> longLongs_;
+        std::vector<unsigned long long> unsignedLongLongs_;
+        std::vector<double> doubles_;
+        std::vector<std::tm> dates_;
+
+        // Used for string, blob and XML columns only.
+        std::vector<std::size_t> offsets_;
+        std::vector<char> bytes_;
+    };
+
+    column & get_column_for_append(std::size_t col, data_type type);
+    column const & get_column(std::size_t col, data_type type) const;
+    void set_valid(column & c);
+
+    std::size_t const capacity_;
+    std::size_t size_;
+    bool uppercaseColumnNames_;
+
+    std::vector<column> columns_;
+
+    SOCI_NOT_COPYABLE(column_batch)
+};
+
+template <>
+SOCI_DECL int const * column_batch::get_values<int>(std::size_t col) const;
+template <>
+SOCI_DECL long long const *
+column_batch::get_values<long long>(std::size_t col) const;
+template <>
+SOCI_DECL unsigned long long const *
+column_batch::get_values<unsigned long long>(std::size_t col) const;
+template <>
+SOCI_DECL double const * column_batch::get_values<double>(std::size_t col) const;
+template <>
+SOCI_DECL std::tm const * column_batch::get_values<std::tm>(std::size_t col) const;
+
+} // namespace soci
+
+#endif // SOCI_COLUMN_BATCH_H_INCLUDED
@@ -9,6 +9,7 @@
 #define SOCI_CONNECTION_POOL_H_INCLUDED
 
 #include "soci/soci-platform.h"
+#include "soci/connection-parameters.h"
 // std
 #include <cstddef>
 
@@ -17,10 +18,91 @@ namespace soci
 
 class session;
 
+// Options for the elastic connection pool.
+struct connection_pool_options
+{
+    connection_pool_options()
+        : minSize(0), maxSize(0), idleTimeout(-1), validateOnLease(true)
+    {
+    }
+
+    // Number of sessions opened when creating the pool and kept open even if
+    // they're idle and the maximal number of sessions in the pool.
+    std::size_t minSize;
+    std::size_t maxSize;
+
+    // Time, in milliseconds, after which the sessions not used since then are
+    // closed (if there are more than minSize of them). Negative value means
+    // that the idle sessions are never closed.
+    int idleTimeout;
+
+    // If true, check that the session is still connected when leasing it and
+    // reconnect it in the background if it isn't.
+    bool validateOnLease;
+};
+
+// Statistics about the connection pool usage.
+//
+// All durations are in nanoseconds.
+struct connection_pool_stats
+{
+    connection_pool_stats()
+        : size(0), inUse(0), openSessions(0), waiting(0),
+          leases(0), waits(0), timeouts(0),
+          totalWaitNs(0), maxWaitNs(0),
+          totalLeaseNs(0), maxLeaseNs(0),
+          reconnects(0), evictions(0)
+    {
+    }
+
+    // Total number of sessions in the pool and the number of currently
+    // leased ones.
+    std::size_t size;
+    std::size_t inUse;
+
+    // Number of sessions not closed by the pool itself: this is always the
+    // same as size for the pools with fixed size.
+    std::size_t openSessions;
+
+    // Number of threads currently waiting for a session to become available.
+    std::size_t waiting;
+
+    // Number of successful leases, number of lease attempts which had to
+    // block waiting for a session to be given back (whether they eventually
+    // got it or not) and the number of leases which timed out, including the
+    // calls to try_lease() with zero timeout which found no free session.
+    unsigned long long leases;
+    unsigned long long waits;
+    unsigned long long timeouts;
+
+    // Total and maximal time spent waiting in lease() or try_lease().
+    unsigned long long totalWaitNs;
+    unsigned long long maxWaitNs;
+
+    // Total and maximal time between leasing a session and giving it back.
+    unsigned long long totalLeaseNs;
+    unsigned long long maxLeaseNs;
+
+    // Number of broken sessions reconnected in the background and of the
+    // idle sessions closed by an elastic pool.
+    unsigned long long reconnects;
+    unsigned long long evictions;
+};
+
 class SOCI_DECL connection_pool
 {
 public:
+    // Create a pool of the given fixed size containing sessions which are
+    // not connected yet and must be opened using at().
     explicit connection_pool(std::size_t size);
+
+    // Create an elastic pool which opens the sessions using the provided
+    // parameters itself: options.minSize of them are opened in parallel
+    // immediately and the rest of them only when needed, by a background
+    // thread, while the thread needing a session waits for it.
+    connection_pool(connection_parameters const & parameters,
+        connection_pool_options const & options);
+
     ~connection_pool();
 
     session & at(std::size_t pos);
@@ -29,6 +111,9 @@ public:
     bool try_lease(std::size_t & pos, int timeout);
     void give_back(std::size_t pos);
 
+    // Return the current usage statistics, this function is thread-safe.
+    connection_pool_stats get_stats() const;
+
 private:
     struct connection_pool_impl;
     connection_pool_impl * pimpl_;
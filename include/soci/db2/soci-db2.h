@@ -59,6 +59,13 @@ public:
     db2_soci_error(std::string const & msg, SQLRETURN rc) : soci_error(msg),errorCode(rc) {};
     ~db2_soci_error() SOCI_NOEXCEPT SOCI_OVERRIDE { };
 
+    db2_soci_error * clone() const SOCI_OVERRIDE
+    {
+        return new db2_soci_error(*this);
+    }
+
+    SOCI_NORETURN rethrow() const SOCI_OVERRIDE { throw *this; }
+
     //We have to extract error information before exception throwing, cause CLI handles could be broken at the construction time
     static const std::string sqlState(std::string const & msg,const SQLSMALLINT htype,const SQLHANDLE hndl);
 
@@ -71,12 +78,18 @@ public:
 // (in string form as all options are strings currently).
 extern SOCI_DB2_DECL char const * db2_option_driver_complete;
 
+// Option allowing to specify the number of rows fetched at once by the
+// statements using only scalar into elements. The value must be a positive
+// integer, in string form, and 1 disables fetching the rows in blocks.
+extern SOCI_DB2_DECL char const * db2_option_fetch_block_size;
+
 struct db2_statement_backend;
 
 struct SOCI_DB2_DECL db2_standard_into_type_backend : details::standard_into_type_backend
 {
     db2_standard_into_type_backend(db2_statement_backend &st)
-        : statement_(st),buf(NULL)
+        : statement_(st),buf(NULL),bindData(NULL),bindSize(0),
+          blockValueOffset(0),blockIndOffset(0)
     {}
 
     void define_by_pos(int& position, void* data, details::exchange_type type) SOCI_OVERRIDE;
@@ -86,6 +99,14 @@ struct SOCI_DB2_DECL db2_standard_into_type_backend : details::standard_into_typ
 
     void clean_up() SOCI_OVERRIDE;
 
+    // Bind the column to the given value and length buffers, which are
+    // either bindData and valueLen or the row 0 of the statement block.
+    void bind_column(void* data, SQLLEN* valueLen);
+
+    // Copy the value of this column from the given row of the statement
+    // block to bindData and valueLen, as if it had been fetched directly.
+    void copy_from_block(char const* row);
+
     db2_statement_backend& statement_;
 
     char* buf;
@@ -94,6 +115,12 @@ struct SOCI_DB2_DECL db2_standard_into_type_backend : details::standard_into_typ
     int position;
     SQLSMALLINT cType;
     SQLLEN valueLen;
+    void *bindData; // either data or buf
+    SQLLEN bindSize;
+
+    // offsets of the value and its length in a row of the statement block
+    std::size_t blockValueOffset;
+    std::size_t blockIndOffset;
 };
 
 struct SOCI_DB2_DECL db2_vector_into_type_backend : details::vector_into_type_backend
@@ -190,6 +217,8 @@ struct SOCI_DB2_DECL db2_statement_backend : details::statement_backend
     exec_fetch_result execute(int number) SOCI_OVERRIDE;
     exec_fetch_result fetch(int number) SOCI_OVERRIDE;
 
+    bool cancel() SOCI_OVERRIDE;
+
     long long get_affected_rows() SOCI_OVERRIDE;
     int get_number_of_rows() SOCI_OVERRIDE;
     std::string get_parameter_name(int index) const SOCI_OVERRIDE;
@@ -211,8 +240,32 @@ struct SOCI_DB2_DECL db2_statement_backend : details::statement_backend
     std::string query_;
     std::vector<std::string> names_;
     bool hasVectorUseElements;
+    bool hasVectorIntoElements;
     SQLUINTEGER numRowsFetched;
     details::db2::binding_method use_binding_method_;
+
+    // The scalar into elements, used for fetching the rows in blocks.
+    std::vector<db2_standard_into_type_backend*> standardIntos;
+
+private:
+    // fetch() helper fetching the given number of rows directly into the
+    // into elements.
+    exec_fetch_result do_fetch_rows(int number);
+
+    // When the statement only has scalar into elements, fetch() uses a block
+    // cursor with row-wise binding: up to fetchBlockSize rows are fetched at
+    // once into blockBuf and the subsequent calls just copy the next row
+    // from it to the into elements.
+    exec_fetch_result fetch_from_block();
+    bool start_block_fetch();
+    void end_block_fetch();
+
+    std::size_t fetchBlockSize;
+    std::vector<char> blockBuf;
+    std::size_t blockRowSize;
+    SQLUINTEGER blockRowsFetched;
+    std::size_t blockPos;
+    bool blockBound;
 };
 
 struct db2_rowid_backend : details::rowid_backend
@@ -266,6 +319,10 @@ struct db2_session_backend : details::session_backend
     bool autocommit;
     bool in_transaction;
 
+    // Number of rows fetched at once by the statements using only scalar
+    // into elements, see db2_option_fetch_block_size.
+    std::size_t fetchBlockSize;
+
     SQLHANDLE hEnv; /* Environment handle */
     SQLHANDLE hDbc; /* Connection handle */
 };
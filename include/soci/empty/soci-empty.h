@@ -102,6 +102,7 @@ struct SOCI_EMPTY_DECL empty_statement_backend : details::statement_backend
 
     void alloc() SOCI_OVERRIDE;
     void clean_up() SOCI_OVERRIDE;
+    bool reset_for_reuse() SOCI_OVERRIDE;
     void prepare(std::string const& query, details::statement_type eType) SOCI_OVERRIDE;
 
     exec_fetch_result execute(int number) SOCI_OVERRIDE;
@@ -10,6 +10,7 @@
 #define SOCI_ERROR_H_INCLUDED
 
 #include "soci/soci-platform.h"
+#include "soci/noreturn.h"
 // std
 #include <stdexcept>
 #include <string>
@@ -50,17 +51,47 @@ public:
         constraint_violation,
         unknown_transaction_state,
         system_error,
-        unknown
+        unknown,
+
+        // Added after "unknown" to preserve the values of the existing ones.
+        query_timeout
     };
 
     // Basic error classification support
     virtual error_category get_error_category() const { return unknown; }
 
+    // Return a heap-allocated copy of this exception and throw a copy of it,
+    // preserving its dynamic type in both cases. This is used for propagating
+    // the exceptions to another thread, so all the derived classes must
+    // override both of these functions.
+    virtual soci_error* clone() const;
+    virtual SOCI_NORETURN rethrow() const;
+
 private:
     // Optional extra information (currently just the context data).
     class soci_error_extra_info* info_;
 };
 
+// Exception thrown when an operation is cancelled because it didn't complete
+// before its deadline, see session::set_query_timeout().
+class SOCI_DECL query_timeout_error : public soci_error
+{
+public:
+    explicit query_timeout_error(std::string const & msg) : soci_error(msg) {}
+
+    error_category get_error_category() const SOCI_OVERRIDE
+    {
+        return query_timeout;
+    }
+
+    query_timeout_error* clone() const SOCI_OVERRIDE
+    {
+        return new query_timeout_error(*this);
+    }
+
+    SOCI_NORETURN rethrow() const SOCI_OVERRIDE { throw *this; }
+};
+
 } // namespace soci
 
 #endif // SOCI_ERROR_H_INCLUDED
@@ -43,6 +43,13 @@ public:
 
     ~firebird_soci_error() SOCI_NOEXCEPT SOCI_OVERRIDE {};
 
+    firebird_soci_error * clone() const SOCI_OVERRIDE
+    {
+        return new firebird_soci_error(*this);
+    }
+
+    SOCI_NORETURN rethrow() const SOCI_OVERRIDE { throw *this; }
+
     std::vector<ISC_STATUS> status_;
 };
 
@@ -229,7 +236,15 @@ protected:
 
     long long rowsAffectedBulk_; // number of rows affected by the last bulk operation
 
+    // set if the server or the client library doesn't support batches
+    bool batchUnavailable_;
+
     virtual void exchangeData(bool gotData, int row);
+
+    // Execute the statement for all rows of the vector use elements using
+    // Firebird 4 batch interface. Returns false if it can't be used, in
+    // which case the statement must be executed once per row.
+    bool executeBatch();
     virtual void prepareSQLDA(XSQLDA ** sqldap, short size = 10);
     virtual void rewriteQuery(std::string const & query,
         std::vector<char> & buffer);
@@ -10,7 +10,9 @@
 
 #include "soci/soci-platform.h"
 
+#include <cstddef>
 #include <ostream>
+#include <string>
 
 namespace soci
 {
@@ -30,6 +32,34 @@ public:
     // Called to indicate that a new query is about to be executed.
     virtual void start_query(std::string const & query) = 0;
 
+    // Override this method to return true to have the methods below called.
+    //
+    // Loggers not doing this don't incur any overhead, not even for measuring
+    // the time taken by the statement operations.
+    virtual bool wants_query_metrics() const { return false; }
+
+    // Called after preparing the query, with the time taken by the backend to
+    // do it. Notice that this is not called for the queries reused from the
+    // session statement cache, as they're not prepared again.
+    virtual void query_prepared(std::string const & /* query */,
+        long long /* durationNs */) {}
+
+    // Called after executing the query, with the time taken by it and the
+    // number of rows fetched into the into elements by this execution, if any.
+    virtual void query_executed(std::string const & /* query */,
+        long long /* durationNs */, std::size_t /* rows */) {}
+
+    // Called after fetching the next row(s) of the result set from the
+    // database, with the time it took and the number of rows fetched (0 when
+    // the end of the result set is hit).
+    virtual void rows_fetched(std::string const & /* query */,
+        long long /* durationNs */, std::size_t /* rows */) {}
+
+    // Called when the statement is destroyed or prepared again, with the total
+    // duration of all the operations above and the total number of rows.
+    virtual void query_finished(std::string const & /* query */,
+        long long /* totalDurationNs */, std::size_t /* totalRows */) {}
+
     logger_impl * clone() const;
 
     // These methods are for compatibility only as they're used to implement
@@ -68,6 +98,23 @@ public:
 
     void start_query(std::string const & query) { m_impl->start_query(query); }
 
+    // Methods used for collecting statement metrics, only called if
+    // wants_query_metrics() returns true (this is checked only once when the
+    // logger is created, so it must always return the same value).
+    bool wants_query_metrics() const { return m_wantsMetrics; }
+
+    void query_prepared(std::string const & query, long long durationNs) const
+        { m_impl->query_prepared(query, durationNs); }
+    void query_executed(std::string const & query, long long durationNs,
+        std::size_t rows) const
+        { m_impl->query_executed(query, durationNs, rows); }
+    void rows_fetched(std::string const & query, long long durationNs,
+        std::size_t rows) const
+        { m_impl->rows_fetched(query, durationNs, rows); }
+    void query_finished(std::string const & query, long long totalDurationNs,
+        std::size_t totalRows) const
+        { m_impl->query_finished(query, totalDurationNs, totalRows); }
+
     // Methods used for the implementation of session basic logging support.
     void set_stream(std::ostream * s) { m_impl->set_stream(s); }
     std::ostream * get_stream() const { return m_impl->get_stream(); }
@@ -75,6 +122,7 @@ public:
 
 private:
     logger_impl * m_impl;
+    bool m_wantsMetrics;
 };
 
 } // namespace soci
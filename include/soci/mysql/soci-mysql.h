@@ -23,6 +23,8 @@
 #endif // _WIN32
 #include <mysql.h> // MySQL Client
 #include <errmsg.h> // MySQL Error codes
+#include <map>
+#include <string>
 #include <vector>
 
 
@@ -45,10 +47,69 @@ public:
 
     error_category get_error_category() const SOCI_OVERRIDE { return cat_; }
 
+    mysql_soci_error * clone() const SOCI_OVERRIDE
+    {
+        return new mysql_soci_error(*this);
+    }
+
+    SOCI_NORETURN rethrow() const SOCI_OVERRIDE { throw *this; }
+
     unsigned int err_num_;
     error_category cat_;
 };
 
+namespace details
+{
+
+namespace mysql
+{
+
+// Type of the boolean fields of MYSQL_BIND, my_bool was replaced with bool in
+// MySQL 8.0, but is still used by MariaDB.
+#if defined(MARIADB_BASE_VERSION) || defined(MARIADB_VERSION_ID) || \
+    MYSQL_VERSION_ID < 80001
+typedef my_bool bool_type;
+#else
+typedef bool bool_type;
+#endif
+
+} // namespace mysql
+
+} // namespace details
+
+// Buffer for a single column of the result of a prepared statement.
+struct mysql_result_column
+{
+    // The type used for the buffer: MYSQL_TYPE_LONGLONG, MYSQL_TYPE_DOUBLE,
+    // MYSQL_TYPE_DATETIME or MYSQL_TYPE_STRING for all the other columns,
+    // which are then handled in exactly the same way as without prepared
+    // statements.
+    enum_field_types bufferType_;
+
+    // The type of the column itself.
+    enum_field_types fieldType_;
+    unsigned int decimals_;
+    bool unsigned_;
+
+    // Strings are always NUL-terminated in this buffer.
+    std::vector<char> buffer_;
+    unsigned long length_;
+    details::mysql::bool_type isNull_;
+};
+
+// Value of a column of a row of the result of a prepared statement: either in
+// the column buffer itself or in the buffer holding the values of the batch of
+// rows read at once.
+struct mysql_column_value
+{
+    mysql_result_column const *column_;
+
+    // NULL for null values, otherwise the value in the same format as in the
+    // column buffer, including the trailing NUL for strings.
+    char const *data_;
+    unsigned long length_;
+};
+
 struct mysql_statement_backend;
 struct mysql_standard_into_type_backend : details::standard_into_type_backend
 {
@@ -116,6 +177,10 @@ struct mysql_standard_use_type_backend : details::standard_use_type_backend
     int position_;
     std::string name_;
     char *buf_;
+
+    // used instead of buf_ with prepared statements
+    MYSQL_BIND bind_;
+    MYSQL_TIME time_;
 };
 
 struct mysql_vector_use_type_backend : details::vector_use_type_backend
@@ -141,15 +206,21 @@ struct mysql_vector_use_type_backend : details::vector_use_type_backend
     int position_;
     std::string name_;
     std::vector<char *> buffers_;
+
+    // used instead of buffers_ with prepared statements
+    std::vector<MYSQL_BIND> binds_;
+    std::vector<MYSQL_TIME> times_;
 };
 
 struct mysql_session_backend;
 struct mysql_statement_backend : details::statement_backend
 {
     mysql_statement_backend(mysql_session_backend &session);
+    ~mysql_statement_backend() SOCI_OVERRIDE;
 
     void alloc() SOCI_OVERRIDE;
     void clean_up() SOCI_OVERRIDE;
+    bool reset_for_reuse() SOCI_OVERRIDE;
     void prepare(std::string const &query,
         details::statement_type eType) SOCI_OVERRIDE;
 
@@ -160,6 +231,11 @@ struct mysql_statement_backend : details::statement_backend
     int get_number_of_rows() SOCI_OVERRIDE;
     std::string get_parameter_name(int index) const SOCI_OVERRIDE;
 
+    details::query_placeholders const * get_placeholders() const SOCI_OVERRIDE
+    {
+        return &placeholders_;
+    }
+
     std::string rewrite_for_procedure_call(std::string const &query) SOCI_OVERRIDE;
 
     int prepare_for_describe() SOCI_OVERRIDE;
@@ -171,16 +247,54 @@ struct mysql_statement_backend : details::statement_backend
     mysql_vector_into_type_backend * make_vector_into_type_backend() SOCI_OVERRIDE;
     mysql_vector_use_type_backend * make_vector_use_type_backend() SOCI_OVERRIDE;
 
+    // Execute the prepared statement the given number of times, return false
+    // if it was a bulk operation, which never has any results.
+    bool execute_prepared(int numberOfExecutions);
+
+    // Return the value of the given column of the given row, which must be
+    // one of the rows fetched by the last call to fetch(), or NULL if the
+    // value is null.
+    char const *get_text_value(int row, int pos, unsigned long &length);
+
+    // The same for the prepared statements.
+    mysql_column_value get_prepared_column(int row, int pos);
+
+    // Read up to the given number of the next rows of the result, walking
+    // over them only once and remembering the values of all their columns for
+    // the into elements. Returns the number of rows actually read.
+    int read_rows(int number);
+
+    // Fetch the next row of the result of the prepared statement into
+    // resultColumns_, return false if there are no more rows.
+    bool fetch_next_prepared_row();
+
+    // Append a copy of the value of the given size, or a NULL one, to the
+    // values of the current batch. Once all the values have been added,
+    // point_to_batch_data() must be called to make batchValues_ point to the
+    // copies, as batchData_ can be reallocated until then.
+    void copy_batch_value(char const *value, std::size_t size,
+        unsigned long length);
+    void point_to_batch_data();
+
+    // Implementation of fetch() when using mysql_use_result().
+    exec_fetch_result fetch_streamed(int number);
+
     mysql_session_backend &session_;
 
+    // For the statements executed using the text protocol, this is the
+    // result itself. For the prepared statements it only contains the
+    // metadata and the data is retrieved from stmt_.
     MYSQL_RES *result_;
 
+    // Server-side prepared statement, only used for the repeatable queries if
+    // enabled for the session, and NULL otherwise.
+    MYSQL_STMT *stmt_;
+
     // The query is split into chunks, separated by the named parameters;
     // e.g. for "SELECT id FROM ttt WHERE name = :foo AND gender = :bar"
     // we will have query chunks "SELECT id FROM ttt WHERE name = ",
     // "AND gender = " and names "foo", "bar".
-    std::vector<std::string> queryChunks_;
-    std::vector<std::string> names_; // list of names for named binds
+    details::query_placeholders placeholders_; // names for named binds
 
     long long rowsAffectedBulk_; // number of rows affected by the last bulk operation
 
@@ -191,10 +305,6 @@ struct mysql_statement_backend : details::statement_backend
     bool justDescribed_; // to optimize row description with immediately
                          // following actual statement execution
 
-    // Prefetch the row offsets in order to use mysql_row_seek() for
-    // random access to rows, since mysql_data_seek() is expensive.
-    std::vector<MYSQL_ROW_OFFSET> resultRowOffsets_;
-
     bool hasIntoElements_;
     bool hasVectorIntoElements_;
     bool hasUseElements_;
@@ -208,6 +318,40 @@ struct mysql_statement_backend : details::statement_backend
 
     typedef std::map<std::string, char **> UseByNameBuffersMap;
     UseByNameBuffersMap useByNameBuffers_;
+
+    // the same for the prepared statements, which use MYSQL_BIND structs
+    // instead of the text buffers
+
+    typedef std::map<int, MYSQL_BIND *> UseByPosBindsMap;
+    UseByPosBindsMap useByPosBinds_;
+
+    typedef std::map<std::string, MYSQL_BIND *> UseByNameBindsMap;
+    UseByNameBindsMap useByNameBinds_;
+
+    std::vector<MYSQL_BIND> paramBinds_;
+
+    std::vector<MYSQL_BIND> resultBinds_;
+    std::vector<mysql_result_column> resultColumns_;
+
+    // If true, the rows are retrieved from the server only when fetching them
+    // instead of being all stored in memory when executing the statement.
+    bool useResult_;
+
+    // true if all the rows of the streamed result have been already fetched
+    bool endOfResult_;
+
+    // The values of all columns of the rows read by the last fetch(), in
+    // row-major order, with NULL pointers for null values.
+    std::vector<char const *> batchValues_;
+    std::vector<unsigned long> batchLengths_;
+
+    // When streaming, the rows are only valid until the next one is fetched,
+    // so their values are copied here and batchValues_ point into it. This is
+    // also used for the prepared statements when reading more than one row
+    // at once, as otherwise the values of the only row are in resultColumns_.
+    std::vector<char> batchData_;
+    std::vector<std::size_t> batchOffsets_;
+    int batchSize_;
 };
 
 struct mysql_rowid_backend : details::rowid_backend
@@ -266,6 +410,16 @@ struct mysql_session_backend : details::session_backend
     }
 
     MYSQL *conn_;
+
+    // Use server-side prepared statements for the repeatable queries.
+    bool usePreparedStatements_;
+
+    // Retrieve the rows of the statements results from the server when they
+    // are fetched, which allows to iterate over arbitrarily large results
+    // without storing all of them in memory. Notice that no other statements
+    // can be executed using the same session until all the rows are fetched
+    // or the statement is destroyed when this option is on.
+    bool useResult_;
 };
 
 
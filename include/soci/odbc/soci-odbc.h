@@ -51,6 +51,11 @@ namespace details
 // string form as all options are strings currently).
 extern SOCI_ODBC_DECL char const * odbc_option_driver_complete;
 
+// Option allowing to specify the number of rows fetched at once by the
+// statements using only scalar into elements. The value must be a positive
+// integer, in string form, and 1 disables fetching the rows in blocks.
+extern SOCI_ODBC_DECL char const * odbc_option_fetch_block_size;
+
 struct odbc_statement_backend;
 
 // Helper of into and use backends.
@@ -88,7 +93,8 @@ struct odbc_standard_into_type_backend : details::standard_into_type_backend,
                                          private odbc_standard_type_backend_base
 {
     odbc_standard_into_type_backend(odbc_statement_backend &st)
-        : odbc_standard_type_backend_base(st), buf_(0)
+        : odbc_standard_type_backend_base(st), buf_(0), bindData_(0),
+          bindSize_(0), blockValueOffset_(0), blockIndOffset_(0)
     {}
 
     void define_by_pos(int &position,
@@ -100,12 +106,26 @@ struct odbc_standard_into_type_backend : details::standard_into_type_backend,
 
     void clean_up() SOCI_OVERRIDE;
 
+    // Bind the column to the given value and length buffers, which are
+    // either bindData_ and valueLen_ or the row 0 of the statement block.
+    void bind_column(void *data, SQLLEN *valueLen);
+
+    // Copy the value of this column from the given row of the statement
+    // block to bindData_ and valueLen_, as if it had been fetched directly.
+    void copy_from_block(char const *row);
+
     char *buf_;        // generic buffer
     void *data_;
     details::exchange_type type_;
     int position_;
     SQLSMALLINT odbcType_;
     SQLLEN valueLen_;
+    void *bindData_;   // either data_ or buf_
+    SQLLEN bindSize_;
+
+    // offsets of the value and its length in a row of the statement block
+    std::size_t blockValueOffset_;
+    std::size_t blockIndOffset_;
 private:
     SOCI_NOT_COPYABLE(odbc_standard_into_type_backend)
 };
@@ -244,6 +264,8 @@ struct odbc_statement_backend : details::statement_backend
     exec_fetch_result execute(int number) SOCI_OVERRIDE;
     exec_fetch_result fetch(int number) SOCI_OVERRIDE;
 
+    bool cancel() SOCI_OVERRIDE;
+
     long long get_affected_rows() SOCI_OVERRIDE;
     int get_number_of_rows() SOCI_OVERRIDE;
     std::string get_parameter_name(int index) const SOCI_OVERRIDE;
@@ -279,9 +301,32 @@ struct odbc_statement_backend : details::statement_backend
     // we're not using any vector "intos".
     std::vector<odbc_vector_into_type_backend*> intos_;
 
+    // Same as above, but for the scalar "intos".
+    std::vector<odbc_standard_into_type_backend*> standardIntos_;
+
 private:
     // fetch() helper wrapping SQLFetch() call for the given range of rows.
     exec_fetch_result do_fetch(int beginRow, int endRow);
+
+    // fetch() helper fetching the given number of rows directly into the
+    // into elements.
+    exec_fetch_result do_fetch_rows(int number);
+
+    // When the statement only has scalar into elements, fetch() uses a block
+    // cursor with row-wise binding: up to fetchBlockSize_ rows are fetched at
+    // once into blockBuf_ and the subsequent calls just copy the next row
+    // from it to the into elements.
+    bool can_fetch_in_blocks() const;
+    exec_fetch_result fetch_from_block();
+    bool start_block_fetch();
+    void end_block_fetch();
+
+    std::size_t fetchBlockSize_;
+    std::vector<char> blockBuf_;
+    std::size_t blockRowSize_;
+    SQLULEN blockRowsFetched_;
+    std::size_t blockPos_;
+    bool blockBound_;
 };
 
 struct odbc_rowid_backend : details::rowid_backend
@@ -362,6 +407,10 @@ struct odbc_session_backend : details::session_backend
 
     std::string connection_string_;
 
+    // Number of rows fetched at once by the statements using only scalar
+    // into elements, see odbc_option_fetch_block_size.
+    std::size_t fetchBlockSize_;
+
 private:
     mutable database_product product_;
 };
@@ -411,6 +460,11 @@ public:
     {
         return message_;
     }
+    odbc_soci_error * clone() const SOCI_OVERRIDE
+    {
+        return new odbc_soci_error(*this);
+    }
+    SOCI_NORETURN rethrow() const SOCI_OVERRIDE { throw *this; }
 private:
     std::string interpret_odbc_error(SQLSMALLINT htype, SQLHANDLE hndl, std::string const& msg)
     {
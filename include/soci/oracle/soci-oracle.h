@@ -36,6 +36,13 @@ public:
 
     error_category get_error_category() const SOCI_OVERRIDE { return cat_; }
 
+    oracle_soci_error * clone() const SOCI_OVERRIDE
+    {
+        return new oracle_soci_error(*this);
+    }
+
+    SOCI_NORETURN rethrow() const SOCI_OVERRIDE { throw *this; }
+
     int err_num_;
     error_category cat_;
 };
@@ -222,6 +229,8 @@ struct oracle_statement_backend : details::statement_backend
     exec_fetch_result execute(int number) SOCI_OVERRIDE;
     exec_fetch_result fetch(int number) SOCI_OVERRIDE;
 
+    bool cancel() SOCI_OVERRIDE;
+
     long long get_affected_rows() SOCI_OVERRIDE;
     int get_number_of_rows() SOCI_OVERRIDE;
     std::string get_parameter_name(int index) const SOCI_OVERRIDE;
@@ -244,9 +253,17 @@ struct oracle_statement_backend : details::statement_backend
 
     OCIStmt *stmtp_;
 
+    // True if stmtp_ was obtained from the OCI statement cache and must be
+    // released to it instead of being freed.
+    bool stmtFromCache_;
+
     bool boundByName_;
     bool boundByPos_;
     bool noData_;
+
+    // True if the statement was already executed by prepare_for_describe()
+    // and the next call to execute() only needs to fetch the rows.
+    bool executedForDescribe_;
 };
 
 struct oracle_rowid_backend : details::rowid_backend
@@ -301,7 +318,10 @@ struct oracle_session_backend : details::session_backend
         int mode,
         bool decimals_as_strings = false,
         int charset = 0,
-        int ncharset = 0);
+        int ncharset = 0,
+        ub4 prefetch_rows = 0,
+        ub4 prefetch_memory = 0,
+        ub4 stmt_cache_size = 0);
 
     ~oracle_session_backend() SOCI_OVERRIDE;
 
@@ -446,9 +466,18 @@ struct oracle_session_backend : details::session_backend
     OCIEnv *envhp_;
     OCIServer *srvhp_;
     OCIError *errhp_;
+    OCIError *breakErrhp_; // only used by OCIBreak() from another thread
     OCISvcCtx *svchp_;
     OCISession *usrhp_;
     bool decimals_as_strings_;
+
+    // Number of rows and amount of memory to prefetch for each statement, 0
+    // if the OCI defaults are used.
+    ub4 prefetchRows_;
+    ub4 prefetchMemory_;
+
+    // Size of the OCI statement cache, if 0 it is not used.
+    ub4 stmtCacheSize_;
 };
 
 struct oracle_backend_factory : backend_factory
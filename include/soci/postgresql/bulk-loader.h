@@ -0,0 +1,70 @@
+//
+// Copyright (C) 2004-2008 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_POSTGRESQL_BULK_LOADER_H_INCLUDED
+#define SOCI_POSTGRESQL_BULK_LOADER_H_INCLUDED
+
+#include "soci/postgresql/soci-postgresql.h"
+#include "soci/statement.h"
+#include "soci/use-type.h"
+#include <string>
+
+namespace soci
+{
+
+class session;
+
+// Loads rows into a table using "COPY ... FROM STDIN", which is much faster
+// than executing INSERT statements, even in bulk.
+//
+// The data to load is bound using exchange() exactly as for a statement, so
+// any type supported by use(), including the types with type_conversion<>
+// specializations and vectors, can be used. Each call to load() then queues
+// the rows currently in the bound data and finish() sends the remaining ones
+// to the server and returns their total number.
+class SOCI_POSTGRESQL_DECL bulk_loader
+{
+public:
+    // The columns are given as a comma-separated list and can be omitted to
+    // load all the table columns. Use elements bound by name must be named
+    // after the columns, without quotes for the quoted identifiers, and a
+    // use element must be bound for each of the columns in this case.
+    bulk_loader(session & sql, std::string const & table,
+        std::string const & columns = std::string());
+
+    // Aborts loading, without loading any rows, if finish() wasn't called.
+    ~bulk_loader();
+
+    void exchange(details::use_type_ptr const & u) { st_.exchange(u); }
+    template <typename T, typename Indicator>
+    void exchange(details::use_container<T, Indicator> const & uc)
+    {
+        st_.exchange(uc);
+    }
+
+    // Queue the current values of the bound data for loading.
+    void load();
+
+    // Load all the queued rows and return their number. Errors in the data
+    // are only detected by the server and reported at this moment, in which
+    // case none of the rows is loaded.
+    long long finish();
+
+private:
+    postgresql_statement_backend & get_backend();
+
+    statement st_;
+    std::string query_;
+    bool prepared_;
+    bool started_;
+
+    SOCI_NOT_COPYABLE(bulk_loader)
+};
+
+} // namespace soci
+
+#endif // SOCI_POSTGRESQL_BULK_LOADER_H_INCLUDED
@@ -34,6 +34,13 @@ public:
 
     error_category get_error_category() const SOCI_OVERRIDE { return cat_; }
 
+    postgresql_soci_error * clone() const SOCI_OVERRIDE
+    {
+        return new postgresql_soci_error(*this);
+    }
+
+    SOCI_NORETURN rethrow() const SOCI_OVERRIDE { throw *this; }
+
 private:
     char sqlstate_[ 5 ];   // not std::string to keep copy-constructor no-throw
     error_category cat_;
@@ -179,7 +186,8 @@ struct postgresql_vector_into_type_backend : details::vector_into_type_backend
 struct postgresql_standard_use_type_backend : details::standard_use_type_backend
 {
     postgresql_standard_use_type_backend(postgresql_statement_backend & st)
-        : statement_(st), position_(0), buf_(NULL) {}
+        : statement_(st), position_(0), buf_(NULL),
+          binaryBuf_(NULL), binaryLength_(0) {}
 
     void bind_by_pos(int & position,
         void * data, details::exchange_type type, bool readOnly) SOCI_OVERRIDE;
@@ -199,9 +207,19 @@ struct postgresql_standard_use_type_backend : details::standard_use_type_backend
     std::string name_;
     char * buf_;
 
+    // Used instead of buf_ when the value is sent in binary format: points
+    // either to binaryValue_ or directly to the user-provided data.
+    char * binaryBuf_;
+    int binaryLength_;
+    char binaryValue_[8];
+
 private:
     // Allocate buf_ of appropriate size and copy string data into it.
     void copy_from_string(std::string const& s);
+
+    // Try to fill binaryBuf_ with the value in binary format, return false if
+    // it must be sent in the text format.
+    bool prepare_binary();
 };
 
 struct postgresql_vector_use_type_backend : details::vector_use_type_backend
@@ -246,6 +264,21 @@ struct postgresql_vector_use_type_backend : details::vector_use_type_backend
     int position_;
     std::string name_;
     std::vector<char *> buffers_;
+
+    // Used instead of buffers_ when the values are sent in binary format:
+    // the pointers are either into binaryData_ or to the user-provided data.
+    std::vector<char *> binaryBuffers_;
+    std::vector<int> binaryLengths_;
+    std::vector<char> binaryData_;
+
+private:
+    // Try to fill binaryBuffers_ with all the values in binary format, return
+    // false if they must be sent in the text format.
+    bool prepare_binary(indicator const * ind, std::size_t vend);
+
+    // Make the buffers, and their lengths if binary format is used, known
+    // to the statement.
+    void register_buffers(char ** buffers, int * binaryLengths);
 };
 
 struct postgresql_statement_backend : details::statement_backend
@@ -256,16 +289,35 @@ struct postgresql_statement_backend : details::statement_backend
 
     void alloc() SOCI_OVERRIDE;
     void clean_up() SOCI_OVERRIDE;
+    bool reset_for_reuse() SOCI_OVERRIDE;
     void prepare(std::string const & query,
         details::statement_type stType) SOCI_OVERRIDE;
 
     exec_fetch_result execute(int number) SOCI_OVERRIDE;
     exec_fetch_result fetch(int number) SOCI_OVERRIDE;
 
+    bool execute_async(int number) SOCI_OVERRIDE;
+    bool is_async_ready() SOCI_OVERRIDE;
+    exec_fetch_result finish_execute_async(int number) SOCI_OVERRIDE;
+    int get_native_socket() SOCI_OVERRIDE;
+
+    bool cancel() SOCI_OVERRIDE;
+
     long long get_affected_rows() SOCI_OVERRIDE;
     int get_number_of_rows() SOCI_OVERRIDE;
     std::string get_parameter_name(int index) const SOCI_OVERRIDE;
 
+    details::query_placeholders const * get_placeholders() const SOCI_OVERRIDE
+    {
+        return &placeholders_;
+    }
+
+    bool set_column_batch(column_batch * batch) SOCI_OVERRIDE
+    {
+        columnBatch_ = batch;
+        return true;
+    }
+
     std::string rewrite_for_procedure_call(std::string const & query) SOCI_OVERRIDE;
 
     int prepare_for_describe() SOCI_OVERRIDE;
@@ -277,6 +329,60 @@ struct postgresql_statement_backend : details::statement_backend
     postgresql_vector_into_type_backend * make_vector_into_type_backend() SOCI_OVERRIDE;
     postgresql_vector_use_type_backend * make_vector_use_type_backend() SOCI_OVERRIDE;
 
+    // Fill paramValues, paramLengths and paramFormats with the use buffers
+    // for the given row of a (possibly bulk) execution.
+    void get_param_values(int row, std::vector<char *> & paramValues,
+        std::vector<int> & paramLengths, std::vector<int> & paramFormats);
+
+    // Return the type of the parameter to which the use element with the
+    // given position or name is bound if it's known and can be used for
+    // sending the value in binary format, or 0 otherwise.
+    Oid get_binary_param_type(int position, std::string const & name) const;
+
+    // Called by into elements when they are defined: switches to text format
+    // for the results if the column at the given position can't be converted
+    // from binary format to the given type in the same way as from text.
+    void check_binary_result_column(int position, details::exchange_type type);
+    bool can_use_binary_results() const;
+
+    // Check result_ filled by execute() or finish_execute_async() and fetch
+    // the first rows from it, if necessary.
+    exec_fetch_result process_execute_result(int number);
+
+    // Send all the rows of a bulk use execution at once using libpq pipeline
+    // mode and collect their results afterwards.
+    void execute_pipelined(int numberOfExecutions);
+
+    // Used for "COPY ... FROM STDIN" statements: execute() doesn't run the
+    // statement for each row but queues the rows to be sent to the server,
+    // until end_copy() is called, which returns the number of copied rows.
+    // abort_copy() cancels the operation, discarding all the rows.
+    void execute_copy_in(int number);
+    long long end_copy();
+    void abort_copy();
+
+    // COPY statement has no placeholders, so the names of the use elements
+    // bound by name, which correspond to the copied columns, in order, must
+    // be set using this function before preparing it.
+    void set_copy_use_names(std::vector<std::string> const & names);
+
+    // Used for queries when the session fetch size is set: execute() declares
+    // a cursor for the query and the rows are then retrieved from it in
+    // batches of the fetch size, or of the number of requested rows if it's
+    // greater, instead of loading the entire result at once.
+    void declare_cursor();
+    void fetch_cursor_rows(int number);
+
+    // The cursor may have been already closed by the end of the transaction
+    // in which it was declared, unless knownOpen is true.
+    void close_cursor(bool knownOpen);
+
+    // Prepare for consuming the next rows of the result, this is the
+    // implementation of fetch() for all into elements except column_batch,
+    // which is filled by load_column_batch() with the rows prepared by it.
+    exec_fetch_result fetch_rows(int number);
+    void load_column_batch();
+
     postgresql_session_backend & session_;
 
     bool single_row_mode_;
@@ -285,7 +391,7 @@ struct postgresql_statement_backend : details::statement_backend
     std::string query_;
     details::statement_type stType_;
     std::string statementName_;
-    std::vector<std::string> names_; // list of names for named binds
+    details::query_placeholders placeholders_; // names for named binds
 
     long long rowsAffectedBulk_; // number of rows affected by the last bulk operation
 
@@ -309,6 +415,34 @@ struct postgresql_statement_backend : details::statement_backend
 
     typedef std::map<std::string, char **> UseByNameBuffersMap;
     UseByNameBuffersMap useByNameBuffers_;
+
+    // the lengths of the values of use elements sent in binary format, the
+    // elements not present in these maps use text format
+
+    typedef std::map<int, int *> UseByPosLengthsMap;
+    UseByPosLengthsMap useByPosBinaryLengths_;
+
+    typedef std::map<std::string, int *> UseByNameLengthsMap;
+    UseByNameLengthsMap useByNameBinaryLengths_;
+
+    // only used in binary mode for prepared statements: the types of the
+    // parameters and of the result columns and whether the results can be
+    // retrieved in binary format
+
+    std::vector<Oid> paramTypes_;
+    std::vector<Oid> resultTypes_;
+    bool binaryResults_;
+
+    bool copyIn_;           // is this a "COPY ... FROM STDIN" statement?
+    bool copyInProgress_;   // has the COPY been started?
+    std::string copyData_;  // the rows not sent to the server yet
+    std::vector<std::string> copyUseNames_; // see set_copy_use_names()
+
+    bool cursorQuery_;       // can this query be executed using a cursor?
+    std::string cursorName_; // the name of the open cursor, if any
+    bool cursorHoldable_;    // was it declared WITH HOLD?
+
+    column_batch * columnBatch_; // the batch to fill on fetch, if any
 };
 
 struct postgresql_rowid_backend : details::rowid_backend
@@ -359,7 +493,8 @@ struct postgresql_blob_backend : details::blob_backend
 struct postgresql_session_backend : details::session_backend
 {
     postgresql_session_backend(connection_parameters const & parameters,
-        bool single_row_mode);
+        bool single_row_mode, bool pipeline_mode = false,
+        bool binary_mode = false, int fetch_size = 0);
 
     ~postgresql_session_backend() SOCI_OVERRIDE;
 
@@ -390,6 +525,10 @@ struct postgresql_session_backend : details::session_backend
 
     int statementCount_;
     bool single_row_mode_;
+    bool pipeline_mode_;
+    bool binary_mode_;
+    int fetch_size_; // rows fetched at once using a cursor, 0 if not used
+    bool integerDatetimes_;
     PGconn * conn_;
     connection_parameters connectionParameters_;
 };
@@ -16,6 +16,21 @@
 namespace soci
 {
 
+// Can be used when preparing a query for rowset of one of the basic types to
+// fetch its rows in batches of the given size instead of one at a time, e.g.
+//
+//   rowset<int> rs = (sql.prepare << "select id from t", fetch_size(1000));
+class fetch_size
+{
+public:
+    explicit fetch_size(std::size_t size) : size_(size) {}
+
+    std::size_t get() const { return size_; }
+
+private:
+    std::size_t size_;
+};
+
 namespace details
 {
 
@@ -51,6 +66,8 @@ public:
         return *this;
     }
 
+    prepare_temp_type & operator,(fetch_size const & fs);
+
     ref_counted_prepare_info * get_prepare_info() const { return rcpi_; }
 
 
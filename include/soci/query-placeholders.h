@@ -0,0 +1,79 @@
+//
+// Copyright (C) 2004-2008 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_QUERY_PLACEHOLDERS_H_INCLUDED
+#define SOCI_QUERY_PLACEHOLDERS_H_INCLUDED
+
+#include "soci/soci-platform.h"
+// std
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace soci
+{
+
+namespace details
+{
+
+// Named placeholders of the form ":name" found in a query.
+//
+// The query is tokenized only once and the result is used both by the core,
+// for binding the values by name, and by the backends which need to replace
+// the placeholders with their own syntax. The placeholders inside string
+// literals, quoted identifiers and comments are ignored, as are "::" (used
+// for casts) and ":=" (used for assignments).
+class SOCI_DECL query_placeholders
+{
+public:
+    // Flags modifying the parsing rules.
+    enum
+    {
+        // Backslash escapes the next character inside quotes, as in MySQL.
+        backslash_escapes = 1
+    };
+
+    query_placeholders() {}
+
+    explicit query_placeholders(std::string const & query, int flags = 0)
+    {
+        parse(query, flags);
+    }
+
+    void parse(std::string const & query, int flags = 0);
+
+    // Add a placeholder which doesn't appear in the query text, as if it
+    // followed its end. This is used by the statements which take values
+    // bound by name without having any placeholders, such as PostgreSQL COPY.
+    void add_name(std::string const & name);
+
+    // Names of all placeholders in the order of their appearance in the
+    // query, which may contain the same name more than once.
+    std::vector<std::string> const & names() const { return names_; }
+
+    // Parts of the query before each of the placeholders followed by the
+    // part after the last one, so there is always one more chunk than names.
+    std::vector<std::string> const & chunks() const { return chunks_; }
+
+    // Return the indices in names() of all occurrences of the placeholder
+    // with the given name or NULL if it doesn't appear in the query.
+    std::vector<std::size_t> const * find(std::string const & name) const;
+
+private:
+    std::vector<std::string> names_;
+    std::vector<std::string> chunks_;
+
+    typedef std::map<std::string, std::vector<std::size_t> > positions_map;
+    positions_map positions_;
+};
+
+} // namespace details
+
+} // namespace soci
+
+#endif // SOCI_QUERY_PLACEHOLDERS_H_INCLUDED
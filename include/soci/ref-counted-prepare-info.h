@@ -32,7 +32,7 @@ class ref_counted_prepare_info : public ref_counted_statement_base
 {
 public:
     ref_counted_prepare_info(session& s)
-        : ref_counted_statement_base(s)
+        : ref_counted_statement_base(s), fetchSize_(1)
     {}
 
     void exchange(use_type_ptr const& u) { uses_.exchange(u); }
@@ -49,6 +49,19 @@ public:
 
     void final_action() SOCI_OVERRIDE;
 
+    // number of rows to fetch at once, only used by rowset
+    void set_fetch_size(std::size_t fetchSize) { fetchSize_ = fetchSize; }
+    std::size_t get_fetch_size() const { return fetchSize_; }
+
+    // return the fetch size and reset it, as it's only used by rowset itself
+    // and not by the statement created from this object
+    std::size_t take_fetch_size()
+    {
+        std::size_t const fetchSize = fetchSize_;
+        fetchSize_ = 1;
+        return fetchSize;
+    }
+
 private:
     friend class statement_impl;
     friend class procedure_impl;
@@ -56,6 +69,8 @@ private:
     into_type_vector intos_;
     use_type_vector  uses_;
 
+    std::size_t fetchSize_;
+
     std::string get_query() const;
 };
 
@@ -13,8 +13,8 @@
 #include "soci/type-conversion.h"
 // std
 #include <cstddef>
-#include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace soci
@@ -51,11 +51,22 @@ public:
     indicator get_indicator(std::size_t pos) const;
     indicator get_indicator(std::string const& name) const;
 
+    // Reserve space for the given number of columns: this must be done before
+    // adding them, as the pointers returned by add_holder() must remain valid.
+    void reserve(std::size_t numColumns);
+
+    // Add storage for the value of a new column and return the pointers to it
+    // and its indicator, to be used for binding them.
     template <typename T>
-    inline void add_holder(T* t, indicator* ind)
+    void add_holder(T * & value, indicator * & ind)
     {
-        holders_.push_back(new details::type_holder<T>(t));
-        indicators_.push_back(ind);
+        check_can_add_holder();
+
+        holders_.push_back(details::type_holder());
+        value = details::type_holder_traits<T>::init(holders_.back(), strings_);
+
+        indicators_.push_back(i_ok);
+        ind = &indicators_.back();
     }
 
     column_properties const& get_properties(std::size_t pos) const;
@@ -65,17 +76,19 @@ public:
     T get(std::size_t pos) const
     {
         typedef typename type_conversion<T>::base_type base_type;
-        base_type const& baseVal = holders_.at(pos)->get<base_type>();
+        base_type const& baseVal =
+            details::type_holder_traits<base_type>::get(holders_.at(pos),
+                                                        strings_);
 
         T ret;
-        type_conversion<T>::from_base(baseVal, *indicators_.at(pos), ret);
+        type_conversion<T>::from_base(baseVal, indicators_.at(pos), ret);
         return ret;
     }
 
     template <typename T>
     T get(std::size_t pos, T const &nullValue) const
     {
-        if (i_null == *indicators_.at(pos))
+        if (i_null == indicators_.at(pos))
         {
             return nullValue;
         }
@@ -95,7 +108,7 @@ public:
     {
         std::size_t const pos = find_column(name);
 
-        if (i_null == *indicators_[pos])
+        if (i_null == indicators_[pos])
         {
             return nullValue;
         }
@@ -125,11 +138,21 @@ private:
     SOCI_NOT_COPYABLE(row)
 
     std::size_t find_column(std::string const& name) const;
+    void check_can_add_holder() const;
 
     std::vector<column_properties> columns_;
-    std::vector<details::holder*> holders_;
-    std::vector<indicator*> indicators_;
-    std::map<std::string, std::size_t> index_;
+
+    // Values of all columns and their indicators, the strings values are
+    // stored separately in strings_ and indexed by holders_ elements.
+    std::vector<details::type_holder> holders_;
+    details::type_holder_strings strings_;
+    std::vector<indicator> indicators_;
+
+    // Column names with their positions sorted by name: this is only done
+    // when looking up a column by name for the first time.
+    typedef std::vector<std::pair<std::string, std::size_t> > name_index;
+    mutable name_index index_;
+    mutable bool indexSorted_;
 
     bool uppercaseColumnNames_;
     mutable std::size_t currentPos_;
@@ -10,9 +10,13 @@
 
 #include "soci/soci-platform.h"
 #include "soci/statement.h"
+#include "soci/into.h"
 // std
+#include <ctime>
 #include <iterator>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace soci
 {
@@ -36,16 +40,25 @@ public:
     // Constructors
 
     rowset_iterator()
-        : st_(0), define_(0)
+        : st_(0), define_(0), buffer_(0), pos_(0)
     {}
 
     rowset_iterator(statement & st, T & define)
-        : st_(&st), define_(&define)
+        : st_(&st), define_(&define), buffer_(0), pos_(0)
     {
         // Fetch first row to properly initialize iterator
         ++(*this);
     }
 
+    // This ctor is used when the rows are fetched into the given vector in
+    // batches of its size, which is then walked over by the iterator.
+    rowset_iterator(statement & st, std::vector<T> & buffer)
+        : st_(&st), define_(0), buffer_(&buffer), pos_(buffer.size())
+    {
+        // Fetch first batch of rows to properly initialize iterator
+        ++(*this);
+    }
+
     // Access operators
 
     reference operator*() const
@@ -62,13 +75,26 @@ public:
 
     rowset_iterator & operator++()
     {
-        // Fetch next row from dataset
+        if (buffer_ != 0 && ++pos_ < buffer_->size())
+        {
+            // Move to the next row of the already fetched batch
+            define_ = &(*buffer_)[pos_];
+            return (*this);
+        }
+
+        // Fetch next row, or next batch of rows, from dataset
 
         if (st_->fetch() == false)
         {
             // Set iterator to non-derefencable state (pass-the-end)
             st_ = 0;
             define_ = 0;
+            buffer_ = 0;
+        }
+        else if (buffer_ != 0)
+        {
+            pos_ = 0;
+            define_ = &(*buffer_)[pos_];
         }
 
         return (*this);
@@ -98,11 +124,110 @@ private:
     statement * st_;
     T * define_;
 
+    // only used when fetching in batches: the current batch and the position
+    // of the current row in it
+    std::vector<T> * buffer_;
+    std::size_t pos_;
+
 }; // class rowset_iterator
 
 namespace details
 {
 
+// Rows can only be fetched in batches for the basic types which can be used
+// with vector into elements, but not for row or user-defined types.
+template <typename T>
+struct rowset_can_fetch_in_batches
+{
+    enum { value = false };
+};
+
+template <>
+struct rowset_can_fetch_in_batches<char>
+{
+    enum { value = true };
+};
+
+template <>
+struct rowset_can_fetch_in_batches<std::string>
+{
+    enum { value = true };
+};
+
+template <>
+struct rowset_can_fetch_in_batches<short>
+{
+    enum { value = true };
+};
+
+template <>
+struct rowset_can_fetch_in_batches<int>
+{
+    enum { value = true };
+};
+
+template <>
+struct rowset_can_fetch_in_batches<long long>
+{
+    enum { value = true };
+};
+
+template <>
+struct rowset_can_fetch_in_batches<unsigned long long>
+{
+    enum { value = true };
+};
+
+template <>
+struct rowset_can_fetch_in_batches<double>
+{
+    enum { value = true };
+};
+
+template <>
+struct rowset_can_fetch_in_batches<std::tm>
+{
+    enum { value = true };
+};
+
+// Bind the statement results either to the single define object or, if
+// possible and requested, to a vector of the given size which is returned.
+template <typename T, bool CanFetchInBatches =
+    rowset_can_fetch_in_batches<T>::value != 0>
+struct rowset_exchange
+{
+    static std::vector<T> * exchange(statement & st, T & define,
+        std::size_t fetchSize)
+    {
+        if (fetchSize <= 1)
+        {
+            st.exchange_for_rowset(into(define));
+            return NULL;
+        }
+
+        cxx_details::auto_ptr<std::vector<T> > buffer(new std::vector<T>(fetchSize));
+        st.exchange_for_rowset(into(*buffer));
+        return buffer.release();
+    }
+};
+
+template <typename T>
+struct rowset_exchange<T, false>
+{
+    static std::vector<T> * exchange(statement & st, T & define,
+        std::size_t fetchSize)
+    {
+        if (fetchSize > 1)
+        {
+            throw soci_error("fetch_size is not supported for rowset of "
+                             "row or user-defined types.");
+        }
+
+        st.exchange_for_rowset(into(define));
+        return NULL;
+    }
+};
+
 //
 // Implementation of rowset
 //
@@ -114,9 +239,10 @@ public:
     typedef rowset_iterator<T> iterator;
 
     rowset_impl(details::prepare_temp_type const & prep)
-        : refs_(1), st_(new statement(prep)), define_(new T())
+        : refs_(1), fetchSize_(prep.get_prepare_info()->take_fetch_size()),
+          st_(new statement(prep)), define_(new T()),
+          buffer_(rowset_exchange<T>::exchange(*st_, *define_, fetchSize_))
     {
-        st_->exchange_for_rowset(into(*define_));
         st_->execute();
     }
 
@@ -136,6 +262,11 @@ public:
     iterator begin() const
     {
         // No ownership transfer occurs here
+        if (buffer_.get() != NULL)
+        {
+            return iterator(*st_, *buffer_);
+        }
+
         return iterator(*st_, *define_);
     }
 
@@ -147,9 +278,11 @@ public:
 private:
 
     unsigned int refs_;
+    std::size_t const fetchSize_;
 
     const cxx_details::auto_ptr<statement> st_;
     const cxx_details::auto_ptr<T> define_;
+    const cxx_details::auto_ptr<std::vector<T> > buffer_;
     SOCI_NOT_COPYABLE(rowset_impl)
 }; // class rowset_impl
 
@@ -177,6 +177,34 @@ public:
     std::string get_dummy_from_clause() const;
 
 
+    // Support for caching the statements executed using "sql << ..." syntax.
+
+    // Set the maximal number of prepared statements to keep in the cache,
+    // keyed by their query text. The default value of 0 disables caching,
+    // setting it destroys all the cached statements which don't fit any more.
+    void set_statement_cache_size(std::size_t size);
+    std::size_t get_statement_cache_size() const;
+
+    // Return the number of times a statement was or wasn't found in the cache.
+    unsigned long long get_statement_cache_hits() const;
+    unsigned long long get_statement_cache_misses() const;
+
+    // Remove the statement prepared for the given query from the cache and
+    // return it or return NULL if there is none.
+    details::statement_backend * acquire_cached_statement(std::string const & query);
+
+    // Put the statement prepared for the given query into the cache, taking
+    // ownership of it.
+    void release_cached_statement(std::string const & query,
+        details::statement_backend * backend);
+
+    // Set the timeout, in milliseconds, after which the execution of the
+    // statements or fetching data from them is cancelled and fails with
+    // query_timeout_error. The default value of 0 means no timeout. This can
+    // be overridden for individual statements using statement::set_timeout().
+    void set_query_timeout(int timeoutMs);
+    int get_query_timeout() const;
+
     // Sets the failover callback object.
     void set_failover_callback(failover_callback & callback);
 
@@ -209,6 +237,14 @@ private:
     bool isFromPool_;
     std::size_t poolPosition_;
     connection_pool * pool_;
+
+    struct statement_cache_impl;
+    statement_cache_impl * statementCache_;
+
+    int queryTimeoutMs_;
+
+    // Destroy all the cached statements, must be done before closing.
+    void clear_statement_cache();
 };
 
 } // namespace soci
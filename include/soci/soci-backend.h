@@ -10,6 +10,7 @@
 
 #include "soci/soci-platform.h"
 #include "soci/error.h"
+#include "soci/query-placeholders.h"
 // std
 #include <cstddef>
 #include <map>
@@ -31,6 +32,7 @@ enum indicator { i_ok, i_null, i_truncated };
 
 class session;
 class failover_callback;
+class column_batch;
 
 namespace details
 {
@@ -178,6 +180,13 @@ public:
     virtual void alloc() = 0;
     virtual void clean_up() = 0;
 
+    // Called after executing a statement which is going to be reused later,
+    // possibly with different into and use elements: this must release
+    // everything related to the last execution but keep the statement itself
+    // prepared. Return false if the statement can't be reused and must be
+    // cleaned up instead, as is the case by default.
+    virtual bool reset_for_reuse() { return false; }
+
     virtual void prepare(std::string const& query, statement_type eType) = 0;
 
     enum exec_fetch_result
@@ -189,11 +198,44 @@ public:
     virtual exec_fetch_result execute(int number) = 0;
     virtual exec_fetch_result fetch(int number) = 0;
 
+    // Backends able to execute statements without blocking override these
+    // functions: execute_async() must return false if the statement can't be
+    // executed asynchronously, in which case execute() is called from another
+    // thread instead. Otherwise finish_execute_async() is called once the
+    // execution completes, or to wait for it, and must return the same thing
+    // execute() would have returned.
+    virtual bool execute_async(int /* number */) { return false; }
+    virtual bool is_async_ready() { return true; }
+    virtual exec_fetch_result finish_execute_async(int /* number */)
+    {
+        throw soci_error("Asynchronous execution is not supported by this backend.");
+    }
+
+    // Return the socket used for the asynchronous execution, if any.
+    virtual int get_native_socket() { return -1; }
+
+    // Request cancellation of the operation currently executed by this
+    // statement, making it fail. This is called from another thread when the
+    // query timeout expires, so it must be thread-safe and must not throw.
+    // Return false if cancelling is not supported.
+    virtual bool cancel() { return false; }
+
     virtual long long get_affected_rows() = 0;
     virtual int get_number_of_rows() = 0;
 
     virtual std::string get_parameter_name(int index) const = 0;
 
+    // Return the placeholders found in the query by prepare(), if the backend
+    // uses query_placeholders for parsing it, so that the core doesn't need to
+    // parse it again.
+    virtual query_placeholders const * get_placeholders() const { return NULL; }
+
+    // Backends supporting fetching into column_batch append the values of
+    // all columns of the rows retrieved by execute() and fetch() to the batch
+    // set by this function directly, instead of using into elements. Return
+    // false if this is not supported.
+    virtual bool set_column_batch(column_batch * /* batch */) { return false; }
+
     virtual std::string rewrite_for_procedure_call(std::string const& query) = 0;
 
     virtual int prepare_for_describe() = 0;
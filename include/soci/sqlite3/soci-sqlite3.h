@@ -56,6 +56,13 @@ public:
 
     int result() const;
 
+    sqlite3_soci_error * clone() const SOCI_OVERRIDE
+    {
+        return new sqlite3_soci_error(*this);
+    }
+
+    SOCI_NORETURN rethrow() const SOCI_OVERRIDE { throw *this; }
+
 private:
     int result_;
 };
@@ -133,7 +140,7 @@ struct sqlite3_standard_use_type_backend : details::standard_use_type_backend
 struct sqlite3_vector_use_type_backend : details::vector_use_type_backend
 {
     sqlite3_vector_use_type_backend(sqlite3_statement_backend &st)
-        : statement_(st), data_(0), type_(), position_(0)
+        : statement_(st), data_(0), type_(), position_(0), ind_(NULL)
     {
     }
 
@@ -148,12 +155,20 @@ struct sqlite3_vector_use_type_backend : details::vector_use_type_backend
 
     void clean_up() SOCI_OVERRIDE;
 
+    // Bind the value of the given row directly from the vector, returns the
+    // SQLite result code.
+    int bind_row(std::size_t row);
+
     sqlite3_statement_backend &statement_;
 
     void *data_;
     details::exchange_type type_;
     int position_;
     std::string name_;
+    indicator const *ind_;
+
+    // Used for binding std::tm values, which need to be formatted as text.
+    char dateBuffer_[20];
 };
 
 struct sqlite3_column_buffer
@@ -198,6 +213,7 @@ struct sqlite3_statement_backend : details::statement_backend
 
     void alloc() SOCI_OVERRIDE;
     void clean_up() SOCI_OVERRIDE;
+    bool reset_for_reuse() SOCI_OVERRIDE;
     void prepare(std::string const &query,
         details::statement_type eType) SOCI_OVERRIDE;
     void reset_if_needed();
@@ -206,10 +222,14 @@ struct sqlite3_statement_backend : details::statement_backend
     exec_fetch_result execute(int number) SOCI_OVERRIDE;
     exec_fetch_result fetch(int number) SOCI_OVERRIDE;
 
+    bool cancel() SOCI_OVERRIDE;
+
     long long get_affected_rows() SOCI_OVERRIDE;
     int get_number_of_rows() SOCI_OVERRIDE;
     std::string get_parameter_name(int index) const SOCI_OVERRIDE;
 
+    bool set_column_batch(column_batch * batch) SOCI_OVERRIDE;
+
     std::string rewrite_for_procedure_call(std::string const &query) SOCI_OVERRIDE;
 
     int prepare_for_describe() SOCI_OVERRIDE;
@@ -223,8 +243,16 @@ struct sqlite3_statement_backend : details::statement_backend
 
     sqlite3_session_backend &session_;
     sqlite_api::sqlite3_stmt *stmt_;
+    // Rows fetched by the last bulk fetch: only the first dataCacheSize_ rows
+    // of dataCache_ are valid, it is never shrunk to reuse its memory.
     sqlite3_recordset dataCache_;
+    std::size_t dataCacheSize_;
+    // Contents of all string, date and blob values in dataCache_, each
+    // followed by a NUL.
+    std::vector<char> dataBuffer_;
+    // Values of the single use elements, the vector ones are in vectorUses_.
     sqlite3_recordset useData_;
+    std::vector<sqlite3_vector_use_type_backend *> vectorUses_;
     bool databaseReady_;
     bool boundByName_;
     bool boundByPos_;
@@ -234,8 +262,14 @@ struct sqlite3_statement_backend : details::statement_backend
     bool hasVectorIntoElements_;
     long long rowsAffectedBulk_; // number of rows affected by the last bulk operation
 
+    // If non-null, the rows are fetched directly into this batch instead of
+    // dataCache_.
+    column_batch * columnBatch_;
+
 private:
     exec_fetch_result load_rowset(int totalRows);
+    exec_fetch_result load_column_batch(int totalRows);
+    void append_to_data_buffer(sqlite3_column &col, void const *data, int size);
     exec_fetch_result load_one();
     exec_fetch_result bind_and_execute(int number);
 };
@@ -329,6 +363,10 @@ struct sqlite3_session_backend : details::session_backend
 
     }
     sqlite_api::sqlite3 *conn_;
+
+    // Whether bulk operations executed outside of a transaction are wrapped
+    // in a savepoint, false by default.
+    bool bulkSavepoint_;
 };
 
 struct sqlite3_backend_factory : backend_factory
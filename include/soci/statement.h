@@ -33,6 +33,7 @@ namespace details
 class into_type_base;
 class use_type_base;
 class prepare_temp_type;
+struct async_execution;
 
 class SOCI_DECL statement_impl
 {
@@ -60,13 +61,36 @@ public:
 
     void prepare(std::string const & query,
                     statement_type eType = st_repeatable_query);
+
+    // Used for the statements cached by the session: prepare_cached() reuses
+    // the backend statement prepared for the same query before, if any, and
+    // release_to_cache() gives it back to the session after execution.
+    void prepare_cached(std::string const & query);
+    void release_to_cache();
+
     void define_and_bind();
     void undefine_and_bind();
     bool execute(bool withDataExchange = false);
+
+    // Asynchronous execution: execute_async() starts executing the statement
+    // and returns immediately, is_async_ready() can be used to check if it
+    // has completed and finish_execute_async() waits for it to complete and
+    // does everything execute() would do after executing the query.
+    void execute_async(bool withDataExchange = false);
+    bool is_async_ready();
+    bool finish_execute_async();
+    int get_native_socket();
+
+    // Timeout for executing and fetching, in milliseconds: 0 means no timeout
+    // and -1, which is the default, means using the session query timeout.
+    void set_timeout(int timeoutMs) { timeoutMs_ = timeoutMs; }
+    int get_timeout() const { return timeoutMs_; }
+
     long long get_affected_rows();
     bool fetch();
     void describe();
     void set_row(row * r);
+    void set_column_batch(column_batch * b);
     void exchange_for_rowset(into_type_ptr const & i) { exchange_for_rowset_(i); }
     template<typename T, typename Indicator>
     void exchange_for_rowset(into_container<T, Indicator> const &ic)
@@ -91,7 +115,9 @@ public:
 protected:
     into_type_vector intos_;
     use_type_vector uses_;
-    std::vector<indicator *> indicators_;
+
+    // elements of uses_ owned by the values bound to this statement
+    std::vector<details::use_type_base *> valuesUses_;
 
 private:
     // Call this method from a catch clause (only!) to rethrow the exception
@@ -102,7 +128,14 @@ private:
 
     int refCount_;
 
+    // Placeholders in the query, only parsed when needed if the backend
+    // doesn't provide them.
+    query_placeholders placeholders_;
+    bool placeholdersParsed_;
+    query_placeholders const & get_placeholders();
+
     row * row_;
+    column_batch * columnBatch_;
     std::size_t fetchSize_;
     std::size_t initialFetchSize_;
     std::string query_;
@@ -138,8 +171,8 @@ private:
     template<typename T>
     void into_row()
     {
-        T * t = new T();
-        indicator * ind = new indicator(i_ok);
+        T * t;
+        indicator * ind;
         row_->add_holder(t, ind);
         exchange_for_row(into(*t, *ind));
     }
@@ -147,10 +180,30 @@ private:
     template<data_type>
     void bind_into();
 
+    void describe_column_batch();
+
     bool alreadyDescribed_;
 
     std::size_t intos_size();
     std::size_t uses_size();
+
+    // The two halves of execute(): the first one prepares everything for
+    // executing the statement and returns the number of rows to exchange,
+    // the second one processes the result of executing it.
+    int begin_execute(bool withDataExchange);
+    bool end_execute(statement_backend::exec_fetch_result res, int num);
+
+    // Start time of the current execution, only used for the metrics.
+    long long executeStartNs_;
+
+    // Non-null only while an asynchronous execution is in progress.
+    async_execution * async_;
+
+    int timeoutMs_;
+    int effective_timeout() const;
+
+    void cancel_async();
+
     void pre_exec(int num);
     void pre_fetch();
     void pre_use();
@@ -159,6 +212,16 @@ private:
     bool resize_intos(std::size_t upperBound = 0);
     void truncate_intos();
 
+    // Statistics reported to the logger if it wants them: total duration of
+    // all operations on the current query and the number of rows fetched.
+    long long metricsDurationNs_;
+    std::size_t metricsRows_;
+    bool metricsActive_;
+
+    std::size_t fetched_rows(bool gotData);
+    void start_query_metrics();
+    void finish_query_metrics();
+
     soci::details::statement_backend * backEnd_;
 
     SOCI_NOT_COPYABLE(statement_impl)
@@ -166,6 +229,8 @@ private:
 
 } // namespace details
 
+class async_result;
+
 // Statement is a handle class for statement_impl
 // (this provides copyability to otherwise non-copyable type)
 class SOCI_DECL statement
@@ -209,6 +274,13 @@ public:
         impl_->prepare(query, eType);
     }
 
+    void prepare_cached(std::string const & query)
+    {
+        impl_->prepare_cached(query);
+    }
+
+    void release_to_cache() { impl_->release_to_cache(); }
+
     void define_and_bind() { impl_->define_and_bind(); }
     void undefine_and_bind()  { impl_->undefine_and_bind(); }
     bool execute(bool withDataExchange = false)
@@ -217,6 +289,30 @@ public:
         return gotData_;
     }
 
+    // Start executing the statement without waiting for it to complete.
+    //
+    // Until the returned object get() is called, neither this statement nor
+    // its session may be used for anything else.
+    async_result execute_async(bool withDataExchange = false);
+
+    bool is_async_ready() { return impl_->is_async_ready(); }
+
+    bool finish_execute_async()
+    {
+        gotData_ = impl_->finish_execute_async();
+        return gotData_;
+    }
+
+    // Return the socket which becomes readable when the asynchronous
+    // execution makes progress or -1 if the backend doesn't provide it.
+    int get_native_socket() { return impl_->get_native_socket(); }
+
+    // Cancel execute() and fetch() calls taking longer than the given number
+    // of milliseconds, making them throw query_timeout_error. Use 0 to disable
+    // the timeout and -1 to use the session query timeout, as by default.
+    void set_timeout(int timeoutMs) { impl_->set_timeout(timeoutMs); }
+    int get_timeout() const { return impl_->get_timeout(); }
+
     long long get_affected_rows()
     {
         return impl_->get_affected_rows();
@@ -281,6 +377,36 @@ private:
     bool gotData_;
 };
 
+// Handle for the asynchronous execution started by statement::execute_async().
+//
+// This is a lightweight object referencing the statement, which must outlive
+// it. get() must be called exactly once to complete the execution.
+class async_result
+{
+public:
+    explicit async_result(statement & st) : st_(&st) {}
+
+    // Return true if get() can be called without blocking.
+    bool ready() const { return st_->is_async_ready(); }
+
+    // Wait until the execution completes, throwing if it failed, and return
+    // the same value as statement::execute() would.
+    bool get() { return st_->finish_execute_async(); }
+
+    // Return the socket to wait for with select() or poll() before checking
+    // ready() again or -1 if there is none and ready() must be polled.
+    int native_socket() const { return st_->get_native_socket(); }
+
+private:
+    statement * st_;
+};
+
+inline async_result statement::execute_async(bool withDataExchange)
+{
+    impl_->execute_async(withDataExchange);
+    return async_result(*this);
+}
+
 namespace details
 {
 // exchange_traits for statement
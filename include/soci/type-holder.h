@@ -9,8 +9,13 @@
 #define SOCI_TYPE_HOLDER_H_INCLUDED
 
 #include "soci/soci-platform.h"
+#include "soci/soci-backend.h"
 // std
+#include <cstddef>
+#include <ctime>
+#include <string>
 #include <typeinfo>
+#include <vector>
 
 namespace soci
 {
@@ -18,49 +23,172 @@ namespace soci
 namespace details
 {
 
-// Base class holder + derived class type_holder for storing type data
-// instances in a container of holder objects
+// Storage for a value of a single column of a dynamically described row.
+//
+// The values of all the supported types except strings are stored directly in
+// the union, so that the holders for all columns can be kept in a contiguous
+// array. The strings, which can't be stored in a union, are kept in a separate
+// array and only their index in it is stored here.
+struct type_holder
+{
+    data_type type_;
+
+    union
+    {
+        int integer_;
+        long long longLong_;
+        unsigned long long unsignedLongLong_;
+        double double_;
+        std::tm date_;
+        std::size_t stringIndex_;
+    } value_;
+};
+
+typedef std::vector<std::string> type_holder_strings;
+
+// Traits defining how to store the values of the given type in type_holder.
+//
+// The default implementation is used for all types which can't be stored in
+// it, so getting a value of such type always fails.
 template <typename T>
-class type_holder;
+struct type_holder_traits
+{
+    static T const & get(type_holder const &, type_holder_strings const &)
+    {
+        throw std::bad_cast();
+    }
+};
 
-class holder
+template <>
+struct type_holder_traits<int>
 {
-public:
-    holder() {}
-    virtual ~holder() {}
+    static int * init(type_holder & h, type_holder_strings &)
+    {
+        h.type_ = dt_integer;
+        h.value_.integer_ = 0;
+        return &h.value_.integer_;
+    }
 
-    template<typename T>
-    T get()
+    static int const & get(type_holder const & h, type_holder_strings const &)
     {
-        type_holder<T>* p = dynamic_cast<type_holder<T> *>(this);
-        if (p)
+        if (h.type_ != dt_integer)
         {
-            return p->template value<T>();
+            throw std::bad_cast();
         }
-        else
+
+        return h.value_.integer_;
+    }
+};
+
+template <>
+struct type_holder_traits<long long>
+{
+    static long long * init(type_holder & h, type_holder_strings &)
+    {
+        h.type_ = dt_long_long;
+        h.value_.longLong_ = 0;
+        return &h.value_.longLong_;
+    }
+
+    static long long const & get(type_holder const & h,
+        type_holder_strings const &)
+    {
+        if (h.type_ != dt_long_long)
         {
             throw std::bad_cast();
         }
+
+        return h.value_.longLong_;
     }
+};
 
-private:
+template <>
+struct type_holder_traits<unsigned long long>
+{
+    static unsigned long long * init(type_holder & h, type_holder_strings &)
+    {
+        h.type_ = dt_unsigned_long_long;
+        h.value_.unsignedLongLong_ = 0;
+        return &h.value_.unsignedLongLong_;
+    }
+
+    static unsigned long long const & get(type_holder const & h,
+        type_holder_strings const &)
+    {
+        if (h.type_ != dt_unsigned_long_long)
+        {
+            throw std::bad_cast();
+        }
 
-    template<typename T>
-    T value();
+        return h.value_.unsignedLongLong_;
+    }
 };
 
-template <typename T>
-class type_holder : public holder
+template <>
+struct type_holder_traits<double>
 {
-public:
-    type_holder(T * t) : t_(t) {}
-    ~type_holder() SOCI_OVERRIDE { delete t_; }
+    static double * init(type_holder & h, type_holder_strings &)
+    {
+        h.type_ = dt_double;
+        h.value_.double_ = 0;
+        return &h.value_.double_;
+    }
 
-    template<typename TypeValue>
-    TypeValue value() const { return *t_; }
+    static double const & get(type_holder const & h,
+        type_holder_strings const &)
+    {
+        if (h.type_ != dt_double)
+        {
+            throw std::bad_cast();
+        }
 
-private:
-    T * t_;
+        return h.value_.double_;
+    }
+};
+
+template <>
+struct type_holder_traits<std::tm>
+{
+    static std::tm * init(type_holder & h, type_holder_strings &)
+    {
+        h.type_ = dt_date;
+        h.value_.date_ = std::tm();
+        return &h.value_.date_;
+    }
+
+    static std::tm const & get(type_holder const & h,
+        type_holder_strings const &)
+    {
+        if (h.type_ != dt_date)
+        {
+            throw std::bad_cast();
+        }
+
+        return h.value_.date_;
+    }
+};
+
+template <>
+struct type_holder_traits<std::string>
+{
+    static std::string * init(type_holder & h, type_holder_strings & strings)
+    {
+        h.type_ = dt_string;
+        h.value_.stringIndex_ = strings.size();
+        strings.push_back(std::string());
+        return &strings.back();
+    }
+
+    static std::string const & get(type_holder const & h,
+        type_holder_strings const & strings)
+    {
+        if (h.type_ != dt_string)
+        {
+            throw std::bad_cast();
+        }
+
+        return strings[h.value_.stringIndex_];
+    }
 };
 
 } // namespace details
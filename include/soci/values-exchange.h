@@ -50,6 +50,7 @@ public:
     {
         v_.uppercase_column_names(st.session_.get_uppercase_column_names());
 
+        v_.reset_set_counter();
         convert_to_base();
         st.bind(v_);
     }
@@ -88,7 +89,12 @@ public:
         convert_from_base();
     }
 
-    void pre_use() SOCI_OVERRIDE {convert_to_base();}
+    void pre_use() SOCI_OVERRIDE
+    {
+        v_.reset_set_counter();
+        convert_to_base();
+    }
+
     void clean_up() SOCI_OVERRIDE {v_.clean_up();}
     std::size_t size() const SOCI_OVERRIDE { return 1; }
 
@@ -13,7 +13,7 @@
 #include "soci/use-type.h"
 // std
 #include <cstddef>
-#include <map>
+#include <new>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -39,6 +39,26 @@ struct copy_holder : public copy_base
     T value_;
 };
 
+// Simple memory arena used by values for the objects created by set().
+//
+// The memory is allocated in blocks of increasing size and is only freed by
+// release(), the objects created in it must be destroyed before calling it.
+// Notice that, just as the objects created by set() before, the memory is
+// intentionally not freed in the destructor, as values objects can be copied.
+class SOCI_DECL values_arena
+{
+public:
+    values_arena() : blockSize_(0), used_(0) {}
+
+    void * allocate(std::size_t size);
+    void release();
+
+private:
+    std::vector<char *> blocks_;
+    std::size_t blockSize_;
+    std::size_t used_;
+};
+
 } // namespace details
 
 class SOCI_DECL values
@@ -49,7 +69,9 @@ class SOCI_DECL values
 
 public:
 
-    values() : row_(NULL), currentPos_(0), uppercaseColumnNames_(false) {}
+    values()
+        : row_(NULL), currentPos_(0), setPos_(0), uppercaseColumnNames_(false)
+    {}
 
     indicator get_indicator(std::size_t pos) const;
     indicator get_indicator(std::string const & name) const;
@@ -165,54 +187,34 @@ public:
     template <typename T>
     void set(std::string const & name, T const & value, indicator indic = i_ok)
     {
-        typedef typename type_conversion<T>::base_type base_type;
-        if (index_.find(name) == index_.end())
+        std::size_t const index = find_name(name);
+        if (index == uses_.size())
         {
-            index_.insert(std::make_pair(name, uses_.size()));
-
-            indicator * pind = new indicator(indic);
-            indicators_.push_back(pind);
-
-            base_type baseValue;
-            type_conversion<T>::to_base(value, baseValue, *pind);
-
-            details::copy_holder<base_type> * pcopy =
-                    new details::copy_holder<base_type>(baseValue);
-            deepCopies_.push_back(pcopy);
-
-            uses_.push_back(new details::use_type<base_type>(
-                    pcopy->value_, *pind, name));
+            add_value(value, indic, name);
         }
         else
         {
-            size_t index = index_.find(name)->second;
-            *indicators_[index] = indic;
-            if (indic == i_ok)
-            {
-                type_conversion<T>::to_base(
-                        value,
-                        static_cast<details::copy_holder<base_type>*>(deepCopies_[index])->value_,
-                        *indicators_[index]);
-            }
+            overwrite_value(index, value, indic);
         }
+
+        setPos_ = index + 1;
     }
 
     template <typename T>
     void set(const T & value, indicator indic = i_ok)
     {
-        indicator * pind = new indicator(indic);
-        indicators_.push_back(pind);
-
-        typedef typename type_conversion<T>::base_type base_type;
-        base_type baseValue;
-        type_conversion<T>::to_base(value, baseValue, *pind);
-
-        details::copy_holder<base_type> * pcopy =
-            new details::copy_holder<base_type>(baseValue);
-        deepCopies_.push_back(pcopy);
+        // When the same object is converted again, e.g. because a prepared
+        // statement is re-executed, reuse the elements created the last time.
+        if (setPos_ < uses_.size() && names_[setPos_].empty())
+        {
+            overwrite_value(setPos_, value, indic);
+        }
+        else
+        {
+            add_value(value, indic, std::string());
+        }
 
-        uses_.push_back(new details::use_type<base_type>(
-                pcopy->value_, *pind));
+        ++setPos_;
     }
 
     template <typename T>
@@ -240,14 +242,24 @@ private:
     //TODO To make values generally usable outside of type_conversion's,
     // these should be reference counted smart pointers
     row * row_;
+
+    // All the objects pointed to by these vectors are allocated in the arena
+    // and owned by this object, even when they are bound to a statement.
     std::vector<details::standard_use_type *> uses_;
-    std::map<details::use_type_base *, indicator *> unused_;
     std::vector<indicator *> indicators_;
-    std::map<std::string, std::size_t> index_;
     std::vector<details::copy_base *> deepCopies_;
 
+    // Names of the elements created by set(), empty for the positional ones.
+    std::vector<std::string> names_;
+
+    details::values_arena arena_;
+
     mutable std::size_t currentPos_;
 
+    // Position of the next element to be set, used to reuse the existing
+    // elements when the same values are set again in the same order.
+    std::size_t setPos_;
+
     bool uppercaseColumnNames_;
 
     // When type_conversion::to() is called, a values object is created
@@ -256,15 +268,15 @@ private:
     template <typename T>
     T get_from_uses(std::string const & name, T const & nullValue) const
     {
-        std::map<std::string, std::size_t>::const_iterator pos = index_.find(name);
-        if (pos != index_.end())
+        std::size_t const pos = find_name(name);
+        if (pos != uses_.size())
         {
-            if (*indicators_[pos->second] == i_null)
+            if (*indicators_[pos] == i_null)
             {
                 return nullValue;
             }
 
-            return get_from_uses<T>(pos->second);
+            return get_from_uses<T>(pos);
         }
         throw soci_error("Value named " + name + " not found.");
     }
@@ -272,10 +284,10 @@ private:
     template <typename T>
     T get_from_uses(std::string const & name) const
     {
-        std::map<std::string, std::size_t>::const_iterator pos = index_.find(name);
-        if (pos != index_.end())
+        std::size_t const pos = find_name(name);
+        if (pos != uses_.size())
         {
-            return get_from_uses<T>(pos->second);
+            return get_from_uses<T>(pos);
         }
         throw soci_error("Value named " + name + " not found.");
     }
@@ -307,6 +319,64 @@ private:
         }
     }
 
+    // Returns the index of the element with the given name or uses_.size()
+    // if there is none.
+    std::size_t find_name(std::string const & name) const;
+
+    template <typename T>
+    void add_value(T const & value, indicator indic, std::string const & name)
+    {
+        typedef typename type_conversion<T>::base_type base_type;
+
+        indicator * pind = new (arena_.allocate(sizeof(indicator)))
+            indicator(indic);
+        indicators_.push_back(pind);
+
+        details::copy_holder<base_type> * pcopy =
+            new (arena_.allocate(sizeof(details::copy_holder<base_type>)))
+                details::copy_holder<base_type>(base_type());
+        deepCopies_.push_back(pcopy);
+
+        type_conversion<T>::to_base(value, pcopy->value_, *pind);
+
+        uses_.push_back(
+            new (arena_.allocate(sizeof(details::use_type<base_type>)))
+                details::use_type<base_type>(pcopy->value_, *pind, name));
+        names_.push_back(name);
+    }
+
+    template <typename T>
+    void overwrite_value(std::size_t index, T const & value, indicator indic)
+    {
+        typedef typename type_conversion<T>::base_type base_type;
+
+        details::copy_holder<base_type> * const pcopy =
+            dynamic_cast<details::copy_holder<base_type> *>(deepCopies_[index]);
+        if (pcopy == NULL)
+        {
+            std::ostringstream msg;
+            msg << "Value at position "
+                << static_cast<unsigned long>(index)
+                << " was already set using a different type";
+            throw soci_error(msg.str());
+        }
+
+        *indicators_[index] = indic;
+        if (indic == i_ok)
+        {
+            type_conversion<T>::to_base(value, pcopy->value_,
+                *indicators_[index]);
+        }
+    }
+
+    // this is called by use_type<values> before converting the object to
+    // values, so that the elements created during the previous conversion are
+    // reused
+    void reset_set_counter()
+    {
+        setPos_ = 0;
+    }
+
     row& get_row()
     {
         row_ = new row();
@@ -316,10 +386,9 @@ private:
     }
 
     // this is called by Statement::bind(values)
-    void add_unused(details::use_type_base * u, indicator * i)
+    void add_unused(details::use_type_base * u)
     {
         static_cast<details::standard_use_type *>(u)->convert_to_base();
-        unused_.insert(std::make_pair(u, i));
     }
 
     // this is called by details::into_type<values>::clean_up()
@@ -329,20 +398,26 @@ private:
         delete row_;
         row_ = NULL;
 
-        // delete any uses and indicators which were created  by set() but
-        // were not bound by the Statement
-        // (bound uses and indicators are deleted in Statement::clean_up())
-        for (std::map<details::use_type_base *, indicator *>::iterator pos =
-            unused_.begin(); pos != unused_.end(); ++pos)
+        // destroy all the objects created by set(), the statement doesn't
+        // delete the ones bound to it and calls clean_up() on them before
+        // calling it on the use_type<values> itself
+        for (std::size_t i = uses_.size(); i != 0; --i)
         {
-            delete pos->first;
-            delete pos->second;
+            uses_[i - 1]->~standard_use_type();
         }
 
-        for (std::size_t i = 0; i != deepCopies_.size(); ++i)
+        for (std::size_t i = deepCopies_.size(); i != 0; --i)
         {
-            delete deepCopies_[i];
+            deepCopies_[i - 1]->~copy_base();
         }
+
+        uses_.clear();
+        indicators_.clear();
+        deepCopies_.clear();
+        names_.clear();
+        setPos_ = 0;
+
+        arena_.release();
     }
 };
 
@@ -22,6 +22,7 @@ using namespace soci;
 using namespace soci::details;
 
 const char* soci::db2_option_driver_complete = "db2.driver_complete";
+const char* soci::db2_option_fetch_block_size = "db2.fetch_block_size";
 
 const std::string db2_soci_error::sqlState(std::string const & msg,const SQLSMALLINT htype,const SQLHANDLE hndl) {
     std::ostringstream ss(msg, std::ostringstream::app);
@@ -77,11 +78,25 @@ void db2_session_backend::parseConnectString(std::string const &  connectString)
 
 db2_session_backend::db2_session_backend(
     connection_parameters const & parameters) :
-        in_transaction(false)
+        in_transaction(false), fetchBlockSize(100)
 {
     std::string const& connectString = parameters.get_connect_string();
     parseConnectString(connectString);
 
+    std::string fetchBlockSizeString;
+    if (parameters.get_option(db2_option_fetch_block_size, fetchBlockSizeString))
+    {
+      unsigned blockSize = 0;
+      if (std::sscanf(fetchBlockSizeString.c_str(), "%u", &blockSize) != 1 ||
+            blockSize == 0)
+      {
+        throw soci_error("Invalid fetch block size option value \"" +
+                          fetchBlockSizeString + "\".");
+      }
+
+      fetchBlockSize = blockSize;
+    }
+
     SQLRETURN cliRC = SQL_ERROR;
 
     /* Prepare handles */
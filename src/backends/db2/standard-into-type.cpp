@@ -11,6 +11,8 @@
 #include "soci-exchange-cast.h"
 #include "soci-mktime.h"
 #include "common.h"
+#include <algorithm>
+#include <cstring>
 #include <ctime>
 
 using namespace soci;
@@ -80,15 +82,47 @@ void db2_standard_into_type_backend::define_by_pos(
     }
 
     valueLen = 0;
+    bindData = data;
+    bindSize = size;
 
+    bind_column(bindData, &valueLen);
+
+    statement_.standardIntos.push_back(this);
+}
+
+void db2_standard_into_type_backend::bind_column(void * data, SQLLEN * valueLen)
+{
     SQLRETURN cliRC = SQLBindCol(statement_.hStmt, static_cast<SQLUSMALLINT>(this->position),
-        static_cast<SQLUSMALLINT>(cType), data, size, &valueLen);
+        static_cast<SQLUSMALLINT>(cType), data, bindSize, valueLen);
     if (cliRC != SQL_SUCCESS)
     {
         throw db2_soci_error("Error while pre-fething into type",cliRC);
     }
 }
 
+void db2_standard_into_type_backend::copy_from_block(char const * row)
+{
+    std::memcpy(&valueLen, row + blockIndOffset, sizeof(valueLen));
+    if (SQL_NULL_DATA == valueLen)
+    {
+        return;
+    }
+
+    char const * const value = row + blockValueOffset;
+    std::size_t len = static_cast<std::size_t>(bindSize);
+    if (cType == SQL_C_CHAR)
+    {
+        // Don't copy the unused part of the buffer after the terminating NUL.
+        void const * const end = std::memchr(value, '\0', len);
+        if (end != NULL)
+        {
+            len = static_cast<char const *>(end) - value + 1;
+        }
+    }
+
+    std::memcpy(bindData, value, len);
+}
+
 void db2_standard_into_type_backend::pre_fetch()
 {
     //...
@@ -155,6 +189,10 @@ void db2_standard_into_type_backend::post_fetch(
 
 void db2_standard_into_type_backend::clean_up()
 {
+    std::vector<db2_standard_into_type_backend*>& intos
+        = statement_.standardIntos;
+    intos.erase(std::remove(intos.begin(), intos.end(), this), intos.end());
+
     if (buf)
     {
         delete [] buf;
@@ -13,8 +13,30 @@
 using namespace soci;
 using namespace soci::details;
 
+namespace // unnamed
+{
+
+// Maximal size of the buffer used for fetching the rows in blocks: if the rows
+// are too big for fetching the requested number of them at once, fewer rows
+// are fetched.
+std::size_t const max_block_buffer_length = 1024 * 1024;
+
+// All values in the block are aligned on this boundary, which is sufficient
+// for all the C types we use.
+std::size_t const block_alignment = 8;
+
+std::size_t align_block_offset(std::size_t offset)
+{
+    return (offset + block_alignment - 1) / block_alignment * block_alignment;
+}
+
+} // unnamed namespace
+
 db2_statement_backend::db2_statement_backend(db2_session_backend &session)
-    : session_(session),hasVectorUseElements(false),use_binding_method_(details::db2::BOUND_BY_NONE)
+    : session_(session),hasVectorUseElements(false),hasVectorIntoElements(false),
+      use_binding_method_(details::db2::BOUND_BY_NONE),
+      fetchBlockSize(session.fetchBlockSize),blockRowSize(0),blockRowsFetched(0),
+      blockPos(0),blockBound(false)
 {
 }
 
@@ -122,6 +144,13 @@ void db2_statement_backend::prepare(std::string const &  query ,
     if (cliRC!=SQL_SUCCESS) {
         throw db2_soci_error("Error while preparing query",cliRC);
     }
+
+    // the into elements will be added later if they're used with this query
+    standardIntos.clear();
+
+    blockBound = false;
+    blockRowsFetched = 0;
+    blockPos = 0;
 }
 
 statement_backend::exec_fetch_result
@@ -143,6 +172,10 @@ db2_statement_backend::execute(int  number )
         throw db2_soci_error(db2_soci_error::sqlState("Statement execution error",SQL_HANDLE_STMT,hStmt),cliRC);
     }
 
+    // the first row is always fetched directly into the into elements, as
+    // the query may well return just a single row
+    end_block_fetch();
+
     cliRC = SQLExecute(hStmt);
     if (cliRC != SQL_SUCCESS && cliRC != SQL_SUCCESS_WITH_INFO && cliRC != SQL_NO_DATA)
     {
@@ -154,7 +187,7 @@ db2_statement_backend::execute(int  number )
 
     if (number > 0 && colCount > 0)
     {
-        return fetch(number);
+        return do_fetch_rows(number);
     }
 
     return ef_success;
@@ -162,6 +195,18 @@ db2_statement_backend::execute(int  number )
 
 statement_backend::exec_fetch_result
 db2_statement_backend::fetch(int  number )
+{
+    if (number == 1 && fetchBlockSize > 1 &&
+            !hasVectorIntoElements && !standardIntos.empty())
+    {
+        return fetch_from_block();
+    }
+
+    return do_fetch_rows(number);
+}
+
+statement_backend::exec_fetch_result
+db2_statement_backend::do_fetch_rows(int number)
 {
     numRowsFetched = 0;
 
@@ -184,6 +229,121 @@ db2_statement_backend::fetch(int  number )
     return ef_success;
 }
 
+statement_backend::exec_fetch_result
+db2_statement_backend::fetch_from_block()
+{
+    if (blockPos == blockRowsFetched)
+    {
+        if (!blockBound && !start_block_fetch())
+        {
+            // Fall back to fetching the rows one by one if the rows are too
+            // big to be fetched in blocks.
+            fetchBlockSize = 1;
+            return do_fetch_rows(1);
+        }
+
+        blockRowsFetched = 0;
+        blockPos = 0;
+
+        SQLRETURN cliRC = SQLFetch(hStmt);
+
+        if (SQL_NO_DATA == cliRC)
+        {
+            return ef_no_data;
+        }
+
+        if (cliRC != SQL_SUCCESS && cliRC != SQL_SUCCESS_WITH_INFO)
+        {
+            throw db2_soci_error(db2_soci_error::sqlState("Error while fetching data", SQL_HANDLE_STMT, hStmt), cliRC);
+        }
+
+        if (blockRowsFetched == 0)
+        {
+            return ef_no_data;
+        }
+    }
+
+    char const * const row = &blockBuf[blockPos++ * blockRowSize];
+    for (std::size_t i = 0; i != standardIntos.size(); ++i)
+    {
+        standardIntos[i]->copy_from_block(row);
+    }
+
+    numRowsFetched = 1;
+
+    return ef_success;
+}
+
+bool db2_statement_backend::start_block_fetch()
+{
+    // Each row of the block contains the values of all columns, each of them
+    // followed by its length.
+    std::size_t rowSize = 0;
+    for (std::size_t i = 0; i != standardIntos.size(); ++i)
+    {
+        db2_standard_into_type_backend * const into = standardIntos[i];
+
+        into->blockValueOffset = rowSize;
+        rowSize += align_block_offset(static_cast<std::size_t>(into->bindSize));
+
+        into->blockIndOffset = rowSize;
+        rowSize += align_block_offset(sizeof(SQLLEN));
+    }
+
+    std::size_t rows = fetchBlockSize;
+    if (rows > max_block_buffer_length / rowSize)
+    {
+        rows = max_block_buffer_length / rowSize;
+        if (rows <= 1)
+        {
+            return false;
+        }
+    }
+
+    blockBuf.resize(rows * rowSize);
+    blockRowSize = rowSize;
+
+    for (std::size_t i = 0; i != standardIntos.size(); ++i)
+    {
+        db2_standard_into_type_backend * const into = standardIntos[i];
+        into->bind_column(&blockBuf[into->blockValueOffset],
+            reinterpret_cast<SQLLEN*>(&blockBuf[into->blockIndOffset]));
+    }
+
+    SQLSetStmtAttr(hStmt, SQL_ATTR_ROW_BIND_TYPE, db2::int_as_ptr(static_cast<int>(rowSize)), 0);
+    SQLSetStmtAttr(hStmt, SQL_ATTR_ROW_ARRAY_SIZE, db2::int_as_ptr(static_cast<int>(rows)), 0);
+    SQLSetStmtAttr(hStmt, SQL_ATTR_ROWS_FETCHED_PTR, &blockRowsFetched, 0);
+
+    blockBound = true;
+
+    return true;
+}
+
+void db2_statement_backend::end_block_fetch()
+{
+    if (blockBound)
+    {
+        for (std::size_t i = 0; i != standardIntos.size(); ++i)
+        {
+            db2_standard_into_type_backend * const into = standardIntos[i];
+            into->bind_column(into->bindData, &into->valueLen);
+        }
+
+        blockBound = false;
+    }
+
+    blockRowsFetched = 0;
+    blockPos = 0;
+}
+
+bool db2_statement_backend::cancel()
+{
+    // SQLCancel() can be called from another thread to cancel the function
+    // currently executing on the statement handle.
+    SQLRETURN const cliRC = SQLCancel(hStmt);
+    return cliRC == SQL_SUCCESS || cliRC == SQL_SUCCESS_WITH_INFO;
+}
+
 long long db2_statement_backend::get_affected_rows()
 {
     SQLLEN rows;
@@ -312,6 +472,7 @@ db2_standard_use_type_backend * db2_statement_backend::make_use_type_backend()
 db2_vector_into_type_backend *
 db2_statement_backend::make_vector_into_type_backend()
 {
+    hasVectorIntoElements = true;
     return new db2_vector_into_type_backend(*this);
 }
 
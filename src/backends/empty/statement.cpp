@@ -31,6 +31,12 @@ void empty_statement_backend::clean_up()
     // ...
 }
 
+bool empty_statement_backend::reset_for_reuse()
+{
+    // ...
+    return true;
+}
+
 void empty_statement_backend::prepare(std::string const & /* query */,
     statement_type /* eType */)
 {
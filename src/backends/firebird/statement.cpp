@@ -8,10 +8,18 @@
 #define SOCI_FIREBIRD_SOURCE
 #include "soci/firebird/soci-firebird.h"
 #include "firebird/error-firebird.h"
+#include <algorithm>
 #include <cctype>
+#include <cstring>
 #include <sstream>
 #include <iostream>
 
+// Batches are only available in the object-oriented API of Firebird 4.
+#if defined(FB_API_VER) && FB_API_VER >= 40
+#define SOCI_FIREBIRD_HAS_BATCH
+#include <firebird/Interface.h>
+#endif
+
 using namespace soci;
 using namespace soci::details;
 using namespace soci::details::firebird;
@@ -19,7 +27,7 @@ using namespace soci::details::firebird;
 firebird_statement_backend::firebird_statement_backend(firebird_session_backend &session)
     : session_(session), stmtp_(0), sqldap_(NULL), sqlda2p_(NULL),
         boundByName_(false), boundByPos_(false), rowsFetched_(0), endOfRowSet_(false), rowsAffectedBulk_(-1LL),
-            intoType_(eStandard), useType_(eStandard), procedure_(false)
+            batchUnavailable_(false), intoType_(eStandard), useType_(eStandard), procedure_(false)
 {}
 
 void firebird_statement_backend::prepareSQLDA(XSQLDA ** sqldap, short size)
@@ -407,7 +415,11 @@ firebird_statement_backend::execute(int number)
         }
     }
 
-    if (useType_ == eVector)
+    if (useType_ == eVector && executeBatch())
+    {
+        // all rows were already processed
+    }
+    else if (useType_ == eVector)
     {
         long long rowsAffectedBulkTemp = 0;
 
@@ -473,6 +485,263 @@ firebird_statement_backend::execute(int number)
     }
 }
 
+#ifdef SOCI_FIREBIRD_HAS_BATCH
+
+namespace
+{
+
+// Owners of the interface pointers, which must be either released or disposed
+// of depending on the interface.
+template <typename T>
+class fb_released
+{
+public:
+    explicit fb_released(T * p = NULL) : p_(p) {}
+    ~fb_released() { if (p_ != NULL) p_->release(); }
+
+    T * get() const { return p_; }
+    T * operator->() const { return p_; }
+
+private:
+    T * p_;
+
+    SOCI_NOT_COPYABLE(fb_released)
+};
+
+template <typename T>
+class fb_disposed
+{
+public:
+    explicit fb_disposed(T * p = NULL) : p_(p) {}
+    ~fb_disposed() { if (p_ != NULL) p_->dispose(); }
+
+    T * get() const { return p_; }
+    T * operator->() const { return p_; }
+
+private:
+    T * p_;
+
+    SOCI_NOT_COPYABLE(fb_disposed)
+};
+
+// Throw the error stored in the given status using the legacy status vector
+// format expected by throw_iscerror().
+void throw_status_error(Firebird::IStatus * status)
+{
+    ISC_STATUS stat[stat_size];
+
+    intptr_t const * const errors = status->getErrors();
+    std::size_t i = 0;
+    while (errors[i] != isc_arg_end)
+    {
+        std::size_t const n = errors[i] == isc_arg_cstring ? 3 : 2;
+        if (i + n >= stat_size)
+            break;
+
+        for (std::size_t j = 0; j != n; ++j)
+        {
+            stat[i + j] = static_cast<ISC_STATUS>(errors[i + j]);
+        }
+
+        i += n;
+    }
+    stat[i] = isc_arg_end;
+
+    throw_iscerror(stat);
+}
+
+void check_status(Firebird::CheckStatusWrapper & st)
+{
+    if (st.getState() & Firebird::IStatus::STATE_ERRORS)
+    {
+        throw_status_error(&st);
+    }
+}
+
+// Maximal size of the messages sent to the server in a single batch, bigger
+// bulk operations are split into several batches.
+unsigned const batch_buffer_size = 16 * 1024 * 1024;
+
+} // namespace anonymous
+
+bool firebird_statement_backend::executeBatch()
+{
+    using namespace Firebird;
+
+    // The batches are only used for the statements not returning anything and
+    // not using blobs, which would need to be registered with the batch.
+    if (batchUnavailable_ || sqldap_->sqld != 0)
+    {
+        return false;
+    }
+
+    std::size_t const usize = uses_.size();
+    for (std::size_t col = 0; col != usize; ++col)
+    {
+        exchange_type const type =
+            static_cast<firebird_vector_use_type_backend*>(uses_[col])->type_;
+        if (type == x_xmltype || type == x_longstring)
+        {
+            return false;
+        }
+    }
+
+    IMaster * const master = fb_get_master_interface();
+    fb_disposed<IStatus> status(master->getStatus());
+    CheckStatusWrapper st(status.get());
+
+    ISC_STATUS stat[stat_size];
+
+    IStatement * stmtPtr = NULL;
+    if (fb_get_statement_interface(stat, &stmtPtr, &stmtp_))
+    {
+        batchUnavailable_ = true;
+        return false;
+    }
+    fb_released<IStatement> stmt(stmtPtr);
+
+    fb_released<IMessageMetadata> meta(stmt->getInputMetadata(&st));
+    check_status(st);
+
+    // The messages are filled from the same XSQLDA buffers as used for
+    // executing the statement once per row, so their layout must match.
+    unsigned const count = meta->getCount(&st);
+    check_status(st);
+    if (count != static_cast<unsigned>(sqlda2p_->sqld))
+    {
+        batchUnavailable_ = true;
+        return false;
+    }
+
+    std::vector<unsigned> offsets(count);
+    std::vector<unsigned> nullOffsets(count);
+    for (unsigned i = 0; i != count; ++i)
+    {
+        XSQLVAR const * const var = sqlda2p_->sqlvar + i;
+        if (meta->getType(&st, i) != static_cast<unsigned>(var->sqltype & ~1) ||
+            meta->getLength(&st, i) != static_cast<unsigned>(var->sqllen))
+        {
+            batchUnavailable_ = true;
+            return false;
+        }
+
+        offsets[i] = meta->getOffset(&st, i);
+        nullOffsets[i] = meta->getNullOffset(&st, i);
+        check_status(st);
+    }
+
+    unsigned const msgLength = meta->getAlignedLength(&st);
+    check_status(st);
+
+    fb_disposed<IXpbBuilder> pb(master->getUtilInterface()->getXpbBuilder(
+        &st, IXpbBuilder::BATCH, NULL, 0));
+    check_status(st);
+
+    pb->insertInt(&st, IBatch::TAG_RECORD_COUNTS, 1);
+    pb->insertInt(&st, IBatch::TAG_BUFFER_BYTES_SIZE, batch_buffer_size);
+    check_status(st);
+
+    fb_released<IBatch> batch(stmt->createBatch(&st, meta.get(),
+        pb->getBufferLength(&st), pb->getBuffer(&st)));
+    if (st.getState() & IStatus::STATE_ERRORS)
+    {
+        // This happens when using a pre-4 server, just fall back to
+        // executing the statement once per row then.
+        batchUnavailable_ = true;
+        return false;
+    }
+
+    ITransaction * traPtr = NULL;
+    if (fb_get_transaction_interface(stat, &traPtr,
+            session_.current_transaction()))
+    {
+        throw_iscerror(stat);
+    }
+    fb_released<ITransaction> tra(traPtr);
+
+    std::vector<unsigned char> msg(msgLength);
+
+    std::size_t const rows =
+        static_cast<firebird_vector_use_type_backend*>(uses_[0])->size();
+    std::size_t const batchRows =
+        std::max<std::size_t>(batch_buffer_size / msgLength, 1);
+
+    long long rowsAffected = 0;
+    for (std::size_t first = 0; first < rows; first += batchRows)
+    {
+        std::size_t const last = std::min(rows, first + batchRows);
+        for (std::size_t row = first; row != last; ++row)
+        {
+            for (std::size_t col = 0; col != usize; ++col)
+            {
+                static_cast<firebird_vector_use_type_backend*>(uses_[col])->exchangeData(row);
+            }
+
+            for (unsigned i = 0; i != count; ++i)
+            {
+                XSQLVAR const * const var = sqlda2p_->sqlvar + i;
+
+                ISC_SHORT const isNull =
+                    (var->sqltype & 1) && var->sqlind != NULL && *var->sqlind == -1
+                        ? -1 : 0;
+                std::memcpy(&msg[nullOffsets[i]], &isNull, sizeof(isNull));
+
+                std::size_t len = static_cast<std::size_t>(var->sqllen);
+                if ((var->sqltype & ~1) == SQL_VARYING)
+                {
+                    len += sizeof(short);
+                }
+                std::memcpy(&msg[offsets[i]], var->sqldata, len);
+            }
+
+            batch->add(&st, 1, &msg[0]);
+            check_status(st);
+        }
+
+        fb_disposed<IBatchCompletionState> cs(batch->execute(&st, tra.get()));
+        check_status(st);
+
+        unsigned const executed = cs->getSize(&st);
+        check_status(st);
+
+        for (unsigned i = 0; i != executed; ++i)
+        {
+            int const state = cs->getState(&st, i);
+            check_status(st);
+
+            if (state == IBatchCompletionState::EXECUTE_FAILED)
+            {
+                // preserve the number of rows affected so far.
+                rowsAffectedBulk_ = rowsAffected;
+
+                fb_disposed<IStatus> error(master->getStatus());
+                cs->getStatus(&st, error.get(), i);
+                check_status(st);
+
+                throw_status_error(error.get());
+            }
+
+            if (state > 0)
+            {
+                rowsAffected += state;
+            }
+        }
+    }
+
+    rowsAffectedBulk_ = rowsAffected;
+
+    return true;
+}
+
+#else // !SOCI_FIREBIRD_HAS_BATCH
+
+bool firebird_statement_backend::executeBatch()
+{
+    return false;
+}
+
+#endif // SOCI_FIREBIRD_HAS_BATCH
+
 statement_backend::exec_fetch_result
 firebird_statement_backend::fetch(int number)
 {
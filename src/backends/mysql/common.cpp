@@ -6,10 +6,20 @@
 //
 
 #include "common.h"
+#include "soci/soci-platform.h"
+#include "soci-dtocstr.h"
+#include "soci-exchange-cast.h"
+#include "soci-mktime.h"
 #include <ciso646>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <ctime>
+#include <limits>
+#include <string>
+
+using namespace soci;
+using namespace soci::details;
 
 char * soci::details::mysql::quote(MYSQL * conn, const char *s, size_t len)
 {
@@ -21,3 +31,365 @@ char * soci::details::mysql::quote(MYSQL * conn, const char *s, size_t len)
 
     return retv;
 }
+
+void * soci::details::mysql::get_vector_element(void *p, exchange_type type,
+    std::size_t i)
+{
+    switch (type)
+    {
+    case x_char:         return get_vector_element<char>         (p, i);
+    case x_short:        return get_vector_element<short>        (p, i);
+    case x_integer:      return get_vector_element<int>          (p, i);
+    case x_long_long:    return get_vector_element<long long>    (p, i);
+    case x_unsigned_long_long:
+        return get_vector_element<unsigned long long>(p, i);
+    case x_double:       return get_vector_element<double>       (p, i);
+    case x_stdstring:    return get_vector_element<std::string>  (p, i);
+    case x_stdtm:        return get_vector_element<std::tm>      (p, i);
+
+    default:
+        throw soci_error("Vector element used with non-supported type.");
+    }
+}
+
+void soci::details::mysql::bind_param(MYSQL_BIND &bind, void *data,
+    exchange_type type, MYSQL_TIME &time)
+{
+    std::memset(&bind, 0, sizeof(bind));
+
+    switch (type)
+    {
+    case x_char:
+        bind.buffer_type = MYSQL_TYPE_STRING;
+        bind.buffer = data;
+        bind.buffer_length = 1;
+        break;
+    case x_stdstring:
+        {
+            std::string& s = exchange_type_cast<x_stdstring>(data);
+            bind.buffer_type = MYSQL_TYPE_STRING;
+            bind.buffer = const_cast<char *>(s.data());
+            bind.buffer_length = static_cast<unsigned long>(s.size());
+        }
+        break;
+    case x_short:
+        bind.buffer_type = MYSQL_TYPE_SHORT;
+        bind.buffer = data;
+        break;
+    case x_integer:
+        bind.buffer_type = MYSQL_TYPE_LONG;
+        bind.buffer = data;
+        break;
+    case x_long_long:
+        bind.buffer_type = MYSQL_TYPE_LONGLONG;
+        bind.buffer = data;
+        break;
+    case x_unsigned_long_long:
+        bind.buffer_type = MYSQL_TYPE_LONGLONG;
+        bind.buffer = data;
+        bind.is_unsigned = 1;
+        break;
+    case x_double:
+        if (is_infinity_or_nan(exchange_type_cast<x_double>(data)))
+        {
+            throw soci_error(
+                "Use element used with infinity or NaN, which are "
+                "not supported by the MySQL server.");
+        }
+
+        bind.buffer_type = MYSQL_TYPE_DOUBLE;
+        bind.buffer = data;
+        break;
+    case x_stdtm:
+        {
+            std::tm const& t = exchange_type_cast<x_stdtm>(data);
+
+            std::memset(&time, 0, sizeof(time));
+            time.year = t.tm_year + 1900;
+            time.month = t.tm_mon + 1;
+            time.day = t.tm_mday;
+            time.hour = t.tm_hour;
+            time.minute = t.tm_min;
+            time.second = t.tm_sec;
+            time.time_type = MYSQL_TIMESTAMP_DATETIME;
+
+            bind.buffer_type = MYSQL_TYPE_DATETIME;
+            bind.buffer = &time;
+        }
+        break;
+
+    default:
+        throw soci_error("Use element used with non-supported type.");
+    }
+}
+
+void soci::details::mysql::bind_result_column(mysql_result_column &col,
+    MYSQL_BIND &bind, MYSQL_FIELD const &field)
+{
+    col.fieldType_ = field.type;
+    col.decimals_ = field.decimals;
+    col.unsigned_ = (field.flags & UNSIGNED_FLAG) != 0;
+
+    std::size_t size;
+    switch (field.type)
+    {
+    case MYSQL_TYPE_TINY:
+    case MYSQL_TYPE_SHORT:
+    case MYSQL_TYPE_INT24:
+    case MYSQL_TYPE_LONG:
+    case MYSQL_TYPE_LONGLONG:
+        col.bufferType_ = MYSQL_TYPE_LONGLONG;
+        size = sizeof(long long);
+        break;
+    case MYSQL_TYPE_DOUBLE:
+        col.bufferType_ = MYSQL_TYPE_DOUBLE;
+        size = sizeof(double);
+        break;
+    case MYSQL_TYPE_DATE:
+    case MYSQL_TYPE_DATETIME:
+    case MYSQL_TYPE_TIMESTAMP:
+        col.bufferType_ = MYSQL_TYPE_DATETIME;
+        size = sizeof(MYSQL_TIME);
+        break;
+
+    default:
+        // This includes FLOAT and DECIMAL columns, for which the text
+        // representation is more precise.
+        col.bufferType_ = MYSQL_TYPE_STRING;
+
+        // max_length is only available if STMT_ATTR_UPDATE_MAX_LENGTH is set,
+        // the buffer is enlarged when fetching the data if necessary anyhow.
+        size = field.max_length + 1;
+        break;
+    }
+
+    col.buffer_.assign(size, '\0');
+    col.length_ = 0;
+    col.isNull_ = 0;
+
+    std::memset(&bind, 0, sizeof(bind));
+    bind.buffer_type = col.bufferType_;
+    bind.buffer = &col.buffer_[0];
+    bind.buffer_length = static_cast<unsigned long>(
+        col.bufferType_ == MYSQL_TYPE_STRING ? size - 1 : size);
+    bind.length = &col.length_;
+    bind.is_null = &col.isNull_;
+    bind.is_unsigned = col.unsigned_;
+}
+
+namespace // anonymous
+{
+
+template <typename T>
+T column_to_integer(mysql_column_value const &value)
+{
+    mysql_result_column const &col = *value.column_;
+
+    if (col.unsigned_)
+    {
+        unsigned long long u;
+        std::memcpy(&u, value.data_, sizeof(u));
+        if (u > static_cast<unsigned long long>(std::numeric_limits<T>::max()))
+        {
+            throw soci_error("Cannot convert data.");
+        }
+
+        return static_cast<T>(u);
+    }
+
+    long long v;
+    std::memcpy(&v, value.data_, sizeof(v));
+    if (v < 0)
+    {
+        if (v < static_cast<long long>(std::numeric_limits<T>::min()))
+        {
+            throw soci_error("Cannot convert data.");
+        }
+    }
+    else if (static_cast<unsigned long long>(v) >
+        static_cast<unsigned long long>(std::numeric_limits<T>::max()))
+    {
+        throw soci_error("Cannot convert data.");
+    }
+
+    return static_cast<T>(v);
+}
+
+// Returns the same text representation as would be used by the server for
+// the columns which are not retrieved as strings.
+std::string column_to_text(mysql_column_value const &value)
+{
+    mysql_result_column const &col = *value.column_;
+
+    char buf[64];
+    switch (col.bufferType_)
+    {
+    case MYSQL_TYPE_LONGLONG:
+        if (col.unsigned_)
+        {
+            unsigned long long u;
+            std::memcpy(&u, value.data_, sizeof(u));
+            snprintf(buf, sizeof(buf), "%" LL_FMT_FLAGS "u", u);
+        }
+        else
+        {
+            long long v;
+            std::memcpy(&v, value.data_, sizeof(v));
+            snprintf(buf, sizeof(buf), "%" LL_FMT_FLAGS "d", v);
+        }
+        return buf;
+
+    case MYSQL_TYPE_DOUBLE:
+        {
+            double d;
+            std::memcpy(&d, value.data_, sizeof(d));
+            return double_to_cstring(d);
+        }
+
+    case MYSQL_TYPE_DATETIME:
+        {
+            MYSQL_TIME t;
+            std::memcpy(&t, value.data_, sizeof(t));
+            if (col.fieldType_ == MYSQL_TYPE_DATE)
+            {
+                snprintf(buf, sizeof(buf), "%04u-%02u-%02u",
+                    t.year, t.month, t.day);
+                return buf;
+            }
+
+            snprintf(buf, sizeof(buf), "%04u-%02u-%02u %02u:%02u:%02u",
+                t.year, t.month, t.day, t.hour, t.minute, t.second);
+
+            std::string s(buf);
+            if (col.decimals_ > 0 && col.decimals_ <= 6)
+            {
+                snprintf(buf, sizeof(buf), ".%06lu",
+                    static_cast<unsigned long>(t.second_part));
+                s.append(buf, col.decimals_ + 1);
+            }
+
+            return s;
+        }
+
+    default:
+        return std::string(value.data_, value.length_);
+    }
+}
+
+} // namespace anonymous
+
+void soci::details::mysql::convert_column(mysql_column_value const &value,
+    exchange_type type, void *data)
+{
+    mysql_result_column const &col = *value.column_;
+
+    // Handle the conversions which can be done directly first.
+    switch (col.bufferType_)
+    {
+    case MYSQL_TYPE_LONGLONG:
+        switch (type)
+        {
+        case x_short:
+            exchange_type_cast<x_short>(data) = column_to_integer<short>(value);
+            return;
+        case x_integer:
+            exchange_type_cast<x_integer>(data) = column_to_integer<int>(value);
+            return;
+        case x_long_long:
+            exchange_type_cast<x_long_long>(data)
+                = column_to_integer<long long>(value);
+            return;
+        case x_unsigned_long_long:
+            exchange_type_cast<x_unsigned_long_long>(data)
+                = column_to_integer<unsigned long long>(value);
+            return;
+        case x_double:
+            if (col.unsigned_)
+            {
+                exchange_type_cast<x_double>(data) = static_cast<double>(
+                    column_to_integer<unsigned long long>(value));
+            }
+            else
+            {
+                exchange_type_cast<x_double>(data) = static_cast<double>(
+                    column_to_integer<long long>(value));
+            }
+            return;
+        default:
+            break;
+        }
+        break;
+
+    case MYSQL_TYPE_DOUBLE:
+        if (type == x_double)
+        {
+            std::memcpy(&exchange_type_cast<x_double>(data),
+                value.data_, sizeof(double));
+            return;
+        }
+        break;
+
+    case MYSQL_TYPE_DATETIME:
+        if (type == x_stdtm)
+        {
+            MYSQL_TIME t;
+            std::memcpy(&t, value.data_, sizeof(t));
+            mktime_from_ymdhms(exchange_type_cast<x_stdtm>(data),
+                static_cast<int>(t.year), static_cast<int>(t.month),
+                static_cast<int>(t.day), static_cast<int>(t.hour),
+                static_cast<int>(t.minute), static_cast<int>(t.second));
+            return;
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    // All the other conversions are done from the text representation, in
+    // the same way as when not using the prepared statements.
+    std::string text;
+    char const *buf;
+    std::size_t len;
+    if (col.bufferType_ == MYSQL_TYPE_STRING)
+    {
+        buf = value.data_;
+        len = value.length_;
+    }
+    else
+    {
+        text = column_to_text(value);
+        buf = text.c_str();
+        len = text.size();
+    }
+
+    switch (type)
+    {
+    case x_char:
+        exchange_type_cast<x_char>(data) = *buf;
+        break;
+    case x_stdstring:
+        exchange_type_cast<x_stdstring>(data).assign(buf, len);
+        break;
+    case x_short:
+        parse_num(buf, exchange_type_cast<x_short>(data));
+        break;
+    case x_integer:
+        parse_num(buf, exchange_type_cast<x_integer>(data));
+        break;
+    case x_long_long:
+        parse_num(buf, exchange_type_cast<x_long_long>(data));
+        break;
+    case x_unsigned_long_long:
+        parse_num(buf, exchange_type_cast<x_unsigned_long_long>(data));
+        break;
+    case x_double:
+        parse_num(buf, exchange_type_cast<x_double>(data));
+        break;
+    case x_stdtm:
+        parse_std_tm(buf, exchange_type_cast<x_stdtm>(data));
+        break;
+    default:
+        throw soci_error("Into element used with non-supported type.");
+    }
+}
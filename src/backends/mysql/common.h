@@ -81,6 +81,31 @@ std::size_t get_vector_size(void *p)
     return v->size();
 }
 
+template <typename T>
+void * get_vector_element(void *p, std::size_t i)
+{
+    std::vector<T> *v = static_cast<std::vector<T> *>(p);
+    return &(*v)[i];
+}
+
+// returns the pointer to the element of the vector of the given type
+void * get_vector_element(void *p, exchange_type type, std::size_t i);
+
+// helper for filling the parameter of a prepared statement, the value is
+// used directly from the data, except for std::tm which is stored in time
+void bind_param(MYSQL_BIND &bind, void *data, exchange_type type,
+    MYSQL_TIME &time);
+
+// helper for initializing a column of the result of a prepared statement
+// and its bind structure
+void bind_result_column(mysql_result_column &col, MYSQL_BIND &bind,
+    MYSQL_FIELD const &field);
+
+// converts the value of a non-null column of the result of a prepared
+// statement to the given type
+void convert_column(mysql_column_value const &value, exchange_type type,
+    void *data);
+
 } // namespace mysql
 
 } // namespace details
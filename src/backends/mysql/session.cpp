@@ -200,7 +200,9 @@ void parse_connect_string(const string & connectString,
     string *charset, bool *charset_p, bool *reconnect_p,
     unsigned int *connect_timeout, bool *connect_timeout_p,
     unsigned int *read_timeout, bool *read_timeout_p,
-    unsigned int *write_timeout, bool *write_timeout_p)
+    unsigned int *write_timeout, bool *write_timeout_p,
+    int *prepared, bool *prepared_p,
+    int *use_result, bool *use_result_p)
 {
     *host_p = false;
     *user_p = false;
@@ -217,6 +219,8 @@ void parse_connect_string(const string & connectString,
     *connect_timeout_p = false;
     *read_timeout_p = false;
     *write_timeout_p = false;
+    *prepared_p = false;
+    *use_result_p = false;
     string err = "Malformed connection string.";
     string::const_iterator i = connectString.begin(),
         end = connectString.end();
@@ -335,6 +339,30 @@ void parse_connect_string(const string & connectString,
             char *endp;
             *write_timeout = std::strtoul(val.c_str(), &endp, 10);
             *write_timeout_p = true;
+        } else if (par == "prepared" && !*prepared_p)
+        {
+            if (!valid_int(val))
+            {
+                throw soci_error(err);
+            }
+            *prepared = std::atoi(val.c_str());
+            if (*prepared != 0 && *prepared != 1)
+            {
+                throw soci_error(err);
+            }
+            *prepared_p = true;
+        } else if (par == "use_result" && !*use_result_p)
+        {
+            if (!valid_int(val))
+            {
+                throw soci_error(err);
+            }
+            *use_result = std::atoi(val.c_str());
+            if (*use_result != 0 && *use_result != 1)
+            {
+                throw soci_error(err);
+            }
+            *use_result_p = true;
         }
         else
         {
@@ -359,16 +387,18 @@ void parse_connect_string(const string & connectString,
 
 mysql_session_backend::mysql_session_backend(
     connection_parameters const & parameters)
+    : usePreparedStatements_(false), useResult_(false)
 {
     mysql_library::ensure_initialized();
 
     string host, user, password, db, unix_socket, ssl_ca, ssl_cert, ssl_key,
         charset;
-    int port, local_infile;
+    int port, local_infile, prepared, use_result;
     unsigned int connect_timeout, read_timeout, write_timeout;
     bool host_p, user_p, password_p, db_p, unix_socket_p, port_p,
         ssl_ca_p, ssl_cert_p, ssl_key_p, local_infile_p, charset_p, reconnect_p,
-        connect_timeout_p, read_timeout_p, write_timeout_p;
+        connect_timeout_p, read_timeout_p, write_timeout_p, prepared_p,
+        use_result_p;
     parse_connect_string(parameters.get_connect_string(), &host, &host_p, &user, &user_p,
         &password, &password_p, &db, &db_p,
         &unix_socket, &unix_socket_p, &port, &port_p,
@@ -376,7 +406,11 @@ mysql_session_backend::mysql_session_backend(
         &local_infile, &local_infile_p, &charset, &charset_p, &reconnect_p,
         &connect_timeout, &connect_timeout_p,
         &read_timeout, &read_timeout_p,
-        &write_timeout, &write_timeout_p);
+        &write_timeout, &write_timeout_p,
+        &prepared, &prepared_p,
+        &use_result, &use_result_p);
+    usePreparedStatements_ = prepared_p && prepared == 1;
+    useResult_ = use_result_p && use_result == 1;
     conn_ = mysql_init(NULL);
     if (conn_ == NULL)
     {
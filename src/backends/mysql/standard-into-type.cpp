@@ -51,14 +51,35 @@ void mysql_standard_into_type_backend::post_fetch(
         return;
     }
 
-    if (gotData)
+    if (gotData && statement_.stmt_ != NULL)
+    {
+        mysql_column_value const value = statement_.get_prepared_column(
+            statement_.currentRow_, position_ - 1);
+        if (value.data_ == NULL)
+        {
+            if (ind == NULL)
+            {
+                throw soci_error(
+                    "Null value fetched and no indicator defined.");
+            }
+            *ind = i_null;
+            return;
+        }
+
+        if (ind != NULL)
+        {
+            *ind = i_ok;
+        }
+
+        convert_column(value, type_, data_);
+    }
+    else if (gotData)
     {
         int pos = position_ - 1;
-        //mysql_data_seek(statement_.result_, statement_.currentRow_);
-        mysql_row_seek(statement_.result_,
-            statement_.resultRowOffsets_[statement_.currentRow_]);
-        MYSQL_ROW row = mysql_fetch_row(statement_.result_);
-        if (row[pos] == NULL)
+        unsigned long length;
+        const char *buf = statement_.get_text_value(
+            statement_.currentRow_, pos, length);
+        if (buf == NULL)
         {
             if (ind == NULL)
             {
@@ -75,7 +96,6 @@ void mysql_standard_into_type_backend::post_fetch(
                 *ind = i_ok;
             }
         }
-        const char *buf = row[pos] != NULL ? row[pos] : "";
         switch (type_)
         {
         case x_char:
@@ -84,9 +104,7 @@ void mysql_standard_into_type_backend::post_fetch(
         case x_stdstring:
             {
                 std::string& dest = exchange_type_cast<x_stdstring>(data_);
-                unsigned long * lengths =
-                    mysql_fetch_lengths(statement_.result_);
-                dest.assign(buf, lengths[pos]);
+                dest.assign(buf, length);
             }
             break;
         case x_short:
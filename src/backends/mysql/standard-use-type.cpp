@@ -41,6 +41,31 @@ void mysql_standard_use_type_backend::bind_by_name(
 
 void mysql_standard_use_type_backend::pre_use(indicator const *ind)
 {
+    if (statement_.stmt_ != NULL)
+    {
+        // With prepared statements the data is passed to the server directly.
+        if (ind != NULL && *ind == i_null)
+        {
+            std::memset(&bind_, 0, sizeof(bind_));
+            bind_.buffer_type = MYSQL_TYPE_NULL;
+        }
+        else
+        {
+            bind_param(bind_, data_, type_, time_);
+        }
+
+        if (position_ > 0)
+        {
+            statement_.useByPosBinds_[position_] = &bind_;
+        }
+        else
+        {
+            statement_.useByNameBinds_[name_] = &bind_;
+        }
+
+        return;
+    }
+
     if (ind != NULL && *ind == i_null)
     {
         buf_ = new char[5];
@@ -8,23 +8,44 @@
 
 #define SOCI_MYSQL_SOURCE
 #include "soci/mysql/soci-mysql.h"
-#include <cctype>
+#include "soci/noreturn.h"
+#include "common.h"
+#include <algorithm>
 #include <ciso646>
 
 using namespace soci;
 using namespace soci::details;
+using namespace soci::details::mysql;
 using std::string;
 
+namespace // unnamed
+{
+
+SOCI_NORETURN throw_stmt_error(MYSQL_STMT *stmt)
+{
+    throw mysql_soci_error(mysql_stmt_error(stmt), mysql_stmt_errno(stmt));
+}
+
+} // namespace unnamed
 
 mysql_statement_backend::mysql_statement_backend(
     mysql_session_backend &session)
-    : session_(session), result_(NULL),
+    : session_(session), result_(NULL), stmt_(NULL),
        rowsAffectedBulk_(-1LL), justDescribed_(false),
        hasIntoElements_(false), hasVectorIntoElements_(false),
-       hasUseElements_(false), hasVectorUseElements_(false)
+       hasUseElements_(false), hasVectorUseElements_(false),
+       useResult_(false), endOfResult_(false), batchSize_(0)
 {
 }
 
+mysql_statement_backend::~mysql_statement_backend()
+{
+    if (stmt_ != NULL)
+    {
+        mysql_stmt_close(stmt_);
+    }
+}
+
 void mysql_statement_backend::alloc()
 {
     // nothing to do here.
@@ -41,97 +62,88 @@ void mysql_statement_backend::clean_up()
         mysql_free_result(result_);
         result_ = NULL;
     }
+
+    if (stmt_ != NULL)
+    {
+        mysql_stmt_free_result(stmt_);
+    }
+}
+
+bool mysql_statement_backend::reset_for_reuse()
+{
+    // This frees the results, but keeps the prepared statement, if any.
+    clean_up();
+
+    justDescribed_ = false;
+
+    hasIntoElements_ = false;
+    hasVectorIntoElements_ = false;
+    hasUseElements_ = false;
+    hasVectorUseElements_ = false;
+
+    useByPosBuffers_.clear();
+    useByNameBuffers_.clear();
+    useByPosBinds_.clear();
+    useByNameBinds_.clear();
+
+    return true;
 }
 
 void mysql_statement_backend::prepare(std::string const & query,
-    statement_type /* eType */)
+    statement_type eType)
 {
-    queryChunks_.clear();
-    enum { eNormal, eInQuotes, eInName } state = eNormal;
+    // Backslash escapes quotes inside MySQL string literals.
+    placeholders_.parse(query, query_placeholders::backslash_escapes);
 
-    std::string name;
-    queryChunks_.push_back("");
+    if (stmt_ != NULL)
+    {
+        mysql_stmt_close(stmt_);
+        stmt_ = NULL;
+    }
 
-    bool escaped = false;
-    for (std::string::const_iterator it = query.begin(), end = query.end();
-         it != end; ++it)
+    if (session_.usePreparedStatements_ && eType == st_repeatable_query)
     {
-        switch (state)
+        // Server-side prepared statements use positional placeholders.
+        std::vector<std::string> const & chunks = placeholders_.chunks();
+        std::string preparedQuery = chunks.front();
+        for (std::size_t i = 1; i != chunks.size(); ++i)
         {
-        case eNormal:
-            if (*it == '\'')
-            {
-                queryChunks_.back() += *it;
-                state = eInQuotes;
-            }
-            else if (*it == ':')
-            {
-                const std::string::const_iterator next_it = it + 1;
-                // Check whether this is an assignment (e.g. @x:=y)
-                // and treat it as a special case, not as a named binding.
-                if (next_it != end && *next_it == '=')
-                {
-                    queryChunks_.back() += ":=";
-                    ++it;
-                }
-                else
-                {
-                    state = eInName;
-                }
-            }
-            else // regular character, stay in the same state
-            {
-                queryChunks_.back() += *it;
-            }
-            break;
-        case eInQuotes:
-            if (*it == '\'' && !escaped)
-            {
-                queryChunks_.back() += *it;
-                state = eNormal;
-            }
-            else // regular quoted character
-            {
-                queryChunks_.back() += *it;
-            }
-            escaped = *it == '\\' && !escaped;
-            break;
-        case eInName:
-            if (std::isalnum(*it) || *it == '_')
-            {
-                name += *it;
-            }
-            else // end of name
+            preparedQuery += '?';
+            preparedQuery += chunks[i];
+        }
+
+        stmt_ = mysql_stmt_init(session_.conn_);
+        if (stmt_ == NULL)
+        {
+            throw mysql_soci_error(mysql_error(session_.conn_),
+                mysql_errno(session_.conn_));
+        }
+
+        // Let mysql_stmt_store_result() compute the maximal length of the
+        // values in each column, so that we can allocate the buffers for
+        // them only once.
+        bool_type const updateMaxLength = 1;
+        mysql_stmt_attr_set(stmt_, STMT_ATTR_UPDATE_MAX_LENGTH,
+            &updateMaxLength);
+
+        if (0 != mysql_stmt_prepare(stmt_, preparedQuery.c_str(),
+                static_cast<unsigned long>(preparedQuery.size())))
+        {
+            unsigned int const errNum = mysql_stmt_errno(stmt_);
+            if (errNum != 1295) // ER_UNSUPPORTED_PS
             {
-                names_.push_back(name);
-                name.clear();
-                queryChunks_.push_back("");
-                queryChunks_.back() += *it;
-                state = eNormal;
+                mysql_soci_error const err(mysql_stmt_error(stmt_), errNum);
+                mysql_stmt_close(stmt_);
+                stmt_ = NULL;
+                throw err;
             }
-            break;
+
+            // Not all statements can be prepared, just execute the ones
+            // which can't as usual.
+            mysql_stmt_close(stmt_);
+            stmt_ = NULL;
         }
     }
-
-    if (state == eInName)
-    {
-        names_.push_back(name);
-    }
-/*
-  cerr << "Chunks: ";
-  for (std::vector<std::string>::iterator i = queryChunks_.begin();
-  i != queryChunks_.end(); ++i)
-  {
-  cerr << "\"" << *i << "\" ";
-  }
-  cerr << "\nNames: ";
-  for (std::vector<std::string>::iterator i = names_.begin();
-  i != names_.end(); ++i)
-  {
-  cerr << "\"" << *i << "\" ";
-  }
-  cerr << endl;
-*/
 }
 
 statement_backend::exec_fetch_result
@@ -141,6 +153,8 @@ mysql_statement_backend::execute(int number)
     {
         clean_up();
 
+        useResult_ = session_.useResult_;
+
         if (number > 1 && hasIntoElements_)
         {
              throw soci_error(
@@ -155,7 +169,15 @@ mysql_statement_backend::execute(int number)
         }
 
         std::string query;
-        if (not useByPosBuffers_.empty() or not useByNameBuffers_.empty())
+        if (stmt_ != NULL)
+        {
+            if (not execute_prepared(numberOfExecutions))
+            {
+                // bulk
+                return ef_no_data;
+            }
+        }
+        else if (not useByPosBuffers_.empty() or not useByNameBuffers_.empty())
         {
             if (not useByPosBuffers_.empty() and not useByNameBuffers_.empty())
             {
@@ -188,8 +210,10 @@ mysql_statement_backend::execute(int number)
                 {
                     // use elements bind by name
 
-                    for (std::vector<std::string>::iterator
-                             it = names_.begin(), end = names_.end();
+                    std::vector<std::string> const & names
+                        = placeholders_.names();
+                    for (std::vector<std::string>::const_iterator
+                             it = names.begin(), end = names.end();
                          it != end; ++it)
                     {
                         UseByNameBuffersMap::iterator b
@@ -206,16 +230,14 @@ mysql_statement_backend::execute(int number)
                         paramValues.push_back(buffers[i]);
                     }
                 }
-                //cerr << "queryChunks_.size(): "<<queryChunks_.size()<<endl;
-                //cerr << "paramValues.size(): "<<paramValues.size()<<endl;
-                if (queryChunks_.size() != paramValues.size()
-                    and queryChunks_.size() != paramValues.size() + 1)
+                std::vector<std::string> const & chunks
+                    = placeholders_.chunks();
+                if (chunks.size() != paramValues.size() + 1)
                 {
                     throw soci_error("Wrong number of parameters.");
                 }
 
-                std::vector<std::string>::const_iterator ci
-                    = queryChunks_.begin();
+                std::vector<std::string>::const_iterator ci = chunks.begin();
                 for (std::vector<char*>::const_iterator
                          pi = paramValues.begin(), end = paramValues.end();
                      pi != end; ++ci, ++pi)
@@ -223,10 +245,7 @@ mysql_statement_backend::execute(int number)
                     query += *ci;
                     query += *pi;
                 }
-                if (ci != queryChunks_.end())
-                {
-                    query += *ci;
-                }
+                query += *ci;
                 if (numberOfExecutions > 1)
                 {
                     // bulk operation
@@ -264,32 +283,24 @@ mysql_statement_backend::execute(int number)
         }
         else
         {
-            query = queryChunks_.front();
+            query = placeholders_.chunks().front();
         }
 
-        //std::cerr << query << std::endl;
-        if (0 != mysql_real_query(session_.conn_, query.c_str(),
-                static_cast<unsigned long>(query.size())))
-        {
-            throw mysql_soci_error(mysql_error(session_.conn_),
-                mysql_errno(session_.conn_));
-        }
-        result_ = mysql_store_result(session_.conn_);
-        if (result_ == NULL and mysql_field_count(session_.conn_) != 0)
-        {
-            throw mysql_soci_error(mysql_error(session_.conn_),
-                mysql_errno(session_.conn_));
-        }
-        if (result_ != NULL)
+        if (stmt_ == NULL)
         {
-            // Cache the rows offsets to have random access to the rows later.
-            // [mysql_data_seek() is O(n) so we don't want to use it].
-            int numrows = static_cast<int>(mysql_num_rows(result_));
-            resultRowOffsets_.resize(numrows);
-            for (int i = 0; i < numrows; i++)
+            //std::cerr << query << std::endl;
+            if (0 != mysql_real_query(session_.conn_, query.c_str(),
+                    static_cast<unsigned long>(query.size())))
+            {
+                throw mysql_soci_error(mysql_error(session_.conn_),
+                    mysql_errno(session_.conn_));
+            }
+            result_ = useResult_ ? mysql_use_result(session_.conn_)
+                                 : mysql_store_result(session_.conn_);
+            if (result_ == NULL and mysql_field_count(session_.conn_) != 0)
             {
-                resultRowOffsets_[i] = mysql_row_tell(result_);
-                mysql_fetch_row(result_);
+                throw mysql_soci_error(mysql_error(session_.conn_),
+                    mysql_errno(session_.conn_));
             }
         }
     }
@@ -303,7 +314,19 @@ mysql_statement_backend::execute(int number)
         currentRow_ = 0;
         rowsToConsume_ = 0;
 
-        numberOfRows_ = static_cast<int>(mysql_num_rows(result_));
+        if (useResult_)
+        {
+            // We don't know how many rows there are, so just try to fetch
+            // the requested number of them.
+            numberOfRows_ = 0;
+            endOfResult_ = false;
+
+            return number > 0 ? fetch_streamed(number) : ef_success;
+        }
+
+        numberOfRows_ = static_cast<int>(stmt_ != NULL
+            ? mysql_stmt_num_rows(stmt_)
+            : mysql_num_rows(result_));
         if (numberOfRows_ == 0)
         {
             return ef_no_data;
@@ -329,6 +352,379 @@ mysql_statement_backend::execute(int number)
     }
 }
 
+bool mysql_statement_backend::execute_prepared(int numberOfExecutions)
+{
+    bool const hasParams
+        = not useByPosBinds_.empty() or not useByNameBinds_.empty();
+    if (not useByPosBinds_.empty() and not useByNameBinds_.empty())
+    {
+        throw soci_error(
+            "Binding for use elements must be either by position "
+            "or by name.");
+    }
+
+    if (not hasParams)
+    {
+        numberOfExecutions = 1;
+    }
+
+    std::size_t const paramCount = mysql_stmt_param_count(stmt_);
+
+    long long rowsAffectedBulkTemp = -1;
+    for (int i = 0; i != numberOfExecutions; ++i)
+    {
+        if (hasParams)
+        {
+            paramBinds_.clear();
+
+            if (not useByPosBinds_.empty())
+            {
+                // use elements bind by position
+                for (UseByPosBindsMap::iterator
+                         it = useByPosBinds_.begin(),
+                         end = useByPosBinds_.end();
+                     it != end; ++it)
+                {
+                    paramBinds_.push_back(it->second[i]);
+                }
+            }
+            else
+            {
+                // use elements bind by name, which can occur more than once
+                std::vector<std::string> const & names
+                    = placeholders_.names();
+                for (std::vector<std::string>::const_iterator
+                         it = names.begin(), end = names.end();
+                     it != end; ++it)
+                {
+                    UseByNameBindsMap::iterator b = useByNameBinds_.find(*it);
+                    if (b == useByNameBinds_.end())
+                    {
+                        std::string msg(
+                            "Missing use element for bind by name (");
+                        msg += *it;
+                        msg += ").";
+                        throw soci_error(msg);
+                    }
+                    paramBinds_.push_back(b->second[i]);
+                }
+            }
+
+            if (paramBinds_.size() != paramCount)
+            {
+                throw soci_error("Wrong number of parameters.");
+            }
+
+            if (0 != mysql_stmt_bind_param(stmt_, &paramBinds_[0]))
+            {
+                throw_stmt_error(stmt_);
+            }
+        }
+
+        if (0 != mysql_stmt_execute(stmt_))
+        {
+            if (numberOfExecutions > 1)
+            {
+                // preserve the number of rows affected so far.
+                rowsAffectedBulk_ = rowsAffectedBulkTemp;
+            }
+            throw_stmt_error(stmt_);
+        }
+
+        if (numberOfExecutions > 1)
+        {
+            if (rowsAffectedBulkTemp == -1)
+            {
+                rowsAffectedBulkTemp = 0;
+            }
+            rowsAffectedBulkTemp += static_cast<long long>(
+                mysql_stmt_affected_rows(stmt_));
+
+            if (mysql_stmt_field_count(stmt_) != 0)
+            {
+                throw soci_error("The query shouldn't have returned"
+                    " any data but it did.");
+            }
+        }
+    }
+
+    rowsAffectedBulk_ = rowsAffectedBulkTemp;
+    if (numberOfExecutions > 1)
+    {
+        return false;
+    }
+
+    if (mysql_stmt_field_count(stmt_) == 0)
+    {
+        // it was not a SELECT
+        return true;
+    }
+
+    if (not useResult_ && 0 != mysql_stmt_store_result(stmt_))
+    {
+        throw_stmt_error(stmt_);
+    }
+
+    result_ = mysql_stmt_result_metadata(stmt_);
+    if (result_ == NULL)
+    {
+        throw_stmt_error(stmt_);
+    }
+
+    unsigned int const numFields = mysql_num_fields(result_);
+    MYSQL_FIELD const * const fields = mysql_fetch_fields(result_);
+
+    resultColumns_.resize(numFields);
+    resultBinds_.resize(numFields);
+    for (unsigned int i = 0; i != numFields; ++i)
+    {
+        bind_result_column(resultColumns_[i], resultBinds_[i], fields[i]);
+    }
+
+    if (0 != mysql_stmt_bind_result(stmt_, &resultBinds_[0]))
+    {
+        throw_stmt_error(stmt_);
+    }
+
+    return true;
+}
+
+bool mysql_statement_backend::fetch_next_prepared_row()
+{
+    int const res = mysql_stmt_fetch(stmt_);
+    if (res == 1)
+    {
+        throw_stmt_error(stmt_);
+    }
+    if (res == MYSQL_NO_DATA)
+    {
+        return false;
+    }
+
+    // Retrieve the strings which didn't fit into the buffers, this can only
+    // happen if the maximal length of the column values is not known.
+    bool rebind = false;
+    for (std::size_t i = 0; i != resultColumns_.size(); ++i)
+    {
+        mysql_result_column &col = resultColumns_[i];
+        if (col.bufferType_ != MYSQL_TYPE_STRING || col.isNull_)
+        {
+            continue;
+        }
+
+        if (col.length_ >= col.buffer_.size())
+        {
+            col.buffer_.resize(col.length_ + 1);
+
+            MYSQL_BIND &bind = resultBinds_[i];
+            bind.buffer = &col.buffer_[0];
+            bind.buffer_length = col.length_;
+            if (0 != mysql_stmt_fetch_column(stmt_, &bind,
+                    static_cast<unsigned int>(i), 0))
+            {
+                throw_stmt_error(stmt_);
+            }
+
+            rebind = true;
+        }
+
+        col.buffer_[col.length_] = '\0';
+    }
+
+    if (rebind && 0 != mysql_stmt_bind_result(stmt_, &resultBinds_[0]))
+    {
+        throw_stmt_error(stmt_);
+    }
+
+    return true;
+}
+
+int mysql_statement_backend::read_rows(int number)
+{
+    int rows = 0;
+
+    batchValues_.clear();
+    batchLengths_.clear();
+    batchData_.clear();
+    batchOffsets_.clear();
+
+    if (stmt_ != NULL)
+    {
+        batchSize_ = number;
+
+        for (; rows != number; ++rows)
+        {
+            if (not fetch_next_prepared_row())
+            {
+                break;
+            }
+
+            if (number == 1)
+            {
+                continue;
+            }
+
+            // The column buffers are overwritten by the next row, so copy
+            // their values into the single buffer used for the whole batch.
+            for (std::size_t i = 0; i != resultColumns_.size(); ++i)
+            {
+                mysql_result_column const &col = resultColumns_[i];
+                if (col.isNull_)
+                {
+                    copy_batch_value(NULL, 0, 0);
+                }
+                else if (col.bufferType_ == MYSQL_TYPE_STRING)
+                {
+                    copy_batch_value(&col.buffer_[0], col.length_,
+                        col.length_);
+                }
+                else
+                {
+                    copy_batch_value(&col.buffer_[0], col.buffer_.size(),
+                        col.length_);
+                }
+            }
+        }
+
+        if (number > 1)
+        {
+            point_to_batch_data();
+        }
+
+        return rows;
+    }
+
+    unsigned int const numFields = mysql_num_fields(result_);
+
+    for (; rows != number; ++rows)
+    {
+        MYSQL_ROW row = mysql_fetch_row(result_);
+        if (row == NULL)
+        {
+            if (mysql_errno(session_.conn_) != 0)
+            {
+                throw mysql_soci_error(mysql_error(session_.conn_),
+                    mysql_errno(session_.conn_));
+            }
+            break;
+        }
+
+        unsigned long const *lengths = mysql_fetch_lengths(result_);
+        for (unsigned int i = 0; i != numFields; ++i)
+        {
+            if (useResult_)
+            {
+                copy_batch_value(row[i], lengths[i], lengths[i]);
+            }
+            else
+            {
+                batchValues_.push_back(row[i]);
+                batchLengths_.push_back(lengths[i]);
+            }
+        }
+    }
+
+    if (useResult_)
+    {
+        point_to_batch_data();
+    }
+
+    return rows;
+}
+
+void mysql_statement_backend::copy_batch_value(char const *value,
+    std::size_t size, unsigned long length)
+{
+    batchValues_.push_back(value);
+    batchLengths_.push_back(length);
+    batchOffsets_.push_back(batchData_.size());
+
+    if (value != NULL)
+    {
+        batchData_.insert(batchData_.end(), value, value + size);
+        batchData_.push_back('\0');
+    }
+}
+
+void mysql_statement_backend::point_to_batch_data()
+{
+    // Now that the buffer won't be reallocated any more, point to it instead
+    // of the original values which are not valid any longer.
+    for (std::size_t i = 0; i != batchValues_.size(); ++i)
+    {
+        if (batchValues_[i] != NULL)
+        {
+            batchValues_[i] = &batchData_[batchOffsets_[i]];
+        }
+    }
+}
+
+char const *mysql_statement_backend::get_text_value(int row, int pos,
+    unsigned long &length)
+{
+    std::size_t const n = (row - currentRow_) * mysql_num_fields(result_)
+        + pos;
+
+    char const * const value = batchValues_[n];
+    if (value != NULL)
+    {
+        length = batchLengths_[n];
+    }
+
+    return value;
+}
+
+mysql_column_value mysql_statement_backend::get_prepared_column(
+    int row, int pos)
+{
+    mysql_result_column const &col = resultColumns_[pos];
+
+    mysql_column_value value;
+    value.column_ = &col;
+
+    if (batchSize_ > 1)
+    {
+        std::size_t const n = (row - currentRow_) * resultColumns_.size()
+            + pos;
+
+        value.data_ = batchValues_[n];
+        value.length_ = batchLengths_[n];
+    }
+    else
+    {
+        value.data_ = col.isNull_ ? NULL : &col.buffer_[0];
+        value.length_ = col.length_;
+    }
+
+    return value;
+}
+
+statement_backend::exec_fetch_result
+mysql_statement_backend::fetch_streamed(int number)
+{
+    currentRow_ += rowsToConsume_;
+    rowsToConsume_ = 0;
+
+    if (endOfResult_)
+    {
+        return ef_no_data;
+    }
+
+    int const rows = read_rows(number);
+
+    numberOfRows_ = currentRow_ + rows;
+    rowsToConsume_ = rows;
+
+    if (rows < number)
+    {
+        // this simulates the behaviour of Oracle, see fetch() below
+        endOfResult_ = true;
+        return ef_no_data;
+    }
+
+    return ef_success;
+}
+
 statement_backend::exec_fetch_result
 mysql_statement_backend::fetch(int number)
 {
@@ -336,7 +732,16 @@ mysql_statement_backend::fetch(int number)
     // - the data was already retrieved from the server in the execute()
     // function, and the actual consumption of this data will take place
     // in the postFetch functions, called for each into element.
-    // Here, we only prepare for this to happen (to emulate "the Oracle way").
+    // Here, we only prepare for this to happen (to emulate "the Oracle way")
+    // by walking over the rows to consume once and collecting the values of
+    // all columns, so that postFetch functions don't have to do it.
+
+    if (useResult_)
+    {
+        // Unless the rows are streamed, in which case they're really
+        // retrieved from the server here.
+        return fetch_streamed(number);
+    }
 
     // forward the "cursor" from the last fetch
     currentRow_ += rowsToConsume_;
@@ -351,6 +756,7 @@ mysql_statement_backend::fetch(int number)
         if (currentRow_ + number > numberOfRows_)
         {
             rowsToConsume_ = numberOfRows_ - currentRow_;
+            read_rows(rowsToConsume_);
 
             // this simulates the behaviour of Oracle
             // - when EOF is hit, we return ef_no_data even when there are
@@ -360,6 +766,7 @@ mysql_statement_backend::fetch(int number)
         else
         {
             rowsToConsume_ = number;
+            read_rows(rowsToConsume_);
             return ef_success;
         }
     }
@@ -371,6 +778,10 @@ long long mysql_statement_backend::get_affected_rows()
     {
         return rowsAffectedBulk_;
     }
+    if (stmt_ != NULL)
+    {
+        return static_cast<long long>(mysql_stmt_affected_rows(stmt_));
+    }
     return static_cast<long long>(mysql_affected_rows(session_.conn_));
 }
 
@@ -381,7 +792,7 @@ int mysql_statement_backend::get_number_of_rows()
 
 std::string mysql_statement_backend::get_parameter_name(int index) const
 {
-    return names_.at(index);
+    return placeholders_.names().at(index);
 }
 
 std::string mysql_statement_backend::rewrite_for_procedure_call(
@@ -394,10 +805,12 @@ std::string mysql_statement_backend::rewrite_for_procedure_call(
 
 int mysql_statement_backend::prepare_for_describe()
 {
-    execute(1);
+    // Don't fetch any rows yet, as each of them can be read only once.
+    execute(0);
     justDescribed_ = true;
 
-    int columns = mysql_field_count(session_.conn_);
+    int columns = stmt_ != NULL ? mysql_stmt_field_count(stmt_)
+                                : mysql_field_count(session_.conn_);
     return columns;
 }
 
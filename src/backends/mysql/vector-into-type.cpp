@@ -58,15 +58,46 @@ void mysql_vector_into_type_backend::post_fetch(bool gotData, indicator *ind)
 
         int const endRow = statement_.currentRow_ + statement_.rowsToConsume_;
 
-        //mysql_data_seek(statement_.result_, statement_.currentRow_);
-        mysql_row_seek(statement_.result_,
-            statement_.resultRowOffsets_[statement_.currentRow_]);
+        if (statement_.stmt_ != NULL)
+        {
+            for (int curRow = statement_.currentRow_, i = 0;
+                 curRow != endRow; ++curRow, ++i)
+            {
+                mysql_column_value const value
+                    = statement_.get_prepared_column(curRow, pos);
+                if (value.data_ == NULL)
+                {
+                    if (ind == NULL)
+                    {
+                        throw soci_error(
+                            "Null value fetched and no indicator defined.");
+                    }
+
+                    ind[i] = i_null;
+                    continue;
+                }
+
+                if (ind != NULL)
+                {
+                    ind[i] = i_ok;
+                }
+
+                convert_column(value, type_,
+                    get_vector_element(data_, type_, i));
+            }
+
+            return;
+        }
+
         for (int curRow = statement_.currentRow_, i = 0;
              curRow != endRow; ++curRow, ++i)
         {
-            MYSQL_ROW row = mysql_fetch_row(statement_.result_);
+            // buffer with data retrieved from server, in text format
+            unsigned long length;
+            const char *buf = statement_.get_text_value(curRow, pos, length);
+
             // first, deal with indicators
-            if (row[pos] == NULL)
+            if (buf == NULL)
             {
                 if (ind == NULL)
                 {
@@ -87,9 +118,6 @@ void mysql_vector_into_type_backend::post_fetch(bool gotData, indicator *ind)
                 }
             }
 
-            // buffer with data retrieved from server, in text format
-            const char *buf = row[pos] != NULL ? row[pos] : "";
-
             switch (type_)
             {
             case x_char:
@@ -97,15 +125,13 @@ void mysql_vector_into_type_backend::post_fetch(bool gotData, indicator *ind)
                 break;
             case x_stdstring:
                 {
-                    unsigned long * lengths =
-                        mysql_fetch_lengths(statement_.result_);
                     // Not sure if it's necessary, but the code below is used
                     // instead of
-                    // set_invector_(data_, i, std::string(buf, lengths[pos]);
+                    // set_invector_(data_, i, std::string(buf, length);
                     // to avoid copying the (possibly large) temporary string.
                     std::vector<std::string> *dest =
                         static_cast<std::vector<std::string> *>(data_);
-                    (*dest)[i].assign(buf, lengths[pos]);
+                    (*dest)[i].assign(buf, length);
                 }
                 break;
             case x_short:
@@ -45,7 +45,43 @@ void mysql_vector_use_type_backend::bind_by_name(
 
 void mysql_vector_use_type_backend::pre_use(indicator const *ind)
 {
+    // get rid of the buffers used by the previous execution, if any
+    clean_up();
+
     std::size_t const vsize = size();
+
+    if (statement_.stmt_ != NULL)
+    {
+        // With prepared statements the data is passed to the server directly
+        // from the vector elements.
+        binds_.resize(vsize);
+        times_.resize(vsize);
+        for (std::size_t i = 0; i != vsize; ++i)
+        {
+            if (ind != NULL && ind[i] == i_null)
+            {
+                std::memset(&binds_[i], 0, sizeof(binds_[i]));
+                binds_[i].buffer_type = MYSQL_TYPE_NULL;
+            }
+            else
+            {
+                bind_param(binds_[i], get_vector_element(data_, type_, i),
+                    type_, times_[i]);
+            }
+        }
+
+        if (position_ > 0)
+        {
+            statement_.useByPosBinds_[position_] = &binds_[0];
+        }
+        else
+        {
+            statement_.useByNameBinds_[name_] = &binds_[0];
+        }
+
+        return;
+    }
+
     for (size_t i = 0; i != vsize; ++i)
     {
         char *buf;
@@ -214,4 +250,6 @@ void mysql_vector_use_type_backend::clean_up()
     {
         delete [] buffers_[i];
     }
+
+    buffers_.clear();
 }
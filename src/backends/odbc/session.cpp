@@ -18,10 +18,11 @@ using namespace soci;
 using namespace soci::details;
 
 char const * soci::odbc_option_driver_complete = "odbc.driver_complete";
+char const * soci::odbc_option_fetch_block_size = "odbc.fetch_block_size";
 
 odbc_session_backend::odbc_session_backend(
     connection_parameters const & parameters)
-    : henv_(0), hdbc_(0), product_(prod_uninitialized)
+    : henv_(0), hdbc_(0), fetchBlockSize_(100), product_(prod_uninitialized)
 {
     SQLRETURN rc;
 
@@ -78,6 +79,20 @@ odbc_session_backend::odbc_session_backend(
       }
     }
 
+    std::string fetchBlockSizeString;
+    if (parameters.get_option(odbc_option_fetch_block_size, fetchBlockSizeString))
+    {
+      unsigned fetchBlockSize = 0;
+      if (std::sscanf(fetchBlockSizeString.c_str(), "%u", &fetchBlockSize) != 1 ||
+            fetchBlockSize == 0)
+      {
+        throw soci_error("Invalid fetch block size option value \"" +
+                          fetchBlockSizeString + "\".");
+      }
+
+      fetchBlockSize_ = fetchBlockSize;
+    }
+
 #ifdef _WIN32
     if (completion != SQL_DRIVER_NOPROMPT)
       hwnd_for_prompt = ::GetDesktopWindow();
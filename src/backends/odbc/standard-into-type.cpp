@@ -12,6 +12,8 @@
 #include "soci-cstrtoi.h"
 #include "soci-exchange-cast.h"
 #include "soci-mktime.h"
+#include <algorithm>
+#include <cstring>
 #include <ctime>
 
 using namespace soci;
@@ -104,9 +106,18 @@ void odbc_standard_into_type_backend::define_by_pos(
     }
 
     valueLen_ = 0;
+    bindData_ = data;
+    bindSize_ = size;
 
+    bind_column(bindData_, &valueLen_);
+
+    statement_.standardIntos_.push_back(this);
+}
+
+void odbc_standard_into_type_backend::bind_column(void * data, SQLLEN * valueLen)
+{
     SQLRETURN rc = SQLBindCol(statement_.hstmt_, static_cast<SQLUSMALLINT>(position_),
-        static_cast<SQLUSMALLINT>(odbcType_), data, size, &valueLen_);
+        static_cast<SQLUSMALLINT>(odbcType_), data, bindSize_, valueLen);
     if (is_odbc_error(rc))
     {
         std::ostringstream ss;
@@ -115,6 +126,29 @@ void odbc_standard_into_type_backend::define_by_pos(
     }
 }
 
+void odbc_standard_into_type_backend::copy_from_block(char const * row)
+{
+    std::memcpy(&valueLen_, row + blockIndOffset_, sizeof(valueLen_));
+    if (SQL_NULL_DATA == get_sqllen_from_value(valueLen_))
+    {
+        return;
+    }
+
+    char const * const value = row + blockValueOffset_;
+    std::size_t len = static_cast<std::size_t>(bindSize_);
+    if (odbcType_ == SQL_C_CHAR)
+    {
+        // Don't copy the unused part of the buffer after the terminating NUL.
+        void const * const end = std::memchr(value, '\0', len);
+        if (end != NULL)
+        {
+            len = static_cast<char const *>(end) - value + 1;
+        }
+    }
+
+    std::memcpy(bindData_, value, len);
+}
+
 void odbc_standard_into_type_backend::pre_fetch()
 {
     //...
@@ -212,6 +246,10 @@ void odbc_standard_into_type_backend::post_fetch(
 
 void odbc_standard_into_type_backend::clean_up()
 {
+    std::vector<odbc_standard_into_type_backend*>& intos
+        = statement_.standardIntos_;
+    intos.erase(std::remove(intos.begin(), intos.end(), this), intos.end());
+
     if (buf_)
     {
         delete [] buf_;
@@ -7,6 +7,7 @@
 
 #define SOCI_ODBC_SOURCE
 #include "soci/odbc/soci-odbc.h"
+#include "soci-compiler.h"
 #include <cctype>
 #include <sstream>
 #include <cstring>
@@ -14,11 +15,32 @@
 using namespace soci;
 using namespace soci::details;
 
+namespace // unnamed
+{
+
+// Maximal size of the buffer used for fetching the rows in blocks: if the rows
+// are too big for fetching the requested number of them at once, fewer rows
+// are fetched.
+std::size_t const odbc_max_block_buffer_length = 1024 * 1024;
+
+// All values in the block are aligned on this boundary, which is sufficient
+// for all the C types we use.
+std::size_t const odbc_block_alignment = 8;
+
+std::size_t align_block_offset(std::size_t offset)
+{
+    return (offset + odbc_block_alignment - 1)
+                / odbc_block_alignment * odbc_block_alignment;
+}
+
+} // unnamed namespace
+
 
 odbc_statement_backend::odbc_statement_backend(odbc_session_backend &session)
     : session_(session), hstmt_(0), numRowsFetched_(0), fetchVectorByRows_(false),
       hasVectorUseElements_(false), boundByName_(false), boundByPos_(false),
-      rowsAffected_(-1LL)
+      rowsAffected_(-1LL), fetchBlockSize_(session.fetchBlockSize_),
+      blockRowSize_(0), blockRowsFetched_(0), blockPos_(0), blockBound_(false)
 {
 }
 
@@ -135,6 +157,11 @@ void odbc_statement_backend::prepare(std::string const & query,
     // reset any old into buffers, they will be added later if they're used
     // with this query
     intos_.clear();
+    standardIntos_.clear();
+
+    blockBound_ = false;
+    blockRowsFetched_ = 0;
+    blockPos_ = 0;
 }
 
 statement_backend::exec_fetch_result
@@ -151,6 +178,10 @@ odbc_statement_backend::execute(int number)
     // cursor or an "invalid cursor state" error will occur on execute
     SQLCloseCursor(hstmt_);
 
+    // the first row is always fetched directly into the into elements, as
+    // the query may well return just a single row
+    end_block_fetch();
+
     SQLRETURN rc = SQLExecute(hstmt_);
     if (is_odbc_error(rc))
     {
@@ -208,7 +239,7 @@ odbc_statement_backend::execute(int number)
 
     if (number > 0 && colCount > 0)
     {
-        return fetch(number);
+        return do_fetch_rows(number);
     }
 
     return ef_success;
@@ -239,6 +270,17 @@ odbc_statement_backend::do_fetch(int beginRow, int endRow)
 
 statement_backend::exec_fetch_result
 odbc_statement_backend::fetch(int number)
+{
+    if (number == 1 && can_fetch_in_blocks())
+    {
+        return fetch_from_block();
+    }
+
+    return do_fetch_rows(number);
+}
+
+statement_backend::exec_fetch_result
+odbc_statement_backend::do_fetch_rows(int number)
 {
     numRowsFetched_ = 0;
 
@@ -295,6 +337,161 @@ odbc_statement_backend::fetch(int number)
     return res;
 }
 
+bool odbc_statement_backend::can_fetch_in_blocks() const
+{
+    if (fetchBlockSize_ <= 1 || !intos_.empty() || standardIntos_.empty())
+    {
+        return false;
+    }
+
+    // Don't use blocks for the huge buffers used for the long string columns,
+    // see odbc_standard_into_type_backend::define_by_pos().
+    for (std::size_t i = 0; i != standardIntos_.size(); ++i)
+    {
+        if (standardIntos_[i]->bindSize_ > ODBC_MAX_COL_SIZE)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+statement_backend::exec_fetch_result
+odbc_statement_backend::fetch_from_block()
+{
+    if (blockPos_ == blockRowsFetched_)
+    {
+        if (!blockBound_ && !start_block_fetch())
+        {
+            // Fall back to fetching the rows one by one if block cursors
+            // can't be used with this driver or for these rows.
+            fetchBlockSize_ = 1;
+            return do_fetch_rows(1);
+        }
+
+        blockRowsFetched_ = 0;
+        blockPos_ = 0;
+
+        SQLRETURN rc = SQLFetch(hstmt_);
+
+        if (SQL_NO_DATA == rc)
+        {
+            return ef_no_data;
+        }
+
+        if (is_odbc_error(rc))
+        {
+            throw odbc_soci_error(SQL_HANDLE_STMT, hstmt_, "fetching data");
+        }
+
+        if (blockRowsFetched_ == 0)
+        {
+            return ef_no_data;
+        }
+    }
+
+    char const * const row = &blockBuf_[blockPos_++ * blockRowSize_];
+    for (std::size_t i = 0; i != standardIntos_.size(); ++i)
+    {
+        standardIntos_[i]->copy_from_block(row);
+    }
+
+    numRowsFetched_ = 1;
+
+    return ef_success;
+}
+
+bool odbc_statement_backend::start_block_fetch()
+{
+    // Each row of the block contains the values of all columns, each of them
+    // followed by its length.
+    std::size_t rowSize = 0;
+    for (std::size_t i = 0; i != standardIntos_.size(); ++i)
+    {
+        odbc_standard_into_type_backend * const into = standardIntos_[i];
+
+        into->blockValueOffset_ = rowSize;
+        rowSize += align_block_offset(static_cast<std::size_t>(into->bindSize_));
+
+        into->blockIndOffset_ = rowSize;
+        rowSize += align_block_offset(sizeof(SQLLEN));
+    }
+
+    std::size_t rows = fetchBlockSize_;
+    if (rows > odbc_max_block_buffer_length / rowSize)
+    {
+        rows = odbc_max_block_buffer_length / rowSize;
+        if (rows <= 1)
+        {
+            return false;
+        }
+    }
+
+    SQLRETURN rc = SQLSetStmtAttr(hstmt_, SQL_ATTR_ROW_BIND_TYPE,
+                                  (SQLPOINTER)rowSize, 0);
+    if (is_odbc_error(rc))
+    {
+        return false;
+    }
+
+    rc = SQLSetStmtAttr(hstmt_, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)rows, 0);
+    if (is_odbc_error(rc))
+    {
+        SQLSetStmtAttr(hstmt_, SQL_ATTR_ROW_BIND_TYPE, SQL_BIND_BY_COLUMN, 0);
+        return false;
+    }
+
+    SQLSetStmtAttr(hstmt_, SQL_ATTR_ROWS_FETCHED_PTR, &blockRowsFetched_, 0);
+
+    blockBuf_.resize(rows * rowSize);
+    blockRowSize_ = rowSize;
+
+    for (std::size_t i = 0; i != standardIntos_.size(); ++i)
+    {
+        odbc_standard_into_type_backend * const into = standardIntos_[i];
+
+        // The offsets are aligned, as is the buffer allocated on the heap.
+        GCC_WARNING_SUPPRESS(cast-align)
+
+        into->bind_column(&blockBuf_[into->blockValueOffset_],
+            reinterpret_cast<SQLLEN*>(&blockBuf_[into->blockIndOffset_]));
+
+        GCC_WARNING_RESTORE(cast-align)
+    }
+
+    blockBound_ = true;
+
+    return true;
+}
+
+void odbc_statement_backend::end_block_fetch()
+{
+    if (blockBound_)
+    {
+        for (std::size_t i = 0; i != standardIntos_.size(); ++i)
+        {
+            odbc_standard_into_type_backend * const into = standardIntos_[i];
+            into->bind_column(into->bindData_, &into->valueLen_);
+        }
+
+        SQLSetStmtAttr(hstmt_, SQL_ATTR_ROW_BIND_TYPE, SQL_BIND_BY_COLUMN, 0);
+
+        blockBound_ = false;
+    }
+
+    blockRowsFetched_ = 0;
+    blockPos_ = 0;
+}
+
+bool odbc_statement_backend::cancel()
+{
+    // SQLCancel() can be called from another thread to cancel the function
+    // currently executing on the statement handle, which then fails with
+    // SQLSTATE HY008.
+    return !is_odbc_error(SQLCancel(hstmt_));
+}
+
 long long odbc_statement_backend::get_affected_rows()
 {
     return rowsAffected_;
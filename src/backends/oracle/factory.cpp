@@ -105,12 +105,28 @@ int charset_code(const std::string & name)
     return code;
 }
 
+// parse the value of an option specifying a non-negative number
+ub4 parse_count(std::string const & key, std::string const & value)
+{
+    std::istringstream ss(value);
+
+    ub4 count;
+    ss >> count;
+    if (!ss || !ss.eof() || value.empty() || value[0] == '-')
+    {
+        throw soci_error("Invalid value \"" + value + "\" of \"" + key + "\".");
+    }
+
+    return count;
+}
+
 // retrieves service name, user name and password from the
 // uniform connect string
 void chop_connect_string(std::string const & connectString,
     std::string & serviceName, std::string & userName,
     std::string & password, int & mode, bool & decimals_as_strings,
-    int & charset, int & ncharset)
+    int & charset, int & ncharset, ub4 & prefetch_rows,
+    ub4 & prefetch_memory, ub4 & stmt_cache_size)
 {
     serviceName.clear();
     userName.clear();
@@ -119,6 +135,9 @@ void chop_connect_string(std::string const & connectString,
     decimals_as_strings = false;
     charset = 0;
     ncharset = 0;
+    prefetch_rows = 0;
+    prefetch_memory = 0;
+    stmt_cache_size = 0;
 
     std::string key, value;
     std::string::const_iterator i = connectString.begin();
@@ -168,6 +187,18 @@ void chop_connect_string(std::string const & connectString,
         {
             ncharset = charset_code(value);
         }
+        else if (key == "prefetch_rows")
+        {
+            prefetch_rows = parse_count(key, value);
+        }
+        else if (key == "prefetch_memory")
+        {
+            prefetch_memory = parse_count(key, value);
+        }
+        else if (key == "stmt_cache_size")
+        {
+            stmt_cache_size = parse_count(key, value);
+        }
     }
 }
 
@@ -180,12 +211,17 @@ oracle_session_backend * oracle_backend_factory::make_session(
     bool decimals_as_strings;
     int charset;
     int ncharset;
+    ub4 prefetch_rows;
+    ub4 prefetch_memory;
+    ub4 stmt_cache_size;
 
     chop_connect_string(parameters.get_connect_string(), serviceName, userName, password,
-        mode, decimals_as_strings, charset, ncharset);
+        mode, decimals_as_strings, charset, ncharset,
+        prefetch_rows, prefetch_memory, stmt_cache_size);
 
     return new oracle_session_backend(serviceName, userName, password,
-        mode, decimals_as_strings, charset, ncharset);
+        mode, decimals_as_strings, charset, ncharset,
+        prefetch_rows, prefetch_memory, stmt_cache_size);
 }
 
 oracle_backend_factory const soci::oracle;
@@ -124,9 +124,13 @@ sb4 fo_callback(void * /* svchp */, void * /* envhp */, void * fo_ctx,
 
 oracle_session_backend::oracle_session_backend(std::string const & serviceName,
     std::string const & userName, std::string const & password, int mode,
-    bool decimals_as_strings, int charset, int ncharset)
-    : envhp_(NULL), srvhp_(NULL), errhp_(NULL), svchp_(NULL), usrhp_(NULL),
-      decimals_as_strings_(decimals_as_strings)
+    bool decimals_as_strings, int charset, int ncharset,
+    ub4 prefetch_rows, ub4 prefetch_memory, ub4 stmt_cache_size)
+    : envhp_(NULL), srvhp_(NULL), errhp_(NULL), breakErrhp_(NULL),
+      svchp_(NULL), usrhp_(NULL),
+      decimals_as_strings_(decimals_as_strings),
+      prefetchRows_(prefetch_rows), prefetchMemory_(prefetch_memory),
+      stmtCacheSize_(stmt_cache_size)
 {
     // assume service/user/password are utf8-compatible already
     const int defaultSourceCharSetId = 871;
@@ -176,6 +180,16 @@ oracle_session_backend::oracle_session_backend(std::string const & serviceName,
         throw soci_error("Cannot create error handle");
     }
 
+    // and another one for cancelling the queries, as the main one can't be
+    // used concurrently with the thread executing them
+    res = OCIHandleAlloc(envhp_, reinterpret_cast<dvoid**>(&breakErrhp_),
+        OCI_HTYPE_ERROR, 0, 0);
+    if (res != OCI_SUCCESS)
+    {
+        clean_up();
+        throw soci_error("Cannot create error handle");
+    }
+
     if (charset != 0)
     {
         // convert service/user/password to the expected charset
@@ -364,6 +378,22 @@ oracle_session_backend::oracle_session_backend(std::string const & serviceName,
         clean_up();
         throw oracle_soci_error(msg, errNum);
     }
+
+    // enable the client-side statement cache if requested, the statements
+    // are then prepared using OCIStmtPrepare2() which looks them up in it
+    if (stmtCacheSize_ != 0)
+    {
+        res = OCIAttrSet(svchp_, OCI_HTYPE_SVCCTX, &stmtCacheSize_,
+            0, OCI_ATTR_STMTCACHESIZE, errhp_);
+        if (res != OCI_SUCCESS)
+        {
+            std::string msg;
+            int errNum;
+            get_error_details(res, errhp_, msg, errNum);
+            clean_up();
+            throw oracle_soci_error(msg, errNum);
+        }
+    }
 }
 
 oracle_session_backend::~oracle_session_backend()
@@ -420,6 +450,7 @@ void oracle_session_backend::clean_up()
         OCIServerDetach(srvhp_, errhp_, OCI_DEFAULT);
         OCIHandleFree(srvhp_, OCI_HTYPE_SERVER);
     }
+    if (breakErrhp_) { OCIHandleFree(breakErrhp_, OCI_HTYPE_ERROR); }
     if (errhp_) { OCIHandleFree(errhp_, OCI_HTYPE_ERROR); }
     if (envhp_) { OCIHandleFree(envhp_, OCI_HTYPE_ENV);   }
 }
@@ -26,8 +26,9 @@ using namespace soci::details;
 using namespace soci::details::oracle;
 
 oracle_statement_backend::oracle_statement_backend(oracle_session_backend &session)
-    : session_(session), stmtp_(NULL), boundByName_(false), boundByPos_(false),
-      noData_(false)
+    : session_(session), stmtp_(NULL), stmtFromCache_(false),
+      boundByName_(false), boundByPos_(false), noData_(false),
+      executedForDescribe_(false)
 {
 }
 
@@ -44,33 +45,98 @@ void oracle_statement_backend::alloc()
 
 void oracle_statement_backend::clean_up()
 {
-    // deallocate statement handle
+    // deallocate statement handle or return it to the cache
     if (stmtp_ != NULL)
     {
-        OCIHandleFree(stmtp_, OCI_HTYPE_STMT);
+        if (stmtFromCache_)
+        {
+            OCIStmtRelease(stmtp_, session_.errhp_, NULL, 0, OCI_DEFAULT);
+            stmtFromCache_ = false;
+        }
+        else
+        {
+            OCIHandleFree(stmtp_, OCI_HTYPE_STMT);
+        }
         stmtp_ = NULL;
     }
 
     boundByName_ = false;
     boundByPos_ = false;
+    executedForDescribe_ = false;
 }
 
 void oracle_statement_backend::prepare(std::string const &query,
     statement_type /* eType */)
 {
+    executedForDescribe_ = false;
+
     sb4 stmtLen = static_cast<sb4>(query.size());
-    sword res = OCIStmtPrepare(stmtp_,
-        session_.errhp_,
-        reinterpret_cast<text*>(const_cast<char*>(query.c_str())),
-        stmtLen, OCI_V7_SYNTAX, OCI_DEFAULT);
-    if (res != OCI_SUCCESS)
+    sword res;
+    if (session_.stmtCacheSize_ != 0)
     {
-        throw_oracle_soci_error(res, session_.errhp_);
+        // OCIStmtPrepare2() returns its own handle, either a new one or the
+        // one found in the cache, so release the one we may already have.
+        clean_up();
+
+        res = OCIStmtPrepare2(session_.svchp_, &stmtp_,
+            session_.errhp_,
+            reinterpret_cast<text*>(const_cast<char*>(query.c_str())),
+            static_cast<ub4>(stmtLen), NULL, 0, OCI_NTV_SYNTAX, OCI_DEFAULT);
+        if (res != OCI_SUCCESS && res != OCI_SUCCESS_WITH_INFO)
+        {
+            stmtp_ = NULL;
+            throw_oracle_soci_error(res, session_.errhp_);
+        }
+
+        stmtFromCache_ = true;
+    }
+    else
+    {
+        res = OCIStmtPrepare(stmtp_,
+            session_.errhp_,
+            reinterpret_cast<text*>(const_cast<char*>(query.c_str())),
+            stmtLen, OCI_V7_SYNTAX, OCI_DEFAULT);
+        if (res != OCI_SUCCESS)
+        {
+            throw_oracle_soci_error(res, session_.errhp_);
+        }
+    }
+
+    // Prefetching is only done when explicitly requested, otherwise the OCI
+    // default of prefetching a single row is used.
+    if (session_.prefetchRows_ != 0)
+    {
+        res = OCIAttrSet(stmtp_, OCI_HTYPE_STMT, &session_.prefetchRows_,
+            0, OCI_ATTR_PREFETCH_ROWS, session_.errhp_);
+        if (res != OCI_SUCCESS)
+        {
+            throw_oracle_soci_error(res, session_.errhp_);
+        }
+    }
+
+    if (session_.prefetchMemory_ != 0)
+    {
+        res = OCIAttrSet(stmtp_, OCI_HTYPE_STMT, &session_.prefetchMemory_,
+            0, OCI_ATTR_PREFETCH_MEMORY, session_.errhp_);
+        if (res != OCI_SUCCESS)
+        {
+            throw_oracle_soci_error(res, session_.errhp_);
+        }
     }
 }
 
 statement_backend::exec_fetch_result oracle_statement_backend::execute(int number)
 {
+    if (executedForDescribe_)
+    {
+        // Executing the statement with the given number of iterations would
+        // just fetch this number of rows, so do only this.
+        executedForDescribe_ = false;
+        noData_ = false;
+
+        return number == 0 ? ef_success : fetch(number);
+    }
+
     sword res = OCIStmtExecute(session_.svchp_, stmtp_, session_.errhp_,
         static_cast<ub4>(number), 0, 0, 0, OCI_DEFAULT);
 
@@ -117,6 +183,15 @@ statement_backend::exec_fetch_result oracle_statement_backend::fetch(int number)
     }
 }
 
+bool oracle_statement_backend::cancel()
+{
+    // The call currently executed using the service context fails with
+    // ORA-01013 when it is interrupted.
+    sword const res = OCIBreak(session_.svchp_, session_.breakErrhp_);
+
+    return res == OCI_SUCCESS || res == OCI_SUCCESS_WITH_INFO;
+}
+
 long long oracle_statement_backend::get_affected_rows()
 {
     ub4 row_count;
@@ -164,13 +239,40 @@ std::string oracle_statement_backend::rewrite_for_procedure_call(
 
 int oracle_statement_backend::prepare_for_describe()
 {
-    sword res = OCIStmtExecute(session_.svchp_, stmtp_, session_.errhp_,
-        1, 0, 0, 0, OCI_DESCRIBE_ONLY);
+    ub2 stmtType;
+    sword res = OCIAttrGet(static_cast<dvoid*>(stmtp_),
+        static_cast<ub4>(OCI_HTYPE_STMT), static_cast<dvoid*>(&stmtType),
+        0, static_cast<ub4>(OCI_ATTR_STMT_TYPE), session_.errhp_);
     if (res != OCI_SUCCESS)
     {
         throw_oracle_soci_error(res, session_.errhp_);
     }
 
+    if (stmtType == OCI_STMT_SELECT)
+    {
+        // Executing a query without fetching any rows describes it too and,
+        // unlike OCI_DESCRIBE_ONLY, avoids another round trip to the server
+        // for executing it later: the columns are defined after executing it
+        // and execute() only needs to fetch the rows.
+        res = OCIStmtExecute(session_.svchp_, stmtp_, session_.errhp_,
+            0, 0, 0, 0, OCI_DEFAULT);
+        if (res != OCI_SUCCESS && res != OCI_SUCCESS_WITH_INFO)
+        {
+            throw_oracle_soci_error(res, session_.errhp_);
+        }
+
+        executedForDescribe_ = true;
+    }
+    else
+    {
+        res = OCIStmtExecute(session_.svchp_, stmtp_, session_.errhp_,
+            1, 0, 0, 0, OCI_DESCRIBE_ONLY);
+        if (res != OCI_SUCCESS)
+        {
+            throw_oracle_soci_error(res, session_.errhp_);
+        }
+    }
+
     int cols;
     res = OCIAttrGet(static_cast<dvoid*>(stmtp_),
         static_cast<ub4>(OCI_HTYPE_STMT), static_cast<dvoid*>(&cols),
@@ -0,0 +1,420 @@
+//
+// Copyright (C) 2004-2008 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define SOCI_POSTGRESQL_SOURCE
+#include "soci/soci-platform.h"
+#include "soci/postgresql/soci-postgresql.h"
+#include "soci/noreturn.h"
+#include "soci-exchange-cast.h"
+#include "soci-mktime.h"
+#include "common.h"
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <limits>
+
+using namespace soci;
+using namespace soci::details;
+using namespace soci::details::postgresql;
+
+namespace // unnamed
+{
+
+// OIDs of the types which can be exchanged in binary format, from pg_type.
+enum
+{
+    oid_bool        = 16,
+    oid_char        = 18,
+    oid_name        = 19,
+    oid_int8        = 20,
+    oid_int2        = 21,
+    oid_int4        = 23,
+    oid_text        = 25,
+    oid_oid         = 26,
+    oid_json        = 114,
+    oid_float4      = 700,
+    oid_float8      = 701,
+    oid_bpchar      = 1042,
+    oid_varchar     = 1043,
+    oid_date        = 1082,
+    oid_timestamp   = 1114
+};
+
+// Offset of the PostgreSQL epoch (2000-01-01) from the Unix one, in seconds.
+long long const pg_epoch_offset = 946684800LL;
+
+long long const seconds_per_day = 86400LL;
+
+long long const microseconds_per_second = 1000000LL;
+
+// Values are always transmitted in network byte order.
+unsigned long long read_big_endian(char const * buf, int len)
+{
+    unsigned long long value = 0;
+    for (int i = 0; i != len; ++i)
+    {
+        value = (value << 8) | static_cast<unsigned char>(buf[i]);
+    }
+
+    return value;
+}
+
+void write_big_endian(unsigned long long value, int len, char * buf)
+{
+    for (int i = len; i != 0; --i)
+    {
+        buf[i - 1] = static_cast<char>(value & 0xff);
+        value >>= 8;
+    }
+}
+
+// Divide rounding towards negative infinity, as needed for the dates before
+// the PostgreSQL epoch.
+long long floor_div(long long a, long long b)
+{
+    long long q = a / b;
+    if ((a % b != 0) && ((a < 0) != (b < 0)))
+    {
+        --q;
+    }
+
+    return q;
+}
+
+long long std_tm_to_pg_seconds(std::tm const & t)
+{
+    std::tm tmp = t;
+    return static_cast<long long>(timegm(&tmp)) - pg_epoch_offset;
+}
+
+double read_float8(char const * buf)
+{
+    unsigned long long const bits = read_big_endian(buf, 8);
+
+    double d;
+    std::memcpy(&d, &bits, sizeof(d));
+    return d;
+}
+
+float read_float4(char const * buf)
+{
+    unsigned int const bits = static_cast<unsigned int>(read_big_endian(buf, 4));
+
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+SOCI_NORETURN throw_cannot_convert()
+{
+    throw soci_error("Cannot convert data.");
+}
+
+} // unnamed namespace
+
+bool postgresql::is_binary_result_type(Oid type, bool integerDatetimes)
+{
+    switch (type)
+    {
+    case oid_bool:
+    case oid_char:
+    case oid_name:
+    case oid_int8:
+    case oid_int2:
+    case oid_int4:
+    case oid_text:
+    case oid_oid:
+    case oid_json:
+    case oid_float4:
+    case oid_float8:
+    case oid_bpchar:
+    case oid_varchar:
+    case oid_date:
+        return true;
+
+    case oid_timestamp:
+        // With the legacy floating point timestamps the binary format is
+        // different and we don't bother supporting it.
+        return integerDatetimes;
+    }
+
+    // Notice that bytea is not included here because its text representation
+    // depends on the bytea_output server setting.
+    return false;
+}
+
+bool postgresql::is_text_type(Oid type)
+{
+    switch (type)
+    {
+    case oid_char:
+    case oid_name:
+    case oid_text:
+    case oid_json:
+    case oid_bpchar:
+    case oid_varchar:
+        return true;
+    }
+
+    return false;
+}
+
+long long postgresql::binary_to_long_long(char const * buf, Oid type)
+{
+    switch (type)
+    {
+    case oid_bool:
+        return buf[0] != 0 ? 1 : 0;
+
+    case oid_int2:
+        return static_cast<short>(read_big_endian(buf, 2));
+
+    case oid_int4:
+        return static_cast<int>(read_big_endian(buf, 4));
+
+    case oid_oid:
+        return static_cast<long long>(read_big_endian(buf, 4));
+
+    case oid_int8:
+        return static_cast<long long>(read_big_endian(buf, 8));
+    }
+
+    throw_cannot_convert();
+}
+
+double postgresql::binary_to_double(char const * buf, Oid type)
+{
+    switch (type)
+    {
+    case oid_float4:
+        return read_float4(buf);
+
+    case oid_float8:
+        return read_float8(buf);
+    }
+
+    return static_cast<double>(binary_to_long_long(buf, type));
+}
+
+void postgresql::binary_to_std_tm(char const * buf, Oid type, std::tm & t)
+{
+    long long days;
+    long long secondsOfDay = 0;
+
+    switch (type)
+    {
+    case oid_date:
+        {
+            int const value = static_cast<int>(read_big_endian(buf, 4));
+            if (value == std::numeric_limits<int>::max() ||
+                value == std::numeric_limits<int>::min())
+            {
+                // infinity or -infinity
+                throw_cannot_convert();
+            }
+
+            days = value;
+        }
+        break;
+
+    case oid_timestamp:
+        {
+            long long const value
+                = static_cast<long long>(read_big_endian(buf, 8));
+            if (value == std::numeric_limits<long long>::max() ||
+                value == std::numeric_limits<long long>::min())
+            {
+                throw_cannot_convert();
+            }
+
+            // Fractional seconds are ignored, as in parse_std_tm().
+            long long const seconds
+                = floor_div(value, microseconds_per_second);
+            days = floor_div(seconds, seconds_per_day);
+            secondsOfDay = seconds - days * seconds_per_day;
+        }
+        break;
+
+    default:
+        throw_cannot_convert();
+    }
+
+    // Let timegm() normalize the day of month to the real date.
+    mktime_from_ymdhms(t, 2000, 1, 1 + static_cast<int>(days),
+        static_cast<int>(secondsOfDay / 3600),
+        static_cast<int>(secondsOfDay % 3600 / 60),
+        static_cast<int>(secondsOfDay % 60));
+}
+
+bool postgresql::is_exact_string_type(Oid type)
+{
+    switch (type)
+    {
+    case oid_bool:
+    case oid_int8:
+    case oid_int2:
+    case oid_int4:
+    case oid_oid:
+        return true;
+    }
+
+    // The text representation of the floating point, date and timestamp
+    // values depends on the server settings (extra_float_digits, DateStyle)
+    // and can't be reproduced exactly from their binary values.
+    return is_text_type(type);
+}
+
+std::string postgresql::binary_to_string(char const * buf, int len, Oid type)
+{
+    if (is_text_type(type))
+    {
+        return std::string(buf, len);
+    }
+
+    if (!is_exact_string_type(type))
+    {
+        throw_cannot_convert();
+    }
+
+    // Produce the same representation as the text format would have used.
+    if (type == oid_bool)
+    {
+        return buf[0] != 0 ? "t" : "f";
+    }
+
+    char text[32];
+    snprintf(text, sizeof(text), "%" LL_FMT_FLAGS "d",
+        binary_to_long_long(buf, type));
+    return text;
+}
+
+int postgresql::integer_to_binary(long long value, Oid type, char * buf)
+{
+    switch (type)
+    {
+    case oid_bool:
+        buf[0] = value != 0 ? 1 : 0;
+        return 1;
+
+    case oid_int2:
+        if (value < std::numeric_limits<short>::min() ||
+            value > std::numeric_limits<short>::max())
+        {
+            // Let the server report the error for out of range values.
+            return 0;
+        }
+
+        write_big_endian(static_cast<unsigned long long>(value), 2, buf);
+        return 2;
+
+    case oid_int4:
+        if (value < std::numeric_limits<int>::min() ||
+            value > std::numeric_limits<int>::max())
+        {
+            return 0;
+        }
+
+        write_big_endian(static_cast<unsigned long long>(value), 4, buf);
+        return 4;
+
+    case oid_int8:
+        write_big_endian(static_cast<unsigned long long>(value), 8, buf);
+        return 8;
+    }
+
+    return 0;
+}
+
+int postgresql::double_to_binary(double value, Oid type, char * buf)
+{
+    if (type != oid_float8)
+    {
+        return 0;
+    }
+
+    unsigned long long bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    write_big_endian(bits, 8, buf);
+    return 8;
+}
+
+int postgresql::std_tm_to_binary(std::tm const & t, Oid type, char * buf,
+    bool integerDatetimes)
+{
+    long long const seconds = std_tm_to_pg_seconds(t);
+
+    switch (type)
+    {
+    case oid_date:
+        write_big_endian(static_cast<unsigned long long>(
+            floor_div(seconds, seconds_per_day)), 4, buf);
+        return 4;
+
+    case oid_timestamp:
+        if (!integerDatetimes)
+        {
+            return 0;
+        }
+
+        write_big_endian(static_cast<unsigned long long>(
+            seconds * microseconds_per_second), 8, buf);
+        return 8;
+    }
+
+    return 0;
+}
+
+void postgresql::binary_to_exchange_type(void * data, exchange_type type,
+    char const * buf, int len, Oid typeOid)
+{
+    switch (type)
+    {
+    case x_char:
+        {
+            std::string const s = binary_to_string(buf, len, typeOid);
+            exchange_type_cast<x_char>(data) = s.empty() ? '\0' : s[0];
+        }
+        break;
+    case x_stdstring:
+        exchange_type_cast<x_stdstring>(data)
+            = binary_to_string(buf, len, typeOid);
+        break;
+    case x_short:
+        exchange_type_cast<x_short>(data)
+            = binary_to_integer<short>(buf, typeOid);
+        break;
+    case x_integer:
+        exchange_type_cast<x_integer>(data)
+            = binary_to_integer<int>(buf, typeOid);
+        break;
+    case x_long_long:
+        exchange_type_cast<x_long_long>(data)
+            = binary_to_integer<long long>(buf, typeOid);
+        break;
+    case x_unsigned_long_long:
+        exchange_type_cast<x_unsigned_long_long>(data)
+            = binary_to_integer<unsigned long long>(buf, typeOid);
+        break;
+    case x_double:
+        exchange_type_cast<x_double>(data) = binary_to_double(buf, typeOid);
+        break;
+    case x_stdtm:
+        binary_to_std_tm(buf, typeOid, exchange_type_cast<x_stdtm>(data));
+        break;
+    case x_xmltype:
+        exchange_type_cast<x_xmltype>(data).value
+            = binary_to_string(buf, len, typeOid);
+        break;
+    case x_longstring:
+        exchange_type_cast<x_longstring>(data).value
+            = binary_to_string(buf, len, typeOid);
+        break;
+
+    default:
+        throw soci_error("Into element used with non-supported type.");
+    }
+}
@@ -0,0 +1,151 @@
+//
+// Copyright (C) 2004-2008 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define SOCI_POSTGRESQL_SOURCE
+#include "soci/postgresql/bulk-loader.h"
+#include "soci/session.h"
+#include <cctype>
+#include <vector>
+
+using namespace soci;
+using namespace soci::details;
+
+namespace // unnamed
+{
+
+// Build the COPY statement for the given table and columns.
+std::string make_copy_query(std::string const & table,
+    std::string const & columns)
+{
+    std::string query = "copy " + table;
+    if (!columns.empty())
+    {
+        query += "(" + columns + ")";
+    }
+
+    query += " from stdin";
+    return query;
+}
+
+// Return the names of the columns in the given comma-separated list, which
+// are also the names of the corresponding use elements bound by name. The
+// quotes around the quoted identifiers are removed.
+std::vector<std::string> get_column_names(std::string const & columns)
+{
+    std::vector<std::string> names;
+    if (columns.find_first_not_of(" \t\r\n") == std::string::npos)
+    {
+        return names;
+    }
+
+    std::string name;
+    bool quoted = false;
+    for (std::string::size_type n = 0; n != columns.size(); ++n)
+    {
+        char const c = columns[n];
+        if (c == '"')
+        {
+            // doubled quote inside a quoted identifier stands for a quote
+            if (quoted && n + 1 != columns.size() && columns[n + 1] == '"')
+            {
+                name += c;
+                ++n;
+            }
+            else
+            {
+                quoted = !quoted;
+            }
+        }
+        else if (quoted)
+        {
+            name += c;
+        }
+        else if (c == ',')
+        {
+            names.push_back(name);
+            name.clear();
+        }
+        else if (!std::isspace(static_cast<unsigned char>(c)))
+        {
+            // the list itself is validated by the server
+            name += c;
+        }
+    }
+
+    names.push_back(name);
+
+    return names;
+}
+
+} // unnamed namespace
+
+bulk_loader::bulk_loader(session & sql, std::string const & table,
+    std::string const & columns)
+    : st_(sql), query_(make_copy_query(table, columns)),
+      prepared_(false), started_(false)
+{
+    if (dynamic_cast<postgresql_statement_backend *>(st_.get_backend()) == NULL)
+    {
+        throw soci_error("Bulk loader is only supported by PostgreSQL.");
+    }
+
+    get_backend().set_copy_use_names(get_column_names(columns));
+}
+
+bulk_loader::~bulk_loader()
+{
+    if (started_)
+    {
+        try
+        {
+            get_backend().abort_copy();
+        }
+        catch (...)
+        {
+            // Don't allow exceptions to escape from dtor.
+        }
+    }
+}
+
+postgresql_statement_backend & bulk_loader::get_backend()
+{
+    return *static_cast<postgresql_statement_backend *>(st_.get_backend());
+}
+
+void bulk_loader::load()
+{
+    if (!prepared_)
+    {
+        st_.alloc();
+        st_.prepare(query_);
+        st_.define_and_bind();
+
+        prepared_ = true;
+    }
+
+    started_ = true;
+    st_.execute(true);
+}
+
+long long bulk_loader::finish()
+{
+    if (!prepared_)
+    {
+        // Nothing was loaded at all, still execute the statement to check
+        // that it is valid.
+        st_.alloc();
+        st_.prepare(query_);
+        st_.define_and_bind();
+
+        prepared_ = true;
+        started_ = true;
+        st_.execute(false);
+    }
+
+    started_ = false;
+    return get_backend().end_copy();
+}
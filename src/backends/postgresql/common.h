@@ -13,6 +13,8 @@
 #include <cstdio>
 #include <cstring>
 #include <ctime>
+#include <limits>
+#include <string>
 #include <vector>
 
 namespace soci
@@ -67,6 +69,53 @@ T string_to_unsigned_integer(char const * buf)
     return result;
 }
 
+// Helpers for the values exchanged in binary format, see binary.cpp.
+
+// Check whether the values of this type can be retrieved in binary format.
+bool is_binary_result_type(Oid type, bool integerDatetimes);
+
+// Check whether the binary format of this type is the same as the text one,
+// so that its values can be handled exactly as in the text mode.
+bool is_text_type(Oid type);
+
+// Check whether a value of this type retrieved in binary format can be
+// converted to exactly the same string as would be retrieved in text format.
+bool is_exact_string_type(Oid type);
+
+// Functions converting a value retrieved in binary format to the given type,
+// they throw if the conversion is not possible.
+long long binary_to_long_long(char const * buf, Oid type);
+double binary_to_double(char const * buf, Oid type);
+void binary_to_std_tm(char const * buf, Oid type, std::tm & t);
+std::string binary_to_string(char const * buf, int len, Oid type);
+
+// Convert a value retrieved in binary format to the user-provided data of the
+// given exchange type, only the types without backend objects are supported.
+void binary_to_exchange_type(void * data, exchange_type type,
+    char const * buf, int len, Oid typeOid);
+
+template <typename T>
+T binary_to_integer(char const * buf, Oid type)
+{
+    long long const value = binary_to_long_long(buf, type);
+    if (value < static_cast<long long>(std::numeric_limits<T>::min()) ||
+        (value > 0 && static_cast<unsigned long long>(value) >
+            static_cast<unsigned long long>(std::numeric_limits<T>::max())))
+    {
+        throw soci_error("Cannot convert data.");
+    }
+
+    return static_cast<T>(value);
+}
+
+// Functions encoding a value in binary format suitable for a parameter of the
+// given type into the buffer of at least 8 bytes. They return the length of
+// the binary value or 0 if the value must be sent in text format instead.
+int integer_to_binary(long long value, Oid type, char * buf);
+int double_to_binary(double value, Oid type, char * buf);
+int std_tm_to_binary(std::tm const & t, Oid type, char * buf,
+    bool integerDatetimes);
+
 // helper for vector operations
 template <typename T>
 std::size_t get_vector_size(void * p)
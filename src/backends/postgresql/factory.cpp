@@ -10,6 +10,7 @@
 #include "soci/connection-parameters.h"
 #include "soci/backend-loader.h"
 #include <libpq/libpq-fs.h> // libpq
+#include <cstdio>
 
 #ifdef _MSC_VER
 #pragma warning(disable:4355)
@@ -71,11 +72,15 @@ std::string::const_iterator get_key_value(std::string::const_iterator & i,
 // retrieves specific parameters from the
 // uniform connect string
 std::string chop_connect_string(std::string const & connectString,
-    bool & single_row_mode)
+    bool & single_row_mode, bool & pipeline_mode, bool & binary_mode,
+    int & fetch_size)
 {
     std::string pruned_conn_string;
 
     single_row_mode = false;
+    pipeline_mode = false;
+    binary_mode = false;
+    fetch_size = 0;
 
     std::string key, value;
     std::string::const_iterator i = connectString.begin();
@@ -86,6 +91,25 @@ std::string chop_connect_string(std::string const & connectString,
         {
             single_row_mode = (value == "true" || value == "yes");
         }
+        else if (key == "pipeline")
+        {
+            pipeline_mode = (value == "true" || value == "yes");
+        }
+        else if (key == "binary")
+        {
+            binary_mode = (value == "true" || value == "yes");
+        }
+        else if (key == "fetchsize")
+        {
+            unsigned size = 0;
+            if (std::sscanf(value.c_str(), "%u", &size) != 1 || size == 0)
+            {
+                throw soci_error("Invalid fetch size option value \"" +
+                                 value + "\".");
+            }
+
+            fetch_size = static_cast<int>(size);
+        }
         else
         {
             if (pruned_conn_string.empty() == false)
@@ -107,14 +131,19 @@ postgresql_session_backend * postgresql_backend_factory::make_session(
      connection_parameters const & parameters) const
 {
     bool single_row_mode;
+    bool pipeline_mode;
+    bool binary_mode;
+    int fetch_size;
 
     const std::string pruned_conn_string =
-        chop_connect_string(parameters.get_connect_string(), single_row_mode);
+        chop_connect_string(parameters.get_connect_string(),
+            single_row_mode, pipeline_mode, binary_mode, fetch_size);
 
     connection_parameters pruned_parameters(parameters);
     pruned_parameters.set_connect_string(pruned_conn_string);
 
-    return new postgresql_session_backend(pruned_parameters, single_row_mode);
+    return new postgresql_session_backend(pruned_parameters,
+        single_row_mode, pipeline_mode, binary_mode, fetch_size);
 }
 
 postgresql_backend_factory const soci::postgresql;
@@ -32,10 +32,26 @@ void hard_exec(postgresql_session_backend & session_backend,
 } // namespace unnamed
 
 postgresql_session_backend::postgresql_session_backend(
-    connection_parameters const& parameters, bool single_row_mode)
+    connection_parameters const& parameters, bool single_row_mode,
+    bool pipeline_mode, bool binary_mode, int fetch_size)
     : statementCount_(0), conn_(0)
 {
+#ifndef LIBPQ_HAS_PIPELINING
+    if (pipeline_mode)
+    {
+        throw soci_error("Pipeline mode requires libpq 14 or later");
+    }
+#endif // !LIBPQ_HAS_PIPELINING
+
+    if (single_row_mode && fetch_size > 0)
+    {
+        throw soci_error("Single-row mode can't be used with fetch size");
+    }
+
     single_row_mode_ = single_row_mode;
+    pipeline_mode_ = pipeline_mode;
+    binary_mode_ = binary_mode;
+    fetch_size_ = fetch_size;
 
     connect(parameters);
 }
@@ -67,6 +83,13 @@ void postgresql_session_backend::connect(
                          : "SET extra_float_digits = 2",
         "Cannot set extra_float_digits parameter");
 
+    // Binary format of timestamps depends on this compile-time server option,
+    // which is always on since PostgreSQL 10.
+    char const * const integerDatetimes
+        = PQparameterStatus(conn, "integer_datetimes");
+    integerDatetimes_ = integerDatetimes != NULL &&
+        std::strcmp(integerDatetimes, "on") == 0;
+
     conn_ = conn;
     connectionParameters_ = parameters;
 }
@@ -34,6 +34,8 @@ void postgresql_standard_into_type_backend::define_by_pos(
     data_ = data;
     type_ = type;
     position_ = position++;
+
+    statement_.check_binary_result_column(position_, type_);
 }
 
 void postgresql_standard_into_type_backend::pre_fetch()
@@ -78,10 +80,24 @@ void postgresql_standard_into_type_backend::post_fetch(
             }
         }
 
-        // raw data, in text format
+        // raw data, in text format unless binary mode is used
         char const * buf = PQgetvalue(statement_.result_,
             statement_.currentRow_, pos);
 
+        // in binary mode, the binary format of the text types is the same as
+        // their text format, but all the other ones need to be decoded
+        Oid const typeOid = PQftype(statement_.result_, pos);
+        bool const binary = PQfformat(statement_.result_, pos) != 0 &&
+            !is_text_type(typeOid);
+
+        if (binary && type_ != x_rowid && type_ != x_blob)
+        {
+            binary_to_exchange_type(data_, type_, buf,
+                PQgetlength(statement_.result_, statement_.currentRow_, pos),
+                typeOid);
+            return;
+        }
+
         switch (type_)
         {
         case x_char:
@@ -118,13 +134,16 @@ void postgresql_standard_into_type_backend::post_fetch(
                     = static_cast<postgresql_rowid_backend *>(
                         rid->get_backend());
 
-                rbe->value_ = string_to_unsigned_integer<unsigned long>(buf);
+                rbe->value_ = binary
+                    ? binary_to_integer<unsigned long>(buf, typeOid)
+                    : string_to_unsigned_integer<unsigned long>(buf);
             }
             break;
         case x_blob:
             {
-                unsigned long oid =
-                    string_to_unsigned_integer<unsigned long>(buf);
+                unsigned long oid = binary
+                    ? binary_to_integer<unsigned long>(buf, typeOid)
+                    : string_to_unsigned_integer<unsigned long>(buf);
 
                 int fd = lo_open(statement_.session_.conn_, oid,
                     INV_READ | INV_WRITE);
@@ -13,6 +13,7 @@
 #include "soci/soci-platform.h"
 #include "soci-dtocstr.h"
 #include "soci-exchange-cast.h"
+#include "common.h"
 #include <libpq/libpq-fs.h> // libpq
 #include <cctype>
 #include <cstdio>
@@ -23,6 +24,7 @@
 
 using namespace soci;
 using namespace soci::details;
+using namespace soci::details::postgresql;
 
 void postgresql_standard_use_type_backend::bind_by_pos(
     int & position, void * data, exchange_type type, bool /* readOnly */)
@@ -48,10 +50,16 @@ void postgresql_standard_use_type_backend::bind_by_name(
 
 void postgresql_standard_use_type_backend::pre_use(indicator const * ind)
 {
+    binaryBuf_ = NULL;
+
     if (ind != NULL && *ind == i_null)
     {
         // leave the working buffer as NULL
     }
+    else if (prepare_binary())
+    {
+        // the value will be sent in binary format, nothing else to do
+    }
     else
     {
         // allocate and fill the buffer with text-formatted client data
@@ -157,18 +165,95 @@ void postgresql_standard_use_type_backend::pre_use(indicator const * ind)
         }
     }
 
+    char ** const buffer = binaryBuf_ != NULL ? &binaryBuf_ : &buf_;
+
     if (position_ > 0)
     {
         // binding by position
-        statement_.useByPosBuffers_[position_] = &buf_;
+        statement_.useByPosBuffers_[position_] = buffer;
+
+        if (binaryBuf_ != NULL)
+        {
+            statement_.useByPosBinaryLengths_[position_] = &binaryLength_;
+        }
+        else
+        {
+            statement_.useByPosBinaryLengths_.erase(position_);
+        }
     }
     else
     {
         // binding by name
-        statement_.useByNameBuffers_[name_] = &buf_;
+        statement_.useByNameBuffers_[name_] = buffer;
+
+        if (binaryBuf_ != NULL)
+        {
+            statement_.useByNameBinaryLengths_[name_] = &binaryLength_;
+        }
+        else
+        {
+            statement_.useByNameBinaryLengths_.erase(name_);
+        }
     }
 }
 
+bool postgresql_standard_use_type_backend::prepare_binary()
+{
+    Oid const paramType = statement_.get_binary_param_type(position_, name_);
+    if (paramType == 0)
+    {
+        return false;
+    }
+
+    switch (type_)
+    {
+    case x_short:
+        binaryLength_ = integer_to_binary(
+            exchange_type_cast<x_short>(data_), paramType, binaryValue_);
+        break;
+    case x_integer:
+        binaryLength_ = integer_to_binary(
+            exchange_type_cast<x_integer>(data_), paramType, binaryValue_);
+        break;
+    case x_long_long:
+        binaryLength_ = integer_to_binary(
+            exchange_type_cast<x_long_long>(data_), paramType, binaryValue_);
+        break;
+    case x_unsigned_long_long:
+        {
+            unsigned long long const value
+                = exchange_type_cast<x_unsigned_long_long>(data_);
+            binaryLength_ = value <= static_cast<unsigned long long>(
+                    std::numeric_limits<long long>::max())
+                ? integer_to_binary(static_cast<long long>(value),
+                    paramType, binaryValue_)
+                : 0;
+        }
+        break;
+    case x_double:
+        binaryLength_ = double_to_binary(
+            exchange_type_cast<x_double>(data_), paramType, binaryValue_);
+        break;
+    case x_stdtm:
+        binaryLength_ = std_tm_to_binary(exchange_type_cast<x_stdtm>(data_),
+            paramType, binaryValue_, statement_.session_.integerDatetimes_);
+        break;
+
+    default:
+        // all the other types are always sent in text format
+        binaryLength_ = 0;
+        break;
+    }
+
+    if (binaryLength_ == 0)
+    {
+        return false;
+    }
+
+    binaryBuf_ = binaryValue_;
+    return true;
+}
+
 void postgresql_standard_use_type_backend::post_use(
     bool /* gotData */, indicator * /* ind */)
 {
@@ -8,7 +8,12 @@
 #define SOCI_POSTGRESQL_SOURCE
 #include "soci/postgresql/soci-postgresql.h"
 #include "soci/soci-platform.h"
+#include "soci/column-batch.h"
+#include "soci-cstrtod.h"
+#include "soci-mktime.h"
+#include "common.h"
 #include <libpq/libpq-fs.h> // libpq
+#include <algorithm>
 #include <cctype>
 #include <cstdio>
 #include <cstdlib>
@@ -18,6 +23,7 @@
 
 using namespace soci;
 using namespace soci::details;
+using namespace soci::details::postgresql;
 
 namespace // unnamed
 {
@@ -40,6 +46,7 @@ void wait_until_operation_complete(postgresql_session_backend & session)
         }
     }
 }
+#endif // !SOCI_POSTGRESQL_NOSINGLEROWMODE
 
 void throw_soci_error(PGconn * conn, const char * msg)
 {
@@ -49,7 +56,82 @@ void throw_soci_error(PGconn * conn, const char * msg)
 
     throw soci_error(description);
 }
-#endif // !SOCI_POSTGRESQL_NOSINGLEROWMODE
+
+// Check whether the query is a "COPY ... FROM STDIN" statement.
+bool is_copy_from_stdin(std::string const & query)
+{
+    std::string lower;
+    lower.reserve(query.size());
+    for (std::string::const_iterator it = query.begin(); it != query.end(); ++it)
+    {
+        lower += static_cast<char>(std::tolower(static_cast<unsigned char>(*it)));
+    }
+
+    std::string::size_type const start = lower.find_first_not_of(" \t\r\n");
+    if (start == std::string::npos || lower.compare(start, 4, "copy") != 0)
+    {
+        return false;
+    }
+
+    return lower.find("from stdin", start) != std::string::npos;
+}
+
+// Check whether the query can be used in DECLARE CURSOR, i.e. whether it is a
+// SELECT, VALUES or TABLE statement.
+bool is_cursor_query(std::string const & query)
+{
+    std::string::size_type const start = query.find_first_not_of(" \t\r\n(");
+    if (start == std::string::npos)
+    {
+        return false;
+    }
+
+    std::string keyword;
+    for (std::string::size_type i = start; i != query.size(); ++i)
+    {
+        unsigned char const c = static_cast<unsigned char>(query[i]);
+        if (!std::isalpha(c))
+        {
+            break;
+        }
+
+        keyword += static_cast<char>(std::tolower(c));
+    }
+
+    return keyword == "select" || keyword == "values" || keyword == "table";
+}
+
+// Append the value to the data sent to the server using the COPY text format.
+void append_copy_value(std::string & data, char const * value)
+{
+    if (value == NULL)
+    {
+        data += "\\N";
+        return;
+    }
+
+    for (char const * p = value; *p != '\0'; ++p)
+    {
+        switch (*p)
+        {
+        case '\\':
+            data += "\\\\";
+            break;
+        case '\t':
+            data += "\\t";
+            break;
+        case '\n':
+            data += "\\n";
+            break;
+        case '\r':
+            data += "\\r";
+            break;
+        default:
+            data += *p;
+            break;
+        }
+    }
+}
 
 } // unnamed namespace
 
@@ -59,7 +141,9 @@ postgresql_statement_backend::postgresql_statement_backend(
       result_(session, NULL),
       rowsAffectedBulk_(-1LL), justDescribed_(false),
       hasIntoElements_(false), hasVectorIntoElements_(false),
-      hasUseElements_(false), hasVectorUseElements_(false)
+      hasUseElements_(false), hasVectorUseElements_(false),
+      binaryResults_(false), copyIn_(false), copyInProgress_(false),
+      cursorQuery_(false), cursorHoldable_(false), columnBatch_(NULL)
 {
 #ifdef SOCI_POSTGRESQL_NOSINGLEROWMODE
   if (single_row_mode)
@@ -71,6 +155,30 @@ postgresql_statement_backend::postgresql_statement_backend(
 
 postgresql_statement_backend::~postgresql_statement_backend()
 {
+    if (copyInProgress_)
+    {
+        try
+        {
+            abort_copy();
+        }
+        catch (...)
+        {
+            // Don't allow exceptions to escape from dtor, see below.
+        }
+    }
+
+    if (cursorName_.empty() == false)
+    {
+        try
+        {
+            close_cursor(false);
+        }
+        catch (...)
+        {
+            // Don't allow exceptions to escape from dtor, see below.
+        }
+    }
+
     if (statementName_.empty() == false)
     {
         try
@@ -101,124 +209,83 @@ void postgresql_statement_backend::clean_up()
     // nothing to do here
 }
 
+bool postgresql_statement_backend::reset_for_reuse()
+{
+    // The rows still to be sent by an unfinished COPY can't be discarded
+    // without ending it, so such statements are never reused.
+    if (copyInProgress_)
+    {
+        return false;
+    }
+
+    if (cursorName_.empty() == false)
+    {
+        try
+        {
+            close_cursor(false);
+        }
+        catch (soci_error const &)
+        {
+            return false;
+        }
+    }
+
+    result_.reset();
+    rowsAffectedBulk_ = -1;
+    justDescribed_ = false;
+
+    // All these are filled again when the new into and use elements are
+    // created and bound, while the prepared statement itself is kept.
+    hasIntoElements_ = false;
+    hasVectorIntoElements_ = false;
+    hasUseElements_ = false;
+    hasVectorUseElements_ = false;
+    columnBatch_ = NULL;
+
+    useByPosBuffers_.clear();
+    useByNameBuffers_.clear();
+    useByPosBinaryLengths_.clear();
+    useByNameBinaryLengths_.clear();
+
+    // The new into elements may allow using binary format again.
+    binaryResults_ = can_use_binary_results();
+
+    return true;
+}
+
 void postgresql_statement_backend::prepare(std::string const & query,
     statement_type stType)
 {
     // rewrite the query by transforming all named parameters into
     // the postgresql_ numbers ones (:abc -> $1, etc.)
+    placeholders_.parse(query);
 
-    enum { normal, in_quotes, in_identifier, in_name } state = normal;
-
-    std::string name;
-    int position = 1;
+    std::vector<std::string> const & chunks = placeholders_.chunks();
+    query_ = chunks.front();
+    for (std::size_t i = 1; i != chunks.size(); ++i)
+    {
+        std::ostringstream ss;
+        ss << '$' << i;
+        query_ += ss.str();
+        query_ += chunks[i];
+    }
 
-    for (std::string::const_iterator it = query.begin(), end = query.end();
-         it != end; ++it)
+    // COPY can't be prepared and is executed in a special way, as rows of data
+    // are sent for it only after executing the statement itself.
+    copyIn_ = is_copy_from_stdin(query_);
+    if (copyIn_)
     {
-        switch (state)
+        for (std::size_t i = 0; i != copyUseNames_.size(); ++i)
         {
-        case normal:
-            if (*it == '\'')
-            {
-                query_ += *it;
-                state = in_quotes;
-            }
-            else if (*it == '\"')
-            {
-                query_ += *it;
-                state = in_identifier;
-            }
-            else if (*it == ':')
-            {
-                // Check whether this is a cast operator (e.g. 23::float)
-                // and treat it as a special case, not as a named binding
-                const std::string::const_iterator next_it = it + 1;
-                if ((next_it != end) && (*next_it == ':'))
-                {
-                    query_ += "::";
-                    ++it;
-                }
-                // Check whether this is an assignment(e.g. x:=y)
-                // and treat it as a special case, not as a named binding
-                else if ((next_it != end) && (*next_it == '='))
-                {
-                    query_ += ":=";
-                    ++it;
-                }
-                else
-                {
-                    state = in_name;
-                }
-            }
-            else // regular character, stay in the same state
-            {
-                query_ += *it;
-            }
-            break;
-        case in_quotes:
-           if (*it == '\'' )
-            {
-                query_ += *it;
-                state = normal;
-            }
-            else // regular quoted character
-            {
-                query_ += *it;
-            }
-            break;
-        case in_identifier:
-            if ( *it == '\"' )
-            {
-                query_ += *it;
-                state = normal;
-            }
-            else // regular quoted character
-            {
-                query_ += *it;
-            }
-            break;
-        case in_name:
-            if (std::isalnum(*it) || *it == '_')
-            {
-                name += *it;
-            }
-            else // end of name
-            {
-                names_.push_back(name);
-                name.clear();
-                std::ostringstream ss;
-                ss << '$' << position++;
-                query_ += ss.str();
-                query_ += *it;
-                state = normal;
-
-                // Check whether the named parameter is immediatelly
-                // followed by a cast operator (e.g. :name::float)
-                // and handle the additional colon immediately to avoid
-                // its misinterpretation later on.
-                if (*it == ':')
-                {
-                    const std::string::const_iterator next_it = it + 1;
-                    if ((next_it != end) && (*next_it == ':'))
-                    {
-                        query_ += ':';
-                        ++it;
-                    }
-                }
-            }
-            break;
+            placeholders_.add_name(copyUseNames_[i]);
         }
     }
 
-    if (state == in_name)
-    {
-        names_.push_back(name);
-        std::ostringstream ss;
-        ss << '$' << position++;
-        query_ += ss.str();
-    }
+    // When the fetch size is set, queries are executed using cursors.
+    cursorQuery_ = session_.fetch_size_ > 0 && !copyIn_ &&
+                   is_cursor_query(query_);
 
-    if (stType == st_repeatable_query)
+    if (stType == st_repeatable_query && !copyIn_)
     {
         if (!statementName_.empty())
         {
@@ -235,7 +302,7 @@ void postgresql_statement_backend::prepare(std::string const & query,
             // prepare for single-row retrieval
 
             int result = PQsendPrepare(session_.conn_, statementName.c_str(),
-                query_.c_str(), static_cast<int>(names_.size()), NULL);
+                query_.c_str(), static_cast<int>(placeholders_.names().size()), NULL);
             if (result != 1)
             {
                 throw_soci_error(session_.conn_,
@@ -251,12 +318,38 @@ void postgresql_statement_backend::prepare(std::string const & query,
 
             postgresql_result result(session_,
                 PQprepare(session_.conn_, statementName.c_str(),
-                    query_.c_str(), static_cast<int>(names_.size()), NULL));
+                    query_.c_str(), static_cast<int>(placeholders_.names().size()), NULL));
             result.check_for_errors("Cannot prepare statement.");
         }
 
         // Now it's safe to save this info.
         statementName_ = statementName;
+
+        if (session_.binary_mode_)
+        {
+            // Find out the parameter and result types to be able to exchange
+            // the values in binary format: this costs an extra round trip,
+            // but only once per prepared statement.
+            postgresql_result result(session_,
+                PQdescribePrepared(session_.conn_, statementName_.c_str()));
+            result.check_for_errors("Cannot describe prepared statement.");
+
+            int const nparams = PQnparams(result);
+            paramTypes_.resize(nparams);
+            for (int i = 0; i != nparams; ++i)
+            {
+                paramTypes_[i] = PQparamtype(result, i);
+            }
+
+            int const nfields = PQnfields(result);
+            resultTypes_.resize(nfields);
+            for (int i = 0; i != nfields; ++i)
+            {
+                resultTypes_[i] = PQftype(result, i);
+            }
+
+            binaryResults_ = can_use_binary_results();
+        }
     }
 
     stType_ = stType;
@@ -272,6 +365,12 @@ postgresql_statement_backend::execute(int number)
     }
 #endif // !SOCI_POSTGRESQL_NOSINGLEROWMODE
 
+    if (copyIn_)
+    {
+        execute_copy_in(number);
+        return ef_no_data;
+    }
+
     // If the statement was "just described", then we know that
     // it was actually executed with all the use elements
     // already bound and pre-used. This means that the result of the
@@ -301,6 +400,8 @@ postgresql_statement_backend::execute(int number)
         // not supported anyway, so in the effect the 'number' parameter here
         // specifies the size of vectors (into/use), but 'numberOfExecutions'
         // specifies the number of loops that need to be performed.
+        // In pipeline mode the loop is still done, but all the executions are
+        // sent to the server before waiting for any of their results.
 
         int numberOfExecutions = 1;
         if (number > 0)
@@ -308,6 +409,26 @@ postgresql_statement_backend::execute(int number)
              numberOfExecutions = hasUseElements_ ? 1 : number;
         }
 
+        // The rows of the previous execution are not needed any more.
+        if (cursorName_.empty() == false)
+        {
+            close_cursor(false);
+        }
+
+        // Using a cursor only makes sense if the rows are going to be fetched.
+        if (cursorQuery_ && numberOfExecutions == 1 &&
+            (number > 0 || hasIntoElements_ || hasVectorIntoElements_))
+        {
+            declare_cursor();
+            fetch_cursor_rows(number);
+
+            return process_execute_result(number);
+        }
+
+        // Results of prepared statements may be retrieved in binary format,
+        // one-time queries are never described and always use text format.
+        int const resultFormat = binaryResults_ ? 1 : 0;
+
         if ((useByPosBuffers_.empty() == false) ||
             (useByNameBuffers_.empty() == false))
         {
@@ -318,48 +439,19 @@ postgresql_statement_backend::execute(int number)
                     "Binding for use elements must be either by position "
                     "or by name.");
             }
+            if ((numberOfExecutions > 1) && session_.pipeline_mode_)
+            {
+                execute_pipelined(numberOfExecutions);
+                return ef_no_data;
+            }
+
             long long rowsAffectedBulkTemp = 0;
+            std::vector<char *> paramValues;
+            std::vector<int> paramLengths;
+            std::vector<int> paramFormats;
             for (int i = 0; i != numberOfExecutions; ++i)
             {
-                std::vector<char *> paramValues;
-
-                if (useByPosBuffers_.empty() == false)
-                {
-                    // use elements bind by position
-                    // the map of use buffers can be traversed
-                    // in its natural order
-
-                    for (UseByPosBuffersMap::iterator
-                             it = useByPosBuffers_.begin(),
-                             end = useByPosBuffers_.end();
-                         it != end; ++it)
-                    {
-                        char ** buffers = it->second;
-                        paramValues.push_back(buffers[i]);
-                    }
-                }
-                else
-                {
-                    // use elements bind by name
-
-                    for (std::vector<std::string>::iterator
-                             it = names_.begin(), end = names_.end();
-                         it != end; ++it)
-                    {
-                        UseByNameBuffersMap::iterator b
-                            = useByNameBuffers_.find(*it);
-                        if (b == useByNameBuffers_.end())
-                        {
-                            std::string msg(
-                                "Missing use element for bind by name (");
-                            msg += *it;
-                            msg += ").";
-                            throw soci_error(msg);
-                        }
-                        char ** buffers = b->second;
-                        paramValues.push_back(buffers[i]);
-                    }
-                }
+                get_param_values(i, paramValues, paramLengths, paramFormats);
 
                 if (stType_ == st_repeatable_query)
                 {
@@ -371,7 +463,8 @@ postgresql_statement_backend::execute(int number)
                         int result = PQsendQueryPrepared(session_.conn_,
                             statementName_.c_str(),
                             static_cast<int>(paramValues.size()),
-                            &paramValues[0], NULL, NULL, 0);
+                            &paramValues[0], &paramLengths[0],
+                            &paramFormats[0], resultFormat);
                         if (result != 1)
                         {
                             throw_soci_error(session_.conn_,
@@ -393,7 +486,8 @@ postgresql_statement_backend::execute(int number)
                         result_.reset(PQexecPrepared(session_.conn_,
                                 statementName_.c_str(),
                                 static_cast<int>(paramValues.size()),
-                                &paramValues[0], NULL, NULL, 0));
+                                &paramValues[0], &paramLengths[0],
+                                &paramFormats[0], resultFormat));
                     }
                 }
                 else // stType_ == st_one_time_query
@@ -466,7 +560,8 @@ postgresql_statement_backend::execute(int number)
                 if (single_row_mode_)
                 {
                     int result = PQsendQueryPrepared(session_.conn_,
-                        statementName_.c_str(), 0, NULL, NULL, NULL, 0);
+                        statementName_.c_str(), 0, NULL, NULL, NULL,
+                        resultFormat);
                     if (result != 1)
                     {
                         throw_soci_error(session_.conn_,
@@ -486,7 +581,8 @@ postgresql_statement_backend::execute(int number)
                     // default multi-row execution
 
                     result_.reset(PQexecPrepared(session_.conn_,
-                            statementName_.c_str(), 0, NULL, NULL, NULL, 0));
+                            statementName_.c_str(), 0, NULL, NULL, NULL,
+                            resultFormat));
                 }
             }
             else // stType_ == st_one_time_query
@@ -519,7 +615,6 @@ postgresql_statement_backend::execute(int number)
         }
     }
 
-    bool process_result;
 #ifndef SOCI_POSTGRESQL_NOSINGLEROWMODE
     if (single_row_mode_)
     {
@@ -533,16 +628,17 @@ postgresql_statement_backend::execute(int number)
             PGresult * res = PQgetResult(session_.conn_);
             result_.reset(res);
         }
-
-        process_result = result_.check_for_data("Cannot execute query.");
     }
-    else
 #endif // !SOCI_POSTGRESQL_NOSINGLEROWMODE
-    {
-        // default multi-row execution
 
-        process_result = result_.check_for_data("Cannot execute query.");
-    }
+    return process_execute_result(number);
+}
+
+statement_backend::exec_fetch_result
+postgresql_statement_backend::process_execute_result(int number)
+{
+    bool const process_result
+        = result_.check_for_data("Cannot execute query.");
 
     justDescribed_ = false;
 
@@ -576,105 +672,991 @@ postgresql_statement_backend::execute(int number)
     }
 }
 
-statement_backend::exec_fetch_result
-postgresql_statement_backend::fetch(int number)
+bool postgresql_statement_backend::execute_async(int number)
 {
-#ifndef SOCI_POSTGRESQL_NOSINGLEROWMODE
-    if (single_row_mode_ && (number > 1))
+    // Only a single execution is done asynchronously, bulk operations and
+    // everything else execute() would refuse are left to it.
+    if (copyIn_ || justDescribed_ || cursorQuery_ ||
+        cursorName_.empty() == false)
     {
-        throw soci_error("Bulk operations are not supported with single-row mode.");
+        return false;
     }
-#endif // !SOCI_POSTGRESQL_NOSINGLEROWMODE
-
-    // Note:
-    // In the multi-row mode this function does not actually fetch anything from anywhere
-    // - the data was already retrieved from the server in the execute()
-    // function, and the actual consumption of this data will take place
-    // in the postFetch functions, called for each into element.
-    // Here, we only prepare for this to happen (to emulate "the Oracle way").
-    // In the single-row mode the fetch of single row of data is performed as expected.
 
-    // forward the "cursor" from the last fetch
-    currentRow_ += rowsToConsume_;
+    bool const hasUseBuffers = (useByPosBuffers_.empty() == false) ||
+                               (useByNameBuffers_.empty() == false);
 
-    if (currentRow_ >= numberOfRows_)
+    if (number > 1)
     {
+        if (hasIntoElements_ || (hasUseBuffers && !hasUseElements_))
+        {
+            return false;
+        }
+
 #ifndef SOCI_POSTGRESQL_NOSINGLEROWMODE
         if (single_row_mode_)
         {
-            PGresult* res = PQgetResult(session_.conn_);
-            result_.reset(res);
+            return false;
+        }
+#endif // !SOCI_POSTGRESQL_NOSINGLEROWMODE
+    }
 
-            if (res == NULL)
-            {
-                return ef_no_data;
-            }
+    if ((useByPosBuffers_.empty() == false) &&
+        (useByNameBuffers_.empty() == false))
+    {
+        return false;
+    }
 
-            currentRow_ = 0;
-            rowsToConsume_ = 0;
+    clean_up();
 
-            numberOfRows_ = PQntuples(result_);
-            if (numberOfRows_ == 0)
-            {
-                return ef_no_data;
-            }
-            else
-            {
-                rowsToConsume_ = 1;
+    // Don't keep the result of the previous execution, which could be an
+    // error that finish_execute_async() would report instead of the new one.
+    result_.reset();
 
-                return ef_success;
-            }
-        }
-        else
-#endif // !SOCI_POSTGRESQL_NOSINGLEROWMODE
-        {
-            // default multi-row execution
+    int const resultFormat = binaryResults_ ? 1 : 0;
 
-            // all rows were already consumed
+    int result;
+    if (hasUseBuffers)
+    {
+        rowsAffectedBulk_ = 0;
 
-            return ef_no_data;
+        std::vector<char *> paramValues;
+        std::vector<int> paramLengths;
+        std::vector<int> paramFormats;
+        get_param_values(0, paramValues, paramLengths, paramFormats);
+
+        if (stType_ == st_repeatable_query)
+        {
+            result = PQsendQueryPrepared(session_.conn_,
+                statementName_.c_str(),
+                static_cast<int>(paramValues.size()),
+                &paramValues[0], &paramLengths[0],
+                &paramFormats[0], resultFormat);
+        }
+        else // stType_ == st_one_time_query
+        {
+            result = PQsendQueryParams(session_.conn_, query_.c_str(),
+                static_cast<int>(paramValues.size()),
+                NULL, &paramValues[0], NULL, NULL, 0);
         }
     }
     else
     {
-        if (currentRow_ + number > numberOfRows_)
+        if (stType_ == st_repeatable_query)
         {
-#ifndef SOCI_POSTGRESQL_NOSINGLEROWMODE
-            if (single_row_mode_)
-            {
-                rowsToConsume_ = 1;
-
-                return ef_success;
-            }
-            else
-#endif // !SOCI_POSTGRESQL_NOSINGLEROWMODE
-            {
-                // default multi-row execution
-
-                rowsToConsume_ = numberOfRows_ - currentRow_;
-
-                // this simulates the behaviour of Oracle
-                // - when EOF is hit, we return ef_no_data even when there are
-                // actually some rows fetched
-                return ef_no_data;
-            }
+            result = PQsendQueryPrepared(session_.conn_,
+                statementName_.c_str(), 0, NULL, NULL, NULL,
+                resultFormat);
         }
-        else
+        else // stType_ == st_one_time_query
         {
-#ifndef SOCI_POSTGRESQL_NOSINGLEROWMODE
-            if (single_row_mode_)
-            {
-                rowsToConsume_ = 1;
-            }
-            else
-#endif // !SOCI_POSTGRESQL_NOSINGLEROWMODE
-            {
-                rowsToConsume_ = number;
-            }
-
-            return ef_success;
+            result = PQsendQuery(session_.conn_, query_.c_str());
         }
     }
+
+    if (result != 1)
+    {
+        throw_soci_error(session_.conn_, "Cannot execute query asynchronously");
+    }
+
+#ifndef SOCI_POSTGRESQL_NOSINGLEROWMODE
+    if (single_row_mode_)
+    {
+        if (PQsetSingleRowMode(session_.conn_) != 1)
+        {
+            throw_soci_error(session_.conn_, "Cannot set single-row mode");
+        }
+    }
+#endif // !SOCI_POSTGRESQL_NOSINGLEROWMODE
+
+    return true;
+}
+
+bool postgresql_statement_backend::is_async_ready()
+{
+    if (PQconsumeInput(session_.conn_) != 1)
+    {
+        // Let finish_execute_async() report the error.
+        return true;
+    }
+
+    return PQisBusy(session_.conn_) == 0;
+}
+
+statement_backend::exec_fetch_result
+postgresql_statement_backend::finish_execute_async(int number)
+{
+#ifndef SOCI_POSTGRESQL_NOSINGLEROWMODE
+    if (single_row_mode_)
+    {
+        // The remaining rows are retrieved by fetch().
+        result_.reset(PQgetResult(session_.conn_));
+    }
+    else
+#endif // !SOCI_POSTGRESQL_NOSINGLEROWMODE
+    {
+        // All the results must be consumed before the connection can be used
+        // again: keep the last one, as PQexec() does, unless an error occurs,
+        // in which case the first error is kept.
+        bool failed = false;
+        for (;;)
+        {
+            PGresult * const res = PQgetResult(session_.conn_);
+            if (res == NULL)
+            {
+                break;
+            }
+
+            if (failed)
+            {
+                PQclear(res);
+                continue;
+            }
+
+            result_.reset(res);
+            failed = PQresultStatus(res) == PGRES_FATAL_ERROR;
+        }
+    }
+
+    return process_execute_result(number);
+}
+
+int postgresql_statement_backend::get_native_socket()
+{
+    return PQsocket(session_.conn_);
+}
+
+bool postgresql_statement_backend::cancel()
+{
+    // PQcancel() is thread-safe, but we still need a separate cancel object
+    // for each request as it's not safe to share it between threads.
+    PGcancel * const cancel = PQgetCancel(session_.conn_);
+    if (cancel == NULL)
+    {
+        return false;
+    }
+
+    char errbuf[256];
+    int const res = PQcancel(cancel, errbuf, sizeof(errbuf));
+    PQfreeCancel(cancel);
+
+    return res == 1;
+}
+
+statement_backend::exec_fetch_result
+postgresql_statement_backend::fetch(int number)
+{
+    exec_fetch_result const res = fetch_rows(number);
+
+    if (columnBatch_ != NULL)
+    {
+        load_column_batch();
+    }
+
+    return res;
+}
+
+statement_backend::exec_fetch_result
+postgresql_statement_backend::fetch_rows(int number)
+{
+#ifndef SOCI_POSTGRESQL_NOSINGLEROWMODE
+    if (single_row_mode_ && (number > 1))
+    {
+        throw soci_error("Bulk operations are not supported with single-row mode.");
+    }
+#endif // !SOCI_POSTGRESQL_NOSINGLEROWMODE
+
+    // Note:
+    // In the multi-row mode this function does not actually fetch anything from anywhere
+    // - the data was already retrieved from the server in the execute()
+    // function, and the actual consumption of this data will take place
+    // in the postFetch functions, called for each into element.
+    // Here, we only prepare for this to happen (to emulate "the Oracle way").
+    // In the single-row mode the fetch of single row of data is performed as expected.
+
+    // forward the "cursor" from the last fetch
+    currentRow_ += rowsToConsume_;
+
+    if (currentRow_ >= numberOfRows_ && cursorName_.empty() == false)
+    {
+        // All the rows of the last batch were consumed, get the next one.
+        fetch_cursor_rows(number);
+
+        currentRow_ = 0;
+        rowsToConsume_ = 0;
+        numberOfRows_ = PQntuples(result_);
+    }
+
+    if (currentRow_ >= numberOfRows_)
+    {
+#ifndef SOCI_POSTGRESQL_NOSINGLEROWMODE
+        if (single_row_mode_)
+        {
+            PGresult* res = PQgetResult(session_.conn_);
+            result_.reset(res);
+
+            if (res == NULL)
+            {
+                return ef_no_data;
+            }
+
+            currentRow_ = 0;
+            rowsToConsume_ = 0;
+
+            numberOfRows_ = PQntuples(result_);
+            if (numberOfRows_ == 0)
+            {
+                return ef_no_data;
+            }
+            else
+            {
+                rowsToConsume_ = 1;
+
+                return ef_success;
+            }
+        }
+        else
+#endif // !SOCI_POSTGRESQL_NOSINGLEROWMODE
+        {
+            // default multi-row execution
+
+            // all rows were already consumed
+
+            return ef_no_data;
+        }
+    }
+    else
+    {
+        if (currentRow_ + number > numberOfRows_)
+        {
+#ifndef SOCI_POSTGRESQL_NOSINGLEROWMODE
+            if (single_row_mode_)
+            {
+                rowsToConsume_ = 1;
+
+                return ef_success;
+            }
+            else
+#endif // !SOCI_POSTGRESQL_NOSINGLEROWMODE
+            {
+                // default multi-row execution
+
+                rowsToConsume_ = numberOfRows_ - currentRow_;
+
+                // When using a cursor, this is just the end of this batch
+                // and more rows are going to be fetched from it later.
+                if (cursorName_.empty() == false)
+                {
+                    return ef_success;
+                }
+
+                // this simulates the behaviour of Oracle
+                // - when EOF is hit, we return ef_no_data even when there are
+                // actually some rows fetched
+                return ef_no_data;
+            }
+        }
+        else
+        {
+#ifndef SOCI_POSTGRESQL_NOSINGLEROWMODE
+            if (single_row_mode_)
+            {
+                rowsToConsume_ = 1;
+            }
+            else
+#endif // !SOCI_POSTGRESQL_NOSINGLEROWMODE
+            {
+                rowsToConsume_ = number;
+            }
+
+            return ef_success;
+        }
+    }
+}
+
+void postgresql_statement_backend::load_column_batch()
+{
+    columnBatch_->clear_rows();
+
+    if (currentRow_ >= numberOfRows_)
+    {
+        return;
+    }
+
+    int const numCols = static_cast<int>(columnBatch_->get_number_of_columns());
+    int const endRow = currentRow_ + rowsToConsume_;
+    for (int row = currentRow_; row != endRow; ++row)
+    {
+        for (int c = 0; c != numCols; ++c)
+        {
+            if (PQgetisnull(result_, row, c) != 0)
+            {
+                columnBatch_->append_null(c);
+                continue;
+            }
+
+            // raw data, in text format unless binary mode is used
+            char const * buf = PQgetvalue(result_, row, c);
+            int const len = PQgetlength(result_, row, c);
+
+            // in binary mode, the binary format of the text types is the same
+            // as their text format, but all the other ones need to be decoded
+            Oid const typeOid = PQftype(result_, c);
+            bool const binary = PQfformat(result_, c) != 0 &&
+                !is_text_type(typeOid);
+
+            switch (columnBatch_->get_properties(c).get_data_type())
+            {
+            case dt_string:
+            case dt_blob:
+            case dt_xml:
+                if (binary)
+                {
+                    std::string const s = binary_to_string(buf, len, typeOid);
+                    columnBatch_->append_string(c, s.data(), s.size());
+                }
+                else
+                {
+                    columnBatch_->append_string(c, buf, len);
+                }
+                break;
+            case dt_date:
+                {
+                    std::tm t = std::tm();
+                    if (binary)
+                    {
+                        binary_to_std_tm(buf, typeOid, t);
+                    }
+                    else
+                    {
+                        parse_std_tm(buf, t);
+                    }
+                    columnBatch_->append_date(c, t);
+                }
+                break;
+            case dt_double:
+                columnBatch_->append_double(c, binary
+                    ? binary_to_double(buf, typeOid)
+                    : cstring_to_double(buf));
+                break;
+            case dt_integer:
+                columnBatch_->append_int(c, binary
+                    ? binary_to_integer<int>(buf, typeOid)
+                    : string_to_integer<int>(buf));
+                break;
+            case dt_long_long:
+                columnBatch_->append_long_long(c, binary
+                    ? binary_to_long_long(buf, typeOid)
+                    : string_to_integer<long long>(buf));
+                break;
+            case dt_unsigned_long_long:
+                columnBatch_->append_unsigned_long_long(c, binary
+                    ? binary_to_integer<unsigned long long>(buf, typeOid)
+                    : string_to_unsigned_integer<unsigned long long>(buf));
+                break;
+            }
+        }
+
+        columnBatch_->end_row();
+    }
+}
+
+void postgresql_statement_backend::get_param_values(int row,
+    std::vector<char *> & paramValues,
+    std::vector<int> & paramLengths, std::vector<int> & paramFormats)
+{
+    paramValues.clear();
+    paramLengths.clear();
+    paramFormats.clear();
+
+    if (useByPosBuffers_.empty() == false)
+    {
+        // use elements bind by position
+        // the map of use buffers can be traversed
+        // in its natural order
+
+        for (UseByPosBuffersMap::iterator
+                 it = useByPosBuffers_.begin(),
+                 end = useByPosBuffers_.end();
+             it != end; ++it)
+        {
+            char ** buffers = it->second;
+            paramValues.push_back(buffers[row]);
+
+            UseByPosLengthsMap::const_iterator const l
+                = useByPosBinaryLengths_.find(it->first);
+            if (l != useByPosBinaryLengths_.end())
+            {
+                paramLengths.push_back(l->second[row]);
+                paramFormats.push_back(1);
+            }
+            else
+            {
+                paramLengths.push_back(0);
+                paramFormats.push_back(0);
+            }
+        }
+    }
+    else
+    {
+        // use elements bind by name
+
+        std::vector<std::string> const & names = placeholders_.names();
+        for (std::vector<std::string>::const_iterator
+                 it = names.begin(), end = names.end();
+             it != end; ++it)
+        {
+            UseByNameBuffersMap::iterator b
+                = useByNameBuffers_.find(*it);
+            if (b == useByNameBuffers_.end())
+            {
+                std::string msg(
+                    "Missing use element for bind by name (");
+                msg += *it;
+                msg += ").";
+                throw soci_error(msg);
+            }
+            char ** buffers = b->second;
+            paramValues.push_back(buffers[row]);
+
+            UseByNameLengthsMap::const_iterator const l
+                = useByNameBinaryLengths_.find(*it);
+            if (l != useByNameBinaryLengths_.end())
+            {
+                paramLengths.push_back(l->second[row]);
+                paramFormats.push_back(1);
+            }
+            else
+            {
+                paramLengths.push_back(0);
+                paramFormats.push_back(0);
+            }
+        }
+    }
+}
+
+Oid postgresql_statement_backend::get_binary_param_type(int position,
+    std::string const & name) const
+{
+    if (paramTypes_.empty())
+    {
+        return 0;
+    }
+
+    if (position > 0)
+    {
+        // use elements bound by position correspond to $1, $2, ...
+        std::size_t const index = static_cast<std::size_t>(position - 1);
+        return index < paramTypes_.size() ? paramTypes_[index] : 0;
+    }
+
+    // The same name may be used more than once in the query, in which case
+    // we can only use binary format if all the parameters have the same type.
+    std::vector<std::size_t> const * const indices = placeholders_.find(name);
+    if (indices == NULL)
+    {
+        return 0;
+    }
+
+    Oid type = 0;
+    for (std::size_t i = 0; i != indices->size(); ++i)
+    {
+        std::size_t const index = (*indices)[i];
+        if (index >= paramTypes_.size())
+        {
+            break;
+        }
+
+        if (type != 0 && type != paramTypes_[index])
+        {
+            return 0;
+        }
+
+        type = paramTypes_[index];
+    }
+
+    return type;
+}
+
+bool postgresql_statement_backend::can_use_binary_results() const
+{
+    // The result format can only be chosen for all the columns at once, so
+    // use binary only if it is supported for all of them.
+    if (resultTypes_.empty())
+    {
+        return false;
+    }
+
+    for (std::size_t i = 0; i != resultTypes_.size(); ++i)
+    {
+        if (!is_binary_result_type(resultTypes_[i], session_.integerDatetimes_))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void postgresql_statement_backend::check_binary_result_column(int position,
+    exchange_type type)
+{
+    if (!binaryResults_)
+    {
+        return;
+    }
+
+    switch (type)
+    {
+    case x_char:
+    case x_stdstring:
+    case x_xmltype:
+    case x_longstring:
+        break;
+
+    default:
+        // all the other types are converted from binary values exactly
+        return;
+    }
+
+    // Values retrieved as strings must be the same as in text mode, which
+    // is not the case for all types, so use text format for all the columns
+    // if any of them is retrieved as string and would be different.
+    std::size_t const index = static_cast<std::size_t>(position - 1);
+    if (index < resultTypes_.size() &&
+        !is_exact_string_type(resultTypes_[index]))
+    {
+        binaryResults_ = false;
+    }
+}
+
+void postgresql_statement_backend::execute_pipelined(int numberOfExecutions)
+{
+#ifdef LIBPQ_HAS_PIPELINING
+    // The results are read back after every this many queries: without doing
+    // it, both the client and the server could end up blocked writing to the
+    // socket while the other side doesn't read from it for big batches.
+    int const maxQueriesInFlight = 1000;
+
+    PGconn * const conn = session_.conn_;
+
+    // Outside of an explicit transaction all the queries sent before the
+    // single sync point are executed in the same implicit transaction, so an
+    // error in any of them means that none of the rows was affected.
+    bool const inTransaction = PQtransactionStatus(conn) != PQTRANS_IDLE;
+
+    if (PQenterPipelineMode(conn) != 1)
+    {
+        throw_soci_error(conn, "Cannot enter pipeline mode");
+    }
+
+    // The first failed result, if any: the error is only thrown once the
+    // pipeline has been drained and the connection is usable again.
+    postgresql_result failedResult(session_, NULL);
+    std::string sendError;
+    bool syncSent = false;
+
+    long long rowsAffectedBulkTemp = 0;
+    std::vector<char *> paramValues;
+    std::vector<int> paramLengths;
+    std::vector<int> paramFormats;
+
+    int const resultFormat = binaryResults_ ? 1 : 0;
+
+    int sent = 0;
+    int received = 0;
+    while (received != numberOfExecutions)
+    {
+        int const chunkEnd =
+            std::min(sent + maxQueriesInFlight, numberOfExecutions);
+        for (; sent != chunkEnd; ++sent)
+        {
+            get_param_values(sent, paramValues, paramLengths, paramFormats);
+
+            int result;
+            if (stType_ == st_repeatable_query)
+            {
+                result = PQsendQueryPrepared(conn, statementName_.c_str(),
+                    static_cast<int>(paramValues.size()),
+                    &paramValues[0], &paramLengths[0], &paramFormats[0],
+                    resultFormat);
+            }
+            else // stType_ == st_one_time_query
+            {
+                result = PQsendQueryParams(conn, query_.c_str(),
+                    static_cast<int>(paramValues.size()),
+                    NULL, &paramValues[0], NULL, NULL, 0);
+            }
+
+            if (result != 1)
+            {
+                sendError = PQerrorMessage(conn);
+                break;
+            }
+        }
+
+        if (sent == numberOfExecutions || !sendError.empty())
+        {
+            syncSent = PQpipelineSync(conn) == 1;
+        }
+        else
+        {
+            PQsendFlushRequest(conn);
+            PQflush(conn);
+        }
+
+        for (; received != sent; ++received)
+        {
+            PGresult * const res = PQgetResult(conn);
+
+            // Each query result is followed by a NULL one.
+            if (res != NULL)
+            {
+                PQclear(PQgetResult(conn));
+            }
+
+            if (failedResult.get_result() != NULL)
+            {
+                // All the results after the failed one are just
+                // PGRES_PIPELINE_ABORTED, ignore them.
+                PQclear(res);
+                continue;
+            }
+
+            switch (PQresultStatus(res))
+            {
+                case PGRES_EMPTY_QUERY:
+                case PGRES_COMMAND_OK:
+                case PGRES_TUPLES_OK:
+                    rowsAffectedBulkTemp +=
+                        std::strtoll(PQcmdTuples(res), NULL, 0);
+                    PQclear(res);
+                    break;
+
+                default:
+                    failedResult.reset(res != NULL ? res
+                        : PQmakeEmptyPGresult(conn, PGRES_FATAL_ERROR));
+                    break;
+            }
+        }
+
+        if (failedResult.get_result() != NULL || !sendError.empty())
+        {
+            // Don't send the remaining rows after an error.
+            break;
+        }
+    }
+
+    if (!syncSent)
+    {
+        syncSent = PQpipelineSync(conn) == 1;
+    }
+
+    if (syncSent)
+    {
+        // Consume the PGRES_PIPELINE_SYNC result.
+        postgresql_result(session_, PQgetResult(conn));
+    }
+
+    PQexitPipelineMode(conn);
+
+    result_.reset();
+
+    if (failedResult.get_result() != NULL || !sendError.empty())
+    {
+        rowsAffectedBulk_ = inTransaction ? rowsAffectedBulkTemp : 0;
+
+        if (!sendError.empty())
+        {
+            std::string msg = "Cannot execute query in pipeline mode: ";
+            msg += sendError;
+            throw soci_error(msg);
+        }
+
+        failedResult.check_for_errors("Cannot execute query.");
+    }
+
+    rowsAffectedBulk_ = rowsAffectedBulkTemp;
+#else // !LIBPQ_HAS_PIPELINING
+    (void)numberOfExecutions;
+
+    throw soci_error("Pipeline mode requires libpq 14 or later");
+#endif // LIBPQ_HAS_PIPELINING
+}
+
+void postgresql_statement_backend::execute_copy_in(int number)
+{
+    // The data is sent to the server in chunks of at least this size.
+    std::size_t const copyChunkSize = 65536;
+
+    PGconn * const conn = session_.conn_;
+
+    if (!copyInProgress_)
+    {
+        postgresql_result result(session_, PQexec(conn, query_.c_str()));
+        if (PQresultStatus(result) != PGRES_COPY_IN)
+        {
+            result.check_for_errors("Cannot start copying data.");
+            throw soci_error("Statement doesn't copy data from standard input.");
+        }
+
+        copyInProgress_ = true;
+        copyData_.clear();
+    }
+
+    if (useByPosBuffers_.empty() && useByNameBuffers_.empty())
+    {
+        // nothing to copy
+        return;
+    }
+
+    if ((useByPosBuffers_.empty() == false) &&
+        (useByNameBuffers_.empty() == false))
+    {
+        throw soci_error(
+            "Binding for use elements must be either by position "
+            "or by name.");
+    }
+
+    // As for the other statements, bulk use elements result in one row per
+    // element, while single use elements always correspond to a single row.
+    int numberOfRows = 0;
+    if (number > 0)
+    {
+        numberOfRows = hasUseElements_ ? 1 : number;
+    }
+
+    std::vector<char *> paramValues;
+    std::vector<int> paramLengths;
+    std::vector<int> paramFormats;
+    for (int i = 0; i != numberOfRows; ++i)
+    {
+        get_param_values(i, paramValues, paramLengths, paramFormats);
+
+        for (std::size_t n = 0; n != paramValues.size(); ++n)
+        {
+            if (n != 0)
+            {
+                copyData_ += '\t';
+            }
+
+            append_copy_value(copyData_, paramValues[n]);
+        }
+
+        copyData_ += '\n';
+
+        if (copyData_.size() >= copyChunkSize)
+        {
+            if (PQputCopyData(conn, copyData_.data(),
+                    static_cast<int>(copyData_.size())) != 1)
+            {
+                throw_soci_error(conn, "Cannot copy data");
+            }
+
+            copyData_.clear();
+        }
+    }
+}
+
+void postgresql_statement_backend::set_copy_use_names(
+    std::vector<std::string> const & names)
+{
+    copyUseNames_ = names;
+}
+
+long long postgresql_statement_backend::end_copy()
+{
+    if (!copyInProgress_)
+    {
+        throw soci_error("No data is being copied.");
+    }
+
+    PGconn * const conn = session_.conn_;
+
+    copyInProgress_ = false;
+
+    if (!copyData_.empty())
+    {
+        int const res = PQputCopyData(conn, copyData_.data(),
+            static_cast<int>(copyData_.size()));
+        copyData_.clear();
+
+        if (res != 1)
+        {
+            PQputCopyEnd(conn, "Cannot copy data");
+            postgresql_result(session_, PQgetResult(conn));
+            throw_soci_error(conn, "Cannot copy data");
+        }
+    }
+
+    if (PQputCopyEnd(conn, NULL) != 1)
+    {
+        throw_soci_error(conn, "Cannot finish copying data");
+    }
+
+    // Errors in the copied data are only reported now.
+    result_.reset(PQgetResult(conn));
+
+    // Consume the end of results marker.
+    postgresql_result(session_, PQgetResult(conn));
+
+    result_.check_for_errors("Cannot copy data.");
+
+    rowsAffectedBulk_ = get_affected_rows();
+    result_.reset();
+
+    return rowsAffectedBulk_;
+}
+
+void postgresql_statement_backend::abort_copy()
+{
+    if (!copyInProgress_)
+    {
+        return;
+    }
+
+    PGconn * const conn = session_.conn_;
+
+    copyInProgress_ = false;
+    copyData_.clear();
+
+    PQputCopyEnd(conn, "Copying data was aborted");
+
+    // The result is always an error here, just consume it.
+    for (;;)
+    {
+        PGresult * const res = PQgetResult(conn);
+        if (res == NULL)
+        {
+            break;
+        }
+
+        PQclear(res);
+    }
+}
+
+void postgresql_statement_backend::declare_cursor()
+{
+    std::vector<char *> paramValues;
+    std::vector<int> paramLengths;
+    std::vector<int> paramFormats;
+
+    if ((useByPosBuffers_.empty() == false) ||
+        (useByNameBuffers_.empty() == false))
+    {
+        if ((useByPosBuffers_.empty() == false) &&
+            (useByNameBuffers_.empty() == false))
+        {
+            throw soci_error(
+                "Binding for use elements must be either by position "
+                "or by name.");
+        }
+
+        get_param_values(0, paramValues, paramLengths, paramFormats);
+    }
+
+    std::string name("cursor_");
+    name += session_.get_next_statement_name();
+
+    // Inside a transaction a plain cursor is used, allowing the server to
+    // produce the rows lazily. Outside of it, the cursor must be declared
+    // WITH HOLD to survive the end of the implicit transaction, but then the
+    // server has to materialize the entire result when it is committed.
+    bool const holdable = PQtransactionStatus(session_.conn_) == PQTRANS_IDLE;
+
+    std::string query("DECLARE ");
+    query += name;
+    query += " NO SCROLL CURSOR ";
+    if (holdable)
+    {
+        query += "WITH HOLD ";
+    }
+    query += "FOR ";
+    query += query_;
+
+    int const nParams = static_cast<int>(paramValues.size());
+    postgresql_result result(session_,
+        PQexecParams(session_.conn_, query.c_str(), nParams, NULL,
+            nParams ? &paramValues[0] : NULL,
+            nParams ? &paramLengths[0] : NULL,
+            nParams ? &paramFormats[0] : NULL, 0));
+    result.check_for_errors("Cannot execute query.");
+
+    cursorName_ = name;
+    cursorHoldable_ = holdable;
+}
+
+void postgresql_statement_backend::fetch_cursor_rows(int number)
+{
+    // Fetch a multiple of the number of rows consumed by each call to
+    // fetch() to avoid returning partial batches before the end of the
+    // result.
+    if (number < 1)
+    {
+        number = 1;
+    }
+    int const rows = (std::max(number, session_.fetch_size_) + number - 1)
+                     / number * number;
+
+    std::ostringstream ss;
+    ss << "FETCH FORWARD " << rows << " FROM " << cursorName_;
+
+    result_.reset(PQexecParams(session_.conn_, ss.str().c_str(),
+        0, NULL, NULL, NULL, NULL, binaryResults_ ? 1 : 0));
+    result_.check_for_errors("Cannot fetch rows from cursor.");
+
+    // Close the cursor as soon as possible to free the server resources.
+    if (PQntuples(result_) < rows)
+    {
+        close_cursor(true);
+    }
+}
+
+void postgresql_statement_backend::close_cursor(bool knownOpen)
+{
+    std::string const name = cursorName_;
+    cursorName_.clear();
+
+    PGTransactionStatusType const status = PQtransactionStatus(session_.conn_);
+
+    // No commands can be executed in a failed transaction, but the cursor
+    // will be closed when it's rolled back if it had been declared in it.
+    if (status == PQTRANS_INERROR)
+    {
+        return;
+    }
+
+    std::string query = "CLOSE " + name;
+    if (!knownOpen && !cursorHoldable_)
+    {
+        // The cursor declared inside a transaction doesn't exist any longer
+        // if this transaction has ended.
+        if (status == PQTRANS_IDLE)
+        {
+            return;
+        }
+
+        // But we can't know if the transaction in progress is still the same
+        // one, so close the cursor inside a savepoint, to avoid aborting the
+        // current transaction if it fails because the cursor is already gone.
+        query = "SAVEPOINT soci_close_cursor; " + query +
+                "; RELEASE SAVEPOINT soci_close_cursor";
+
+        postgresql_result result(session_,
+            PQexec(session_.conn_, query.c_str()));
+        if (PQresultStatus(result) != PGRES_COMMAND_OK)
+        {
+            postgresql_result rollback(session_,
+                PQexec(session_.conn_,
+                    "ROLLBACK TO SAVEPOINT soci_close_cursor; "
+                    "RELEASE SAVEPOINT soci_close_cursor"));
+            rollback.check_for_errors("Cannot close cursor.");
+        }
+
+        return;
+    }
+
+    postgresql_result result(session_, PQexec(session_.conn_, query.c_str()));
+    result.check_for_errors("Cannot close cursor.");
 }
 
 long long postgresql_statement_backend::get_affected_rows()
@@ -705,7 +1687,7 @@ int postgresql_statement_backend::get_number_of_rows()
 
 std::string postgresql_statement_backend::get_parameter_name(int index) const
 {
-    return names_.at(index);
+    return placeholders_.names().at(index);
 }
 
 std::string postgresql_statement_backend::rewrite_for_procedure_call(
@@ -34,6 +34,8 @@ void postgresql_vector_into_type_backend::define_by_pos_bulk(
     end_ = end;
     position_ = position++;
 
+    statement_.check_binary_result_column(position_, type_);
+
     end_var_ = full_size();
 }
 
@@ -65,6 +67,45 @@ void set_invector_wrappers_(void * p, int indx, V const & val)
     v[indx].value = val;
 }
 
+template <typename T>
+void * element_ptr_(void * p, int indx)
+{
+    std::vector<T> & v = *static_cast<std::vector<T> *>(p);
+    return &v[indx];
+}
+
+// returns the pointer to the given vector element, which can then be used in
+// the same way as the data of the corresponding single exchange type
+void * element_ptr_(void * p, exchange_type type, int indx)
+{
+    switch (type)
+    {
+    case x_char:
+        return element_ptr_<char>(p, indx);
+    case x_stdstring:
+        return element_ptr_<std::string>(p, indx);
+    case x_short:
+        return element_ptr_<short>(p, indx);
+    case x_integer:
+        return element_ptr_<int>(p, indx);
+    case x_long_long:
+        return element_ptr_<long long>(p, indx);
+    case x_unsigned_long_long:
+        return element_ptr_<unsigned long long>(p, indx);
+    case x_double:
+        return element_ptr_<double>(p, indx);
+    case x_stdtm:
+        return element_ptr_<std::tm>(p, indx);
+    case x_xmltype:
+        return element_ptr_<xml_type>(p, indx);
+    case x_longstring:
+        return element_ptr_<long_string>(p, indx);
+
+    default:
+        throw soci_error("Into element used with non-supported type.");
+    }
+}
+
 } // namespace anonymous
 
 void postgresql_vector_into_type_backend::post_fetch(bool gotData, indicator * ind)
@@ -79,6 +120,12 @@ void postgresql_vector_into_type_backend::post_fetch(bool gotData, indicator * i
 
         int const endRow = statement_.currentRow_ + statement_.rowsToConsume_;
 
+        // in binary mode, the binary format of the text types is the same as
+        // their text format, but all the other ones need to be decoded
+        Oid const typeOid = PQftype(statement_.result_, pos);
+        bool const binary = PQfformat(statement_.result_, pos) != 0 &&
+            !is_text_type(typeOid);
+
         for (int curRow = statement_.currentRow_, i = static_cast<int>(begin_);
              curRow != endRow; ++curRow, ++i)
         {
@@ -104,9 +151,17 @@ void postgresql_vector_into_type_backend::post_fetch(bool gotData, indicator * i
                 }
             }
 
-            // buffer with data retrieved from server, in text format
+            // buffer with data retrieved from server, in text format unless
+            // binary mode is used
             char * buf = PQgetvalue(statement_.result_, curRow, pos);
 
+            if (binary)
+            {
+                binary_to_exchange_type(element_ptr_(data_, type_, i), type_, buf,
+                    PQgetlength(statement_.result_, curRow, pos), typeOid);
+                continue;
+            }
+
             switch (type_)
             {
             case x_char:
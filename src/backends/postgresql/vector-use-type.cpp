@@ -63,6 +63,15 @@ void postgresql_vector_use_type_backend::pre_use(indicator const * ind)
         vend = end_var_;
     }
 
+    // release the buffers used by the previous execution, if any
+    clean_up();
+
+    if (prepare_binary(ind, vend))
+    {
+        register_buffers(&binaryBuffers_[0], &binaryLengths_[0]);
+        return;
+    }
+
     for (size_t i = begin_; i != vend; ++i)
     {
         char * buf;
@@ -202,18 +211,138 @@ void postgresql_vector_use_type_backend::pre_use(indicator const * ind)
         buffers_.push_back(buf);
     }
 
+    register_buffers(&buffers_[0], NULL);
+}
+
+void postgresql_vector_use_type_backend::register_buffers(char ** buffers,
+    int * binaryLengths)
+{
     if (position_ > 0)
     {
         // binding by position
-        statement_.useByPosBuffers_[position_] = &buffers_[0];
+        statement_.useByPosBuffers_[position_] = buffers;
+
+        if (binaryLengths != NULL)
+        {
+            statement_.useByPosBinaryLengths_[position_] = binaryLengths;
+        }
+        else
+        {
+            statement_.useByPosBinaryLengths_.erase(position_);
+        }
     }
     else
     {
         // binding by name
-        statement_.useByNameBuffers_[name_] = &buffers_[0];
+        statement_.useByNameBuffers_[name_] = buffers;
+
+        if (binaryLengths != NULL)
+        {
+            statement_.useByNameBinaryLengths_[name_] = binaryLengths;
+        }
+        else
+        {
+            statement_.useByNameBinaryLengths_.erase(name_);
+        }
     }
 }
 
+namespace // anonymous
+{
+
+template <typename T>
+T const & vector_element_(void * p, std::size_t indx)
+{
+    std::vector<T> const & v = *static_cast<std::vector<T> *>(p);
+    return v[indx];
+}
+
+} // namespace anonymous
+
+bool postgresql_vector_use_type_backend::prepare_binary(
+    indicator const * ind, std::size_t vend)
+{
+    Oid const paramType = statement_.get_binary_param_type(position_, name_);
+    if (paramType == 0)
+    {
+        return false;
+    }
+
+    // all binary values fit into 8 bytes, so use a single buffer for all of
+    // them, whose capacity is reused by the subsequent executions
+    std::size_t const valueSize = 8;
+    std::size_t const count = vend - begin_;
+    binaryBuffers_.resize(count);
+    binaryLengths_.resize(count);
+    binaryData_.resize(count * valueSize);
+
+    for (std::size_t i = begin_; i != vend; ++i)
+    {
+        std::size_t const n = i - begin_;
+
+        if (ind != NULL && ind[i] == i_null)
+        {
+            binaryBuffers_[n] = NULL;
+            binaryLengths_[n] = 0;
+            continue;
+        }
+
+        char * const buf = &binaryData_[n * valueSize];
+
+        int len;
+        switch (type_)
+        {
+        case x_short:
+            len = integer_to_binary(vector_element_<short>(data_, i),
+                paramType, buf);
+            break;
+        case x_integer:
+            len = integer_to_binary(vector_element_<int>(data_, i),
+                paramType, buf);
+            break;
+        case x_long_long:
+            len = integer_to_binary(vector_element_<long long>(data_, i),
+                paramType, buf);
+            break;
+        case x_unsigned_long_long:
+            {
+                unsigned long long const value
+                    = vector_element_<unsigned long long>(data_, i);
+                len = value <= static_cast<unsigned long long>(
+                        std::numeric_limits<long long>::max())
+                    ? integer_to_binary(static_cast<long long>(value),
+                        paramType, buf)
+                    : 0;
+            }
+            break;
+        case x_double:
+            len = double_to_binary(vector_element_<double>(data_, i),
+                paramType, buf);
+            break;
+        case x_stdtm:
+            len = std_tm_to_binary(vector_element_<std::tm>(data_, i),
+                paramType, buf, statement_.session_.integerDatetimes_);
+            break;
+
+        default:
+            // all the other types are always sent in text format
+            len = 0;
+            break;
+        }
+
+        if (len == 0)
+        {
+            // fall back to the text format for all the values
+            return false;
+        }
+
+        binaryBuffers_[n] = buf;
+        binaryLengths_[n] = len;
+    }
+
+    return true;
+}
+
 std::size_t postgresql_vector_use_type_backend::size()
 {
     // as a special error-detection measure, check if the actual vector size
@@ -285,4 +414,6 @@ void postgresql_vector_use_type_backend::clean_up()
     {
         delete [] buffers_[i];
     }
+
+    buffers_.clear();
 }
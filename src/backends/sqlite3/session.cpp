@@ -55,6 +55,7 @@ void check_sqlite_err(sqlite_api::sqlite3* conn, int res, char const* const errM
 
 sqlite3_session_backend::sqlite3_session_backend(
     connection_parameters const & parameters)
+    : bulkSavepoint_(false)
 {
     int timeout = 0;
     int connection_flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE;
@@ -113,6 +114,10 @@ sqlite3_session_backend::sqlite3_session_backend(
         {
             vfs = val;
         }
+        else if ("bulk_savepoint" == key)
+        {
+            bulkSavepoint_ = "true" == val || "1" == val;
+        }
 
     }
 
@@ -7,6 +7,8 @@
 
 #define SOCI_SQLITE3_SOURCE
 #include "soci/sqlite3/soci-sqlite3.h"
+#include "soci/column-batch.h"
+#include "soci-mktime.h"
 // std
 #include <algorithm>
 #include <cctype>
@@ -34,12 +36,14 @@ sqlite3_statement_backend::sqlite3_statement_backend(
     : session_(session)
     , stmt_(0)
     , dataCache_()
+    , dataCacheSize_(0)
     , useData_(0)
     , databaseReady_(false)
     , boundByName_(false)
     , boundByPos_(false)
     , hasVectorIntoElements_(false)
     , rowsAffectedBulk_(-1LL)
+    , columnBatch_(NULL)
 {
 }
 
@@ -60,6 +64,30 @@ void sqlite3_statement_backend::clean_up()
     }
 }
 
+bool sqlite3_statement_backend::reset_for_reuse()
+{
+    if (stmt_ == NULL)
+    {
+        return false;
+    }
+
+    // Resetting the statement ends its implicit transaction, which would
+    // otherwise keep the tables used by it locked.
+    sqlite3_reset(stmt_);
+    databaseReady_ = true;
+
+    rowsAffectedBulk_ = -1LL;
+    dataCacheSize_ = 0;
+    useData_.clear();
+    vectorUses_.clear();
+    boundByName_ = false;
+    boundByPos_ = false;
+    hasVectorIntoElements_ = false;
+    columnBatch_ = NULL;
+
+    return true;
+}
+
 void sqlite3_statement_backend::prepare(std::string const & query,
     statement_type /* eType */)
 {
@@ -130,14 +158,21 @@ sqlite3_statement_backend::load_rowset(int totalRows)
     }
     else
     {
-        // make the vector big enough to hold the data we need
-        dataCache_.resize(totalRows);
+        // make the vector big enough to hold the data we need, but keep the
+        // rows allocated by the previous fetches
+        if (dataCache_.size() < static_cast<std::size_t>(totalRows))
+        {
+            dataCache_.resize(totalRows);
+        }
         for (sqlite3_recordset::iterator it = dataCache_.begin(),
-            end = dataCache_.end(); it != end; ++it)
+            end = dataCache_.begin() + totalRows; it != end; ++it)
         {
             (*it).resize(numCols);
         }
 
+        dataCacheSize_ = 0;
+        dataBuffer_.clear();
+
         for (i = 0; i < totalRows && databaseReady_; ++i)
         {
             int const res = sqlite3_step(stmt_);
@@ -168,9 +203,9 @@ sqlite3_statement_backend::load_rowset(int totalRows)
                     {
                         case dt_string:
                         case dt_date:
-                            col.buffer_.size_ = sqlite3_column_bytes(stmt_, c);
-                            col.buffer_.data_ = new char[col.buffer_.size_+1];
-                            memcpy(col.buffer_.data_, sqlite3_column_text(stmt_, c), col.buffer_.size_+1);
+                            append_to_data_buffer(col,
+                                sqlite3_column_text(stmt_, c),
+                                sqlite3_column_bytes(stmt_, c));
                             break;
 
                         case dt_double:
@@ -187,9 +222,9 @@ sqlite3_statement_backend::load_rowset(int totalRows)
                             break;
 
                         case dt_blob:
-                            col.buffer_.size_ = sqlite3_column_bytes(stmt_, c);
-                            col.buffer_.data_ = (col.buffer_.size_ > 0 ? new char[col.buffer_.size_] : NULL);
-                            memcpy(col.buffer_.data_, sqlite3_column_blob(stmt_, c), col.buffer_.size_);
+                            append_to_data_buffer(col,
+                                sqlite3_column_blob(stmt_, c),
+                                sqlite3_column_bytes(stmt_, c));
                             break;
 
                         case dt_xml:
@@ -207,12 +242,148 @@ sqlite3_statement_backend::load_rowset(int totalRows)
             }
         }
     }
-    // if we read less than requested then shrink the vector
-    dataCache_.resize(i);
+
+    dataCacheSize_ = i;
+
+    // Now that the buffer won't be reallocated any more, make the columns
+    // point to their data in it: it was appended in the same order.
+    std::size_t offset = 0;
+    for (int r = 0; r < i; ++r)
+    {
+        for (int c = 0; c < numCols; ++c)
+        {
+            sqlite3_column &col = dataCache_[r][c];
+            if (col.isNull_)
+                continue;
+
+            switch (col.type_)
+            {
+                case dt_string:
+                case dt_date:
+                case dt_blob:
+                    col.buffer_.constData_ = &dataBuffer_[offset];
+                    offset += col.buffer_.size_ + 1;
+                    break;
+
+                default:
+                    break;
+            }
+        }
+    }
 
     return retVal;
 }
 
+// This is used for fetching into column_batch
+statement_backend::exec_fetch_result
+sqlite3_statement_backend::load_column_batch(int totalRows)
+{
+    statement_backend::exec_fetch_result retVal = ef_success;
+
+    int const numCols = static_cast<int>(columns_.size());
+
+    columnBatch_->clear_rows();
+
+    int i = 0;
+    for (; i < totalRows && databaseReady_; ++i)
+    {
+        int const res = sqlite3_step(stmt_);
+
+        if (SQLITE_DONE == res)
+        {
+            databaseReady_ = false;
+            retVal = ef_no_data;
+            break;
+        }
+        else if (SQLITE_ROW != res)
+        {
+            char const* zErrMsg = sqlite3_errmsg(session_.conn_);
+            std::ostringstream ss;
+            ss << "sqlite3_statement_backend::loadRS: "
+               << zErrMsg;
+            throw sqlite3_soci_error(ss.str(), res);
+        }
+
+        for (int c = 0; c < numCols; ++c)
+        {
+            if (sqlite3_column_type(stmt_, c) == SQLITE_NULL)
+            {
+                columnBatch_->append_null(c);
+                continue;
+            }
+
+            switch (columns_[c].type_)
+            {
+                case dt_string:
+                    columnBatch_->append_string(c,
+                        reinterpret_cast<char const*>(sqlite3_column_text(stmt_, c)),
+                        sqlite3_column_bytes(stmt_, c));
+                    break;
+
+                case dt_blob:
+                    columnBatch_->append_string(c,
+                        static_cast<char const*>(sqlite3_column_blob(stmt_, c)),
+                        sqlite3_column_bytes(stmt_, c));
+                    break;
+
+                case dt_date:
+                {
+                    std::tm t = std::tm();
+                    parse_std_tm(reinterpret_cast<char const*>(
+                        sqlite3_column_text(stmt_, c)), t);
+                    columnBatch_->append_date(c, t);
+                    break;
+                }
+
+                case dt_double:
+                    columnBatch_->append_double(c, sqlite3_column_double(stmt_, c));
+                    break;
+
+                case dt_integer:
+                    columnBatch_->append_int(c, sqlite3_column_int(stmt_, c));
+                    break;
+
+                case dt_long_long:
+                    columnBatch_->append_long_long(c,
+                        sqlite3_column_int64(stmt_, c));
+                    break;
+
+                case dt_unsigned_long_long:
+                    columnBatch_->append_unsigned_long_long(c,
+                        static_cast<unsigned long long>(
+                            sqlite3_column_int64(stmt_, c)));
+                    break;
+
+                case dt_xml:
+                    throw soci_error("XML data type is not supported");
+            }
+        }
+
+        columnBatch_->end_row();
+    }
+
+    if (!databaseReady_ && i == 0)
+    {
+        retVal = ef_no_data;
+    }
+
+    dataCacheSize_ = i;
+
+    return retVal;
+}
+
+void sqlite3_statement_backend::append_to_data_buffer(sqlite3_column &col,
+    void const *data, int size)
+{
+    // The pointer is only set once all the rows are loaded, see load_rowset().
+    col.buffer_.size_ = size;
+    col.buffer_.constData_ = NULL;
+
+    char const * const p = static_cast<char const *>(data);
+    dataBuffer_.insert(dataBuffer_.end(), p, p + size);
+    dataBuffer_.push_back('\0');
+}
+
 // This is used for non-bulk operations
 statement_backend::exec_fetch_result
 sqlite3_statement_backend::load_one()
@@ -243,7 +414,121 @@ sqlite3_statement_backend::load_one()
     return retVal;
 }
 
-// Execute statements once for every row of useData
+namespace // anonymous
+{
+
+int bind_column(sqlite3_stmt *stmt, int pos, sqlite3_column const &col)
+{
+    if (col.isNull_)
+    {
+        return sqlite3_bind_null(stmt, pos);
+    }
+
+    switch (col.type_)
+    {
+        case dt_string:
+            return sqlite3_bind_text(stmt, pos, col.buffer_.constData_, static_cast<int>(col.buffer_.size_), NULL);
+
+        case dt_date:
+            return sqlite3_bind_text(stmt, pos, col.buffer_.constData_, static_cast<int>(col.buffer_.size_), SQLITE_TRANSIENT);
+
+        case dt_double:
+            return sqlite3_bind_double(stmt, pos, col.double_);
+
+        case dt_integer:
+            return sqlite3_bind_int(stmt, pos, col.int32_);
+
+        case dt_long_long:
+        case dt_unsigned_long_long:
+            return sqlite3_bind_int64(stmt, pos, col.int64_);
+
+        case dt_blob:
+            return sqlite3_bind_blob(stmt, pos, col.buffer_.constData_, static_cast<int>(col.buffer_.size_), NULL);
+
+        case dt_xml:
+            throw soci_error("XML data type is not supported");
+    }
+
+    return SQLITE_OK;
+}
+
+// Wraps a bulk operation executed outside of any transaction in a savepoint,
+// so that all its rows are committed at once instead of one by one.
+//
+// Notice that the savepoint is released, and not rolled back, even if an
+// error occurs, to keep the rows processed before it, as without it. However
+// releasing the savepoint commits the transaction started by it, which can
+// fail, in which case all the rows are rolled back to ensure that the
+// connection doesn't stay inside a transaction the user didn't start.
+class bulk_savepoint
+{
+public:
+    explicit bulk_savepoint(sqlite_api::sqlite3 *conn) : conn_(conn), active_(false) {}
+
+    ~bulk_savepoint()
+    {
+        if (active_ && !do_release())
+        {
+            abort();
+        }
+    }
+
+    void begin()
+    {
+        int const res = sqlite3_exec(conn_, "SAVEPOINT soci_bulk", NULL, NULL, NULL);
+        if (SQLITE_OK != res)
+        {
+            throw sqlite3_soci_error("Failed to start bulk operation savepoint", res);
+        }
+
+        active_ = true;
+    }
+
+    void release()
+    {
+        if (!active_)
+        {
+            return;
+        }
+
+        active_ = false;
+
+        int const res = sqlite3_exec(conn_, "RELEASE soci_bulk", NULL, NULL, NULL);
+        if (SQLITE_OK != res)
+        {
+            abort();
+
+            throw sqlite3_soci_error("Failed to release bulk operation savepoint", res);
+        }
+    }
+
+private:
+    bool do_release()
+    {
+        return sqlite3_exec(conn_, "RELEASE soci_bulk", NULL, NULL, NULL) == SQLITE_OK;
+    }
+
+    // Undo all the changes done since the savepoint and end the transaction.
+    void abort()
+    {
+        if (sqlite3_exec(conn_, "ROLLBACK TO soci_bulk", NULL, NULL, NULL) != SQLITE_OK ||
+            !do_release())
+        {
+            // As the savepoint was only used outside of any transaction, this
+            // can only roll back the transaction started by it.
+            sqlite3_exec(conn_, "ROLLBACK", NULL, NULL, NULL);
+        }
+    }
+
+    sqlite_api::sqlite3 * const conn_;
+    bool active_;
+
+    SOCI_NOT_COPYABLE(bulk_savepoint)
+};
+
+} // namespace anonymous
+
+// Execute statements once for every row of useData and vector use elements
 statement_backend::exec_fetch_result
 sqlite3_statement_backend::bind_and_execute(int number)
 {
@@ -253,60 +538,49 @@ sqlite3_statement_backend::bind_and_execute(int number)
 
     rowsAffectedBulk_ = -1;
 
-    int const rows = static_cast<int>(useData_.size());
+    // The values of the vector use elements are bound directly from their
+    // vectors for each row, while those of the single ones are the same for
+    // all rows.
+    int const rows = vectorUses_.empty()
+        ? static_cast<int>(useData_.size())
+        : static_cast<int>(vectorUses_.front()->size());
+
+    bulk_savepoint savepoint(session_.conn_);
+    if (rows > 1 && session_.bulkSavepoint_ && sqlite3_get_autocommit(session_.conn_))
+    {
+        savepoint.begin();
+    }
+
     for (int row = 0; row < rows; ++row)
     {
         sqlite3_reset(stmt_);
 
-        int const totalPositions = static_cast<int>(useData_[0].size());
-        for (int pos = 1; pos <= totalPositions; ++pos)
+        int bindRes = SQLITE_OK;
+        if (!useData_.empty())
         {
-            int bindRes = SQLITE_OK;
-            const sqlite3_column &col = useData_[row][pos-1];
-            if (col.isNull_)
+            sqlite3_row const &useRow = useData_[0];
+            int const totalPositions = static_cast<int>(useRow.size());
+            for (int pos = 1; pos <= totalPositions && SQLITE_OK == bindRes; ++pos)
             {
-                bindRes = sqlite3_bind_null(stmt_, pos);
+                bindRes = bind_column(stmt_, pos, useRow[pos-1]);
             }
-            else
-            {
-                switch (col.type_)
-                {
-                    case dt_string:
-                        bindRes = sqlite3_bind_text(stmt_, pos, col.buffer_.constData_, static_cast<int>(col.buffer_.size_), NULL);
-                        break;
-
-                    case dt_date:
-                        bindRes = sqlite3_bind_text(stmt_, pos, col.buffer_.constData_, static_cast<int>(col.buffer_.size_), SQLITE_TRANSIENT);
-                        break;
-
-                    case dt_double:
-                        bindRes = sqlite3_bind_double(stmt_, pos, col.double_);
-                        break;
-
-                    case dt_integer:
-                        bindRes = sqlite3_bind_int(stmt_, pos, col.int32_);
-                        break;
-
-                    case dt_long_long:
-                    case dt_unsigned_long_long:
-                        bindRes = sqlite3_bind_int64(stmt_, pos, col.int64_);
-                        break;
+        }
 
-                    case dt_blob:
-                        bindRes = sqlite3_bind_blob(stmt_, pos, col.buffer_.constData_, static_cast<int>(col.buffer_.size_), NULL);
-                        break;
+        for (std::size_t n = 0; n != vectorUses_.size() && SQLITE_OK == bindRes; ++n)
+        {
+            bindRes = vectorUses_[n]->bind_row(row);
+        }
 
-                    case dt_xml:
-                        throw soci_error("XML data type is not supported");
-                }
-            }
+        if (SQLITE_OK != bindRes)
+        {
+            // preserve the number of rows affected so far.
+            rowsAffectedBulk_ = rowsAffectedBulkTemp;
+            throw sqlite3_soci_error("Failure to bind on bulk operations", bindRes);
+        }
 
-            if (SQLITE_OK != bindRes)
-            {
-                // preserve the number of rows affected so far.
-                rowsAffectedBulk_ = rowsAffectedBulkTemp;
-                throw sqlite3_soci_error("Failure to bind on bulk operations", bindRes);
-            }
+        if (columnBatch_ != NULL)
+        {
+            return load_column_batch(number);
         }
 
         // Handle the case where there are both into and use elements
@@ -321,6 +595,8 @@ sqlite3_statement_backend::bind_and_execute(int number)
         rowsAffectedBulkTemp += get_affected_rows();
     }
 
+    savepoint.release();
+
     rowsAffectedBulk_ = rowsAffectedBulkTemp;
     return retVal;
 }
@@ -338,7 +614,7 @@ sqlite3_statement_backend::execute(int number)
 
     statement_backend::exec_fetch_result retVal = ef_no_data;
 
-    if (useData_.empty() == false)
+    if (useData_.empty() == false || vectorUses_.empty() == false)
     {
            retVal = bind_and_execute(number);
     }
@@ -353,6 +629,9 @@ sqlite3_statement_backend::execute(int number)
 statement_backend::exec_fetch_result
 sqlite3_statement_backend::fetch(int number)
 {
+    if (columnBatch_ != NULL)
+        return load_column_batch(number);
+
     if (hasVectorIntoElements_ || number == 0)
         return load_rowset(number);
     else
@@ -360,6 +639,15 @@ sqlite3_statement_backend::fetch(int number)
 
 }
 
+bool sqlite3_statement_backend::cancel()
+{
+    // This is safe to call from another thread and only interrupts the
+    // statements running on this connection, as SQLite forgets about the
+    // interruption as soon as none of them is running any more.
+    sqlite3_interrupt(session_.conn_);
+    return true;
+}
+
 long long sqlite3_statement_backend::get_affected_rows()
 {
     if (rowsAffectedBulk_ >= 0)
@@ -371,7 +659,13 @@ long long sqlite3_statement_backend::get_affected_rows()
 
 int sqlite3_statement_backend::get_number_of_rows()
 {
-    return static_cast<int>(dataCache_.size());
+    return static_cast<int>(dataCacheSize_);
+}
+
+bool sqlite3_statement_backend::set_column_batch(column_batch * batch)
+{
+    columnBatch_ = batch;
+    return true;
 }
 
 std::string sqlite3_statement_backend::get_parameter_name(int index) const
@@ -129,7 +129,7 @@ void sqlite3_vector_into_type_backend::post_fetch(bool gotData, indicator * ind)
         return;
     }
 
-    int const endRow = static_cast<int>(statement_.dataCache_.size());
+    int const endRow = statement_.get_number_of_rows();
     for (int i = 0; i < endRow; ++i)
     {
         sqlite3_column &col = statement_.dataCache_[i][position_-1];
@@ -197,8 +197,13 @@ void sqlite3_vector_into_type_backend::post_fetch(bool gotData, indicator * ind)
                     case dt_date:
                     case dt_string:
                     case dt_blob:
-                        set_in_vector(data_, i, std::string(col.buffer_.constData_, col.buffer_.size_));
+                    {
+                        // assign in place to reuse the string memory
+                        std::vector<std::string> &v
+                            = *static_cast<std::vector<std::string>*>(data_);
+                        v[i].assign(col.buffer_.constData_, col.buffer_.size_);
                         break;
+                    }
 
                     case dt_double:
                         set_in_vector(data_, i, double_to_cstring(col.double_));
@@ -278,26 +283,6 @@ void sqlite3_vector_into_type_backend::post_fetch(bool gotData, indicator * ind)
             default:
                 throw soci_error("Into element used with non-supported type.");
         }
-
-        // cleanup data
-        switch (col.type_)
-        {
-            case dt_date:
-            case dt_string:
-            case dt_blob:
-                delete[] col.buffer_.data_;
-                col.buffer_.data_ = NULL;
-                break;
-
-            case dt_double:
-            case dt_integer:
-            case dt_long_long:
-            case dt_unsigned_long_long:
-                break;
-
-            case dt_xml:
-                throw soci_error("XML data type is not supported");
-        }
     }
 }
 
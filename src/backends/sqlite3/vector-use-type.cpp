@@ -12,6 +12,7 @@
 #include "soci-dtocstr.h"
 #include "common.h"
 // std
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -38,6 +39,7 @@ void sqlite3_vector_use_type_backend::bind_by_pos(int & position,
     position_ = position++;
 
     statement_.boundByPos_ = true;
+    statement_.vectorUses_.push_back(this);
 }
 
 void sqlite3_vector_use_type_backend::bind_by_name(std::string const & name,
@@ -64,97 +66,89 @@ void sqlite3_vector_use_type_backend::bind_by_name(std::string const & name,
         throw soci_error(ss.str());
     }
     statement_.boundByName_ = true;
+    statement_.vectorUses_.push_back(this);
 }
 
 void sqlite3_vector_use_type_backend::pre_use(indicator const * ind)
 {
-    std::size_t const vsize = size();
+    // The values are bound directly from the vector by bind_row() when the
+    // statement is executed, so just remember the indicators to use.
+    ind_ = ind;
+}
+
+namespace // anonymous
+{
 
-    // make sure that useData can hold enough rows
-    if (statement_.useData_.size() != vsize)
-        statement_.useData_.resize(vsize);
+template <exchange_type e>
+typename exchange_type_traits<e>::value_type const &
+vector_element(void *data, std::size_t row)
+{
+    return (*static_cast<std::vector<
+        typename exchange_type_traits<e>::value_type> *>(data))[row];
+}
 
-    int const pos = position_ - 1;
+} // namespace anonymous
 
-    for (size_t i = 0; i != vsize; ++i)
+int sqlite3_vector_use_type_backend::bind_row(std::size_t row)
+{
+    sqlite_api::sqlite3_stmt * const stmt = statement_.stmt_;
+
+    // the data in vector can be either i_ok or i_null
+    if (ind_ != NULL && ind_[row] == i_null)
     {
-        // make sure that each row can accomodate the number of columns
-        if (statement_.useData_[i].size() < static_cast<std::size_t>(position_))
-            statement_.useData_[i].resize(position_);
+        return sqlite3_bind_null(stmt, position_);
+    }
 
-        sqlite3_column &col = statement_.useData_[i][pos];
+    // Notice that the data is bound using SQLITE_STATIC as it remains valid
+    // until the statement is executed and the next row is bound.
+    switch (type_)
+    {
+        case x_char:
+            return sqlite3_bind_text(stmt, position_,
+                &vector_element<x_char>(data_, row), 1, SQLITE_STATIC);
 
-        // the data in vector can be either i_ok or i_null
-        if (ind != NULL && ind[i] == i_null)
+        case x_stdstring:
         {
-            col.isNull_ = true;
-            col.buffer_.data_ = NULL;
-            continue;
+            std::string const &s = vector_element<x_stdstring>(data_, row);
+            return sqlite3_bind_text(stmt, position_,
+                s.c_str(), static_cast<int>(s.size()), SQLITE_STATIC);
         }
 
-        col.isNull_ = false;
+        case x_short:
+            return sqlite3_bind_int(stmt, position_,
+                vector_element<x_short>(data_, row));
+
+        case x_integer:
+            return sqlite3_bind_int(stmt, position_,
+                vector_element<x_integer>(data_, row));
 
-        switch (type_)
+        case x_long_long:
+            return sqlite3_bind_int64(stmt, position_,
+                vector_element<x_long_long>(data_, row));
+
+        case x_unsigned_long_long:
+            return sqlite3_bind_int64(stmt, position_,
+                static_cast<sqlite_api::sqlite3_int64>(
+                    vector_element<x_unsigned_long_long>(data_, row)));
+
+        case x_double:
+            return sqlite3_bind_double(stmt, position_,
+                vector_element<x_double>(data_, row));
+
+        case x_stdtm:
         {
-            case x_char:
-                col.type_ = dt_string;
-                col.buffer_.constData_ = &(*static_cast<std::vector<exchange_type_traits<x_char>::value_type> *>(data_))[i];
-                col.buffer_.size_ = 1;
-                break;
-
-            case x_stdstring:
-            {
-                std::string &s = (*static_cast<std::vector<exchange_type_traits<x_stdstring>::value_type> *>(data_))[i];
-                col.type_ = dt_string;
-                col.buffer_.constData_ = s.c_str();
-                col.buffer_.size_ = s.size();
-                break;
-            }
-
-            case x_short:
-                col.type_ = dt_integer;
-                col.int32_ = (*static_cast<std::vector<exchange_type_traits<x_short>::value_type> *>(data_))[i];
-                break;
-
-            case x_integer:
-                col.type_ = dt_integer;
-                col.int32_ = (*static_cast<std::vector<exchange_type_traits<x_integer>::value_type> *>(data_))[i];
-                break;
-
-            case x_long_long:
-                col.type_ = dt_long_long;
-                col.int64_ = (*static_cast<std::vector<exchange_type_traits<x_long_long>::value_type> *>(data_))[i];
-                break;
-
-            case x_unsigned_long_long:
-                col.type_ = dt_long_long;
-                col.int64_ = (*static_cast<std::vector<exchange_type_traits<x_unsigned_long_long>::value_type> *>(data_))[i];
-                break;
-
-            case x_double:
-                col.type_ = dt_double;
-                col.double_ = (*static_cast<std::vector<exchange_type_traits<x_double>::value_type> *>(data_))[i];
-                break;
-
-            case x_stdtm:
-            {
-                std::tm &tm = (*static_cast<std::vector<exchange_type_traits<x_stdtm>::value_type> *>(data_))[i];
-                static const size_t bufSize = 20;
-
-                col.type_ = dt_date;
-                col.buffer_.data_ = new char[bufSize];
-                col.buffer_.size_
-                    = snprintf(col.buffer_.data_, bufSize, "%d-%02d-%02d %02d:%02d:%02d",
-                        tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
-                        tm.tm_hour, tm.tm_min, tm.tm_sec
-                    );
-                break;
-            }
-
-            default:
-                throw soci_error(
-                    "Use vector element used with non-supported type.");
+            std::tm const &tm = vector_element<x_stdtm>(data_, row);
+            int const len = snprintf(dateBuffer_, sizeof(dateBuffer_),
+                "%d-%02d-%02d %02d:%02d:%02d",
+                tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
+                tm.tm_hour, tm.tm_min, tm.tm_sec);
+            return sqlite3_bind_text(stmt, position_,
+                dateBuffer_, len, SQLITE_STATIC);
         }
+
+        default:
+            throw soci_error(
+                "Use vector element used with non-supported type.");
     }
 }
 
@@ -197,19 +191,6 @@ std::size_t sqlite3_vector_use_type_backend::size()
 
 void sqlite3_vector_use_type_backend::clean_up()
 {
-    if (type_ != x_stdtm)
-        return;
-
-    int const pos = position_ - 1;
-
-    for (sqlite3_recordset::iterator iter = statement_.useData_.begin(), last = statement_.useData_.end();
-        iter != last; ++iter)
-    {
-        sqlite3_column &col = (*iter)[pos];
-
-        if (col.isNull_)
-            continue;
-
-        delete[] col.buffer_.data_;
-    }
+    std::vector<sqlite3_vector_use_type_backend *> &uses = statement_.vectorUses_;
+    uses.erase(std::remove(uses.begin(), uses.end(), this), uses.end());
 }
@@ -0,0 +1,338 @@
+//
+// Copyright (C) 2004-2008 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define SOCI_SOURCE
+#include "soci/column-batch.h"
+
+#include <cctype>
+#include <cstddef>
+#include <sstream>
+#include <string>
+
+using namespace soci;
+using namespace details;
+
+namespace // anonymous
+{
+
+// Check whether the values of this type are stored as bytes.
+bool is_variable_size(data_type type)
+{
+    return type == dt_string || type == dt_blob || type == dt_xml;
+}
+
+} // namespace anonymous
+
+column_batch::column_batch(std::size_t capacity)
+    : capacity_(capacity)
+    , size_(0)
+    , uppercaseColumnNames_(false)
+{
+}
+
+column_properties const & column_batch::get_properties(std::size_t col) const
+{
+    return columns_.at(col).props_;
+}
+
+column_properties const &
+column_batch::get_properties(std::string const & name) const
+{
+    return get_properties(find_column(name));
+}
+
+std::size_t column_batch::find_column(std::string const & name) const
+{
+    // As with row, the last column with the given name is found if there are
+    // several of them.
+    for (std::size_t i = columns_.size(); i != 0; --i)
+    {
+        if (columns_[i - 1].props_.get_name() == name)
+        {
+            return i - 1;
+        }
+    }
+
+    std::ostringstream msg;
+    msg << "Column '" << name << "' not found";
+    throw soci_error(msg.str());
+}
+
+bool column_batch::is_null(std::size_t col, std::size_t row) const
+{
+    if (row >= size_)
+    {
+        throw soci_error("Row index out of range.");
+    }
+
+    return (columns_.at(col).validity_[row / 8] & (1 << (row % 8))) == 0;
+}
+
+unsigned char const * column_batch::get_validity(std::size_t col) const
+{
+    std::vector<unsigned char> const & validity = columns_.at(col).validity_;
+    return validity.empty() ? NULL : &validity[0];
+}
+
+column_batch::column const &
+column_batch::get_column(std::size_t col, data_type type) const
+{
+    column const & c = columns_.at(col);
+
+    data_type const colType = c.props_.get_data_type();
+    if (colType != type && !(is_variable_size(type) && is_variable_size(colType)))
+    {
+        std::ostringstream msg;
+        msg << "Column " << col << " ('" << c.props_.get_name()
+            << "') doesn't have the requested type";
+        throw soci_error(msg.str());
+    }
+
+    return c;
+}
+
+namespace soci
+{
+
+template <>
+int const * column_batch::get_values<int>(std::size_t col) const
+{
+    std::vector<int> const & v = get_column(col, dt_integer).ints_;
+    return v.empty() ? NULL : &v[0];
+}
+
+template <>
+long long const * column_batch::get_values<long long>(std::size_t col) const
+{
+    std::vector<long long> const & v = get_column(col, dt_long_long).longLongs_;
+    return v.empty() ? NULL : &v[0];
+}
+
+template <>
+unsigned long long const *
+column_batch::get_values<unsigned long long>(std::size_t col) const
+{
+    std::vector<unsigned long long> const & v
+        = get_column(col, dt_unsigned_long_long).unsignedLongLongs_;
+    return v.empty() ? NULL : &v[0];
+}
+
+template <>
+double const * column_batch::get_values<double>(std::size_t col) const
+{
+    std::vector<double> const & v = get_column(col, dt_double).doubles_;
+    return v.empty() ? NULL : &v[0];
+}
+
+template <>
+std::tm const * column_batch::get_values<std::tm>(std::size_t col) const
+{
+    std::vector<std::tm> const & v = get_column(col, dt_date).dates_;
+    return v.empty() ? NULL : &v[0];
+}
+
+} // namespace soci
+
+std::size_t const * column_batch::get_offsets(std::size_t col) const
+{
+    return &get_column(col, dt_string).offsets_[0];
+}
+
+char const * column_batch::get_bytes(std::size_t col) const
+{
+    std::vector<char> const & bytes = get_column(col, dt_string).bytes_;
+    return bytes.empty() ? NULL : &bytes[0];
+}
+
+char const * column_batch::get_string(std::size_t col, std::size_t row,
+    std::size_t & length) const
+{
+    column const & c = get_column(col, dt_string);
+    if (row >= size_)
+    {
+        throw soci_error("Row index out of range.");
+    }
+
+    std::size_t const start = c.offsets_[row];
+    length = c.offsets_[row + 1] - start;
+
+    return length == 0 ? "" : &c.bytes_[start];
+}
+
+void column_batch::uppercase_column_names(bool forceToUpper)
+{
+    uppercaseColumnNames_ = forceToUpper;
+}
+
+void column_batch::add_column(column_properties const & props)
+{
+    columns_.push_back(column());
+
+    column & c = columns_.back();
+    c.props_ = props;
+
+    if (uppercaseColumnNames_)
+    {
+        std::string const & originalName = props.get_name();
+
+        std::string columnName;
+        for (std::size_t i = 0; i != originalName.size(); ++i)
+        {
+            columnName.push_back(static_cast<char>(std::toupper(originalName[i])));
+        }
+
+        c.props_.set_name(columnName);
+    }
+
+    // Allocate the memory for the fixed size values only once, the bytes of
+    // the variable size ones will grow as needed.
+    c.validity_.reserve((capacity_ + 7) / 8);
+    switch (props.get_data_type())
+    {
+    case dt_integer:
+        c.ints_.reserve(capacity_);
+        break;
+    case dt_long_long:
+        c.longLongs_.reserve(capacity_);
+        break;
+    case dt_unsigned_long_long:
+        c.unsignedLongLongs_.reserve(capacity_);
+        break;
+    case dt_double:
+        c.doubles_.reserve(capacity_);
+        break;
+    case dt_date:
+        c.dates_.reserve(capacity_);
+        break;
+    case dt_string:
+    case dt_blob:
+    case dt_xml:
+        c.offsets_.reserve(capacity_ + 1);
+        break;
+    }
+
+    clear_rows();
+}
+
+void column_batch::clean_up()
+{
+    columns_.clear();
+    size_ = 0;
+}
+
+void column_batch::clear_rows()
+{
+    for (std::vector<column>::iterator it = columns_.begin();
+         it != columns_.end(); ++it)
+    {
+        it->validity_.assign((capacity_ + 7) / 8, 0);
+        it->ints_.clear();
+        it->longLongs_.clear();
+        it->unsignedLongLongs_.clear();
+        it->doubles_.clear();
+        it->dates_.clear();
+        it->offsets_.assign(1, 0);
+        it->bytes_.clear();
+    }
+
+    size_ = 0;
+}
+
+column_batch::column &
+column_batch::get_column_for_append(std::size_t col, data_type type)
+{
+    if (size_ == capacity_)
+    {
+        throw soci_error("Too many rows appended to the column batch.");
+    }
+
+    return const_cast<column &>(get_column(col, type));
+}
+
+void column_batch::set_valid(column & c)
+{
+    c.validity_[size_ / 8] |= static_cast<unsigned char>(1 << (size_ % 8));
+}
+
+void column_batch::append_null(std::size_t col)
+{
+    column & c = get_column_for_append(col, columns_.at(col).props_.get_data_type());
+
+    switch (c.props_.get_data_type())
+    {
+    case dt_integer:
+        c.ints_.push_back(0);
+        break;
+    case dt_long_long:
+        c.longLongs_.push_back(0);
+        break;
+    case dt_unsigned_long_long:
+        c.unsignedLongLongs_.push_back(0);
+        break;
+    case dt_double:
+        c.doubles_.push_back(0.);
+        break;
+    case dt_date:
+        c.dates_.push_back(std::tm());
+        break;
+    case dt_string:
+    case dt_blob:
+    case dt_xml:
+        c.offsets_.push_back(c.bytes_.size());
+        break;
+    }
+}
+
+void column_batch::append_int(std::size_t col, int value)
+{
+    column & c = get_column_for_append(col, dt_integer);
+    c.ints_.push_back(value);
+    set_valid(c);
+}
+
+void column_batch::append_long_long(std::size_t col, long long value)
+{
+    column & c = get_column_for_append(col, dt_long_long);
+    c.longLongs_.push_back(value);
+    set_valid(c);
+}
+
+void column_batch::append_unsigned_long_long(std::size_t col,
+    unsigned long long value)
+{
+    column & c = get_column_for_append(col, dt_unsigned_long_long);
+    c.unsignedLongLongs_.push_back(value);
+    set_valid(c);
+}
+
+void column_batch::append_double(std::size_t col, double value)
+{
+    column & c = get_column_for_append(col, dt_double);
+    c.doubles_.push_back(value);
+    set_valid(c);
+}
+
+void column_batch::append_date(std::size_t col, std::tm const & value)
+{
+    column & c = get_column_for_append(col, dt_date);
+    c.dates_.push_back(value);
+    set_valid(c);
+}
+
+void column_batch::append_string(std::size_t col, char const * data,
+    std::size_t length)
+{
+    column & c = get_column_for_append(col, dt_string);
+    c.bytes_.insert(c.bytes_.end(), data, data + length);
+    c.offsets_.push_back(c.bytes_.size());
+    set_valid(c);
+}
+
+void column_batch::end_row()
+{
+    ++size_;
+}
@@ -9,118 +9,336 @@
 #include "soci/connection-pool.h"
 #include "soci/error.h"
 #include "soci/session.h"
+#include "soci-clock.h"
+#include "soci-thread.h"
+#include <exception>
+#include <list>
+#include <string>
 #include <vector>
-#include <utility>
 
 #ifndef _WIN32
-// POSIX implementation
-
 #include <pthread.h>
 #include <sys/time.h>
 #include <errno.h>
+#else
+#include <windows.h>
+#endif
 
 using namespace soci;
+using namespace soci::details;
+
+namespace // anonymous
+{
+
+// Interval between the attempts to reconnect a broken session.
+long long const reconnect_retry_interval_ns = 1000000000LL;
+
+// Thread waiting for a session to become available.
+//
+// Waiters are queued in FIFO order and the sessions given back to the pool are
+// handed over directly to the first of them, so that the waiting threads are
+// served fairly and can't be overtaken by the threads calling lease() later.
+struct pool_waiter
+{
+    pool_waiter() : pos_(0), granted_(false) {}
+
+    std::size_t pos_;
+    bool granted_;
+
+#ifndef _WIN32
+    pthread_cond_t cond_;
+#else
+    HANDLE event_;
+#endif
+};
+
+} // namespace anonymous
 
 struct connection_pool::connection_pool_impl
 {
-    bool find_free(std::size_t & pos)
+    enum entry_state
+    {
+        es_free,        // connected and available for leasing
+        es_leased,      // used by some thread
+        es_closed,      // not connected yet or closed because it was idle
+        es_opening,     // waiting to be opened in the background
+        es_broken       // waiting to be reconnected in the background
+    };
+
+    struct entry
     {
-        for (std::size_t i = 0; i != sessions_.size(); ++i)
+        entry()
+            : session_(NULL), state_(es_free), leasedAt_(0), lastUsed_(0)
         {
-            if (sessions_[i].first)
-            {
-                pos = i;
-                return true;
-            }
         }
 
-        return false;
+        session * session_;
+        entry_state state_;
+        long long leasedAt_;
+        long long lastUsed_;
+    };
+
+    connection_pool_impl()
+        : elastic_(false), validate_(false), minSize_(0), idleTimeoutNs_(-1),
+          stopping_(false)
+    {
     }
 
-    // by convention, first == true means the entry is free (not used)
-    std::vector<std::pair<bool, session *> > sessions_;
+    // All the functions below must be called with the mutex locked.
+
+    void mark_leased(std::size_t pos, long long now)
+    {
+        entry & e = entries_[pos];
+        e.state_ = es_leased;
+        e.leasedAt_ = now;
+
+        ++stats_.inUse;
+        ++stats_.leases;
+    }
+
+    // Take a leased entry back from its user, who isn't going to use it.
+    void unmark_leased()
+    {
+        --stats_.inUse;
+        --stats_.leases;
+    }
+
+    // Give an entry which can be used to the first waiter or put it in the
+    // free list.
+    void release(std::size_t pos, long long now)
+    {
+        if (!waiters_.empty())
+        {
+            hand_over(pos, now);
+            return;
+        }
+
+        entry & e = entries_[pos];
+        e.state_ = es_free;
+        e.lastUsed_ = now;
+        free_.push_back(pos);
+    }
+
+    // Same as release() but for the entries which are not connected: they
+    // are opened in the background if anybody is waiting for them.
+    void release_closed(std::size_t pos)
+    {
+        if (!waiters_.empty())
+        {
+            open_in_background(pos);
+            return;
+        }
+
+        entries_[pos].state_ = es_closed;
+        closed_.push_back(pos);
+    }
+
+    // Ask the maintenance thread to open the session of the given entry,
+    // which will be released once it's connected.
+    void open_in_background(std::size_t pos)
+    {
+        entries_[pos].state_ = es_opening;
+        opening_.push_back(pos);
+        ++stats_.openSessions;
+
+        signal_maintenance();
+    }
+
+    void hand_over(std::size_t pos, long long now)
+    {
+        pool_waiter & w = *waiters_.front();
+        waiters_.pop_front();
+
+        w.pos_ = pos;
+        w.granted_ = true;
+        mark_leased(pos, now);
+
+        wake(w);
+    }
+
+    // Find an entry to lease, waiting for it if necessary. Returns false if
+    // none became available before the timeout expiration.
+    bool acquire(std::size_t & pos, int timeout, long long start);
+
+    // Used by the elastic pools only.
+    static void open_entry(void * arg);
+    static void maintenance_thread(void * arg);
+    void do_maintenance();
+
+    // (Re)connect the session of the given entry, which must be owned by the
+    // maintenance thread, without keeping the mutex locked while doing it.
+    bool connect_entry(std::size_t pos);
+
+    // Platform-specific functions, see below.
+    void init_sync();
+    void destroy_sync();
+    void lock();
+    void unlock();
+
+    // Wait until the given waiter gets a session or the timeout expires,
+    // return true if the session was obtained. The mutex is released while
+    // waiting and locked again on return.
+    bool wait(pool_waiter & w, int timeout);
+
+    // Wake up the waiter which was given a session.
+    void wake(pool_waiter & w);
+
+    // Wait until signal_maintenance() is called or the given timeout, in
+    // nanoseconds, expires. Negative timeout means waiting indefinitely.
+    void wait_maintenance(long long timeoutNs);
+    void signal_maintenance();
+
+    // Helper locking the mutex for the duration of the scope.
+    class scoped_lock
+    {
+    public:
+        explicit scoped_lock(connection_pool_impl & impl)
+            : impl_(impl)
+        {
+            impl_.lock();
+        }
+
+        ~scoped_lock()
+        {
+            impl_.unlock();
+        }
+
+    private:
+        connection_pool_impl & impl_;
+
+        SOCI_NOT_COPYABLE(scoped_lock)
+    };
+
+    std::vector<entry> entries_;
+
+    // Positions of the free entries used as a stack, so that the session given
+    // back most recently, which is the most likely to be "warm", is reused
+    // first. This list is always empty if there are any waiters.
+    std::vector<std::size_t> free_;
+
+    // Positions of the entries which are not connected currently, of those
+    // being opened because someone needs them and of the broken ones (all of
+    // them are only used by the elastic pools).
+    std::vector<std::size_t> closed_;
+    std::vector<std::size_t> opening_;
+    std::vector<std::size_t> broken_;
+
+    std::list<pool_waiter *> waiters_;
+
+    connection_pool_stats stats_;
+
+    // Elastic pool parameters.
+    bool elastic_;
+    bool validate_;
+    connection_parameters parameters_;
+    std::size_t minSize_;
+    long long idleTimeoutNs_;
+
+    // The thread reconnecting the broken sessions and closing the idle ones
+    // and the flag telling it to exit.
+    thread_handle maintenanceThread_;
+    bool stopping_;
+
+#ifndef _WIN32
     pthread_mutex_t mtx_;
-    pthread_cond_t cond_;
+    pthread_cond_t maintenanceCond_;
+#else
+    CRITICAL_SECTION mtx_;
+    HANDLE maintenanceEvent_;
+#endif
 };
 
-connection_pool::connection_pool(std::size_t size)
+#ifndef _WIN32
+// POSIX implementation
+
+namespace // anonymous
 {
-    if (size == 0)
-    {
-        throw soci_error("Invalid pool size");
-    }
 
-    pimpl_ = new connection_pool_impl();
-    pimpl_->sessions_.resize(size);
-    for (std::size_t i = 0; i != size; ++i)
+// Compute the absolute time corresponding to the given timeout.
+void make_deadline(struct timespec & tm, long long timeoutNs)
+{
+    struct timeval tmv;
+    gettimeofday(&tmv, NULL);
+
+    long long const nsec = tmv.tv_usec * 1000LL + timeoutNs % 1000000000LL;
+
+    tm.tv_sec = tmv.tv_sec + static_cast<time_t>(timeoutNs / 1000000000LL);
+    tm.tv_nsec = static_cast<long>(nsec);
+
+    if (tm.tv_nsec >= 1000 * 1000 * 1000)
     {
-        pimpl_->sessions_[i] = std::make_pair(true, new session());
+        ++tm.tv_sec;
+        tm.tv_nsec -= 1000 * 1000 * 1000;
     }
+}
 
-    int cc = pthread_mutex_init(&(pimpl_->mtx_), NULL);
+} // namespace anonymous
+
+void connection_pool::connection_pool_impl::init_sync()
+{
+    int cc = pthread_mutex_init(&mtx_, NULL);
     if (cc != 0)
     {
         throw soci_error("Synchronization error");
     }
 
-    cc = pthread_cond_init(&(pimpl_->cond_), NULL);
+    cc = pthread_cond_init(&maintenanceCond_, NULL);
     if (cc != 0)
     {
+        pthread_mutex_destroy(&mtx_);
         throw soci_error("Synchronization error");
     }
 }
 
-connection_pool::~connection_pool()
+void connection_pool::connection_pool_impl::destroy_sync()
 {
-    for (std::size_t i = 0; i != pimpl_->sessions_.size(); ++i)
+    pthread_mutex_destroy(&mtx_);
+    pthread_cond_destroy(&maintenanceCond_);
+}
+
+void connection_pool::connection_pool_impl::lock()
+{
+    int cc = pthread_mutex_lock(&mtx_);
+    if (cc != 0)
     {
-        delete pimpl_->sessions_[i].second;
+        throw soci_error("Synchronization error");
     }
+}
 
-    pthread_mutex_destroy(&(pimpl_->mtx_));
-    pthread_cond_destroy(&(pimpl_->cond_));
-
-    delete pimpl_;
+void connection_pool::connection_pool_impl::unlock()
+{
+    pthread_mutex_unlock(&mtx_);
 }
 
-bool connection_pool::try_lease(std::size_t & pos, int timeout)
+bool connection_pool::connection_pool_impl::wait(pool_waiter & w, int timeout)
 {
+    // timeout is relative in milliseconds
     struct timespec tm;
     if (timeout >= 0)
     {
-        // timeout is relative in milliseconds
-
-        struct timeval tmv;
-        gettimeofday(&tmv, NULL);
-
-        tm.tv_sec = tmv.tv_sec + timeout / 1000;
-        tm.tv_nsec = tmv.tv_usec * 1000 + (timeout % 1000) * 1000 * 1000;
-
-        if (tm.tv_nsec >= 1000 * 1000 * 1000)
-        {
-            ++tm.tv_sec;
-            tm.tv_nsec -= 1000 * 1000 * 1000;
-        }
+        make_deadline(tm, timeout * 1000000LL);
     }
 
-    int cc = pthread_mutex_lock(&(pimpl_->mtx_));
+    int cc = pthread_cond_init(&w.cond_, NULL);
     if (cc != 0)
     {
         throw soci_error("Synchronization error");
     }
 
-    while (pimpl_->find_free(pos) == false)
+    std::list<pool_waiter *>::iterator const
+        it = waiters_.insert(waiters_.end(), &w);
+
+    while (!w.granted_)
     {
         if (timeout < 0)
         {
             // no timeout, allow unlimited blocking
-            cc = pthread_cond_wait(&(pimpl_->cond_), &(pimpl_->mtx_));
+            cc = pthread_cond_wait(&w.cond_, &mtx_);
         }
         else
         {
             // wait with timeout
-            cc = pthread_cond_timedwait(
-                &(pimpl_->cond_), &(pimpl_->mtx_), &tm);
+            cc = pthread_cond_timedwait(&w.cond_, &mtx_, &tm);
         }
 
         if (cc == ETIMEDOUT)
@@ -139,14 +357,209 @@ bool connection_pool::try_lease(std::size_t & pos, int timeout)
         }
     }
 
-    if (cc == 0)
+    // Notice that the session could have been given to us even if the wait
+    // timed out, in which case we still take it.
+    if (!w.granted_)
     {
-        pimpl_->sessions_[pos].first = false;
+        waiters_.erase(it);
     }
 
-    pthread_mutex_unlock(&(pimpl_->mtx_));
+    pthread_cond_destroy(&w.cond_);
 
-    if (cc != 0)
+    return w.granted_;
+}
+
+void connection_pool::connection_pool_impl::wake(pool_waiter & w)
+{
+    // This must be done with the mutex locked, as otherwise the waiter could
+    // wake up spuriously, notice that it got the session and destroy the
+    // condition before we signal it.
+    pthread_cond_signal(&w.cond_);
+}
+
+void connection_pool::connection_pool_impl::wait_maintenance(long long timeoutNs)
+{
+    if (timeoutNs < 0)
+    {
+        pthread_cond_wait(&maintenanceCond_, &mtx_);
+    }
+    else
+    {
+        struct timespec tm;
+        make_deadline(tm, timeoutNs);
+        pthread_cond_timedwait(&maintenanceCond_, &mtx_, &tm);
+    }
+}
+
+void connection_pool::connection_pool_impl::signal_maintenance()
+{
+    pthread_cond_signal(&maintenanceCond_);
+}
+
+#else
+// Windows implementation
+
+namespace // anonymous
+{
+
+// Convert timeout in nanoseconds to the value for WaitForSingleObject().
+DWORD make_wait_timeout(long long timeoutNs)
+{
+    if (timeoutNs < 0)
+    {
+        return INFINITE;
+    }
+
+    return static_cast<DWORD>((timeoutNs + 999999) / 1000000);
+}
+
+} // namespace anonymous
+
+void connection_pool::connection_pool_impl::init_sync()
+{
+    // Use auto-reset event, which remains signaled until the maintenance
+    // thread waits for it, so that no wake ups are lost.
+    maintenanceEvent_ = CreateEvent(NULL, FALSE, FALSE, NULL);
+    if (maintenanceEvent_ == NULL)
+    {
+        throw soci_error("Synchronization error");
+    }
+
+    InitializeCriticalSection(&mtx_);
+}
+
+void connection_pool::connection_pool_impl::destroy_sync()
+{
+    DeleteCriticalSection(&mtx_);
+    CloseHandle(maintenanceEvent_);
+}
+
+void connection_pool::connection_pool_impl::lock()
+{
+    EnterCriticalSection(&mtx_);
+}
+
+void connection_pool::connection_pool_impl::unlock()
+{
+    LeaveCriticalSection(&mtx_);
+}
+
+bool connection_pool::connection_pool_impl::wait(pool_waiter & w, int timeout)
+{
+    long long const deadline
+        = monotonic_time_ns() + static_cast<long long>(timeout) * 1000000;
+
+    // Use auto-reset event which remains signaled if the session is given to
+    // us before we start waiting for it.
+    w.event_ = CreateEvent(NULL, FALSE, FALSE, NULL);
+    if (w.event_ == NULL)
+    {
+        throw soci_error("Synchronization error");
+    }
+
+    std::list<pool_waiter *>::iterator const
+        it = waiters_.insert(waiters_.end(), &w);
+
+    while (!w.granted_)
+    {
+        DWORD wait = INFINITE;
+        if (timeout >= 0)
+        {
+            long long const remaining = deadline - monotonic_time_ns();
+            if (remaining <= 0)
+            {
+                break;
+            }
+
+            wait = make_wait_timeout(remaining);
+        }
+
+        LeaveCriticalSection(&mtx_);
+        DWORD const cc = WaitForSingleObject(w.event_, wait);
+        EnterCriticalSection(&mtx_);
+
+        if (cc == WAIT_FAILED)
+        {
+            break;
+        }
+    }
+
+    if (!w.granted_)
+    {
+        waiters_.erase(it);
+    }
+
+    CloseHandle(w.event_);
+
+    return w.granted_;
+}
+
+void connection_pool::connection_pool_impl::wake(pool_waiter & w)
+{
+    SetEvent(w.event_);
+}
+
+void connection_pool::connection_pool_impl::wait_maintenance(long long timeoutNs)
+{
+    LeaveCriticalSection(&mtx_);
+    WaitForSingleObject(maintenanceEvent_, make_wait_timeout(timeoutNs));
+    EnterCriticalSection(&mtx_);
+}
+
+void connection_pool::connection_pool_impl::signal_maintenance()
+{
+    SetEvent(maintenanceEvent_);
+}
+
+#endif // _WIN32
+
+bool connection_pool::connection_pool_impl::acquire(std::size_t & pos,
+    int timeout, long long start)
+{
+    scoped_lock lock(*this);
+
+    if (!free_.empty())
+    {
+        pos = free_.back();
+        free_.pop_back();
+
+        mark_leased(pos, monotonic_time_ns());
+
+        return true;
+    }
+
+    // If the pool can still grow, open a new session, but do it in the
+    // maintenance thread and wait for it (or for any other session to become
+    // available, whichever happens first) instead of connecting to the
+    // database in this thread.
+    if (!closed_.empty())
+    {
+        std::size_t const closed = closed_.back();
+        closed_.pop_back();
+
+        open_in_background(closed);
+    }
+
+    // Don't count the calls to try_lease() with zero timeout as waits, as
+    // they never block.
+    pool_waiter w;
+    bool granted = false;
+    if (timeout != 0)
+    {
+        granted = wait(w, timeout);
+
+        unsigned long long const waited
+            = static_cast<unsigned long long>(monotonic_time_ns() - start);
+
+        ++stats_.waits;
+        stats_.totalWaitNs += waited;
+        if (waited > stats_.maxWaitNs)
+        {
+            stats_.maxWaitNs = waited;
+        }
+    }
+
+    if (!granted)
     {
         // we can only fail if timeout expired
         if (timeout < 0)
@@ -154,67 +567,186 @@ bool connection_pool::try_lease(std::size_t & pos, int timeout)
             throw soci_error("Getting connection from the pool unexpectedly failed");
         }
 
+        ++stats_.timeouts;
+
         return false;
     }
 
+    // The entry was already marked as leased by whoever gave it to us.
+    pos = w.pos_;
+
     return true;
 }
 
-void connection_pool::give_back(std::size_t pos)
+namespace // anonymous
+{
+
+// Parameters of the thread opening a session.
+struct open_entry_data
 {
-    if (pos >= pimpl_->sessions_.size())
+    session * session_;
+    connection_parameters const * parameters_;
+    std::string error_;
+    bool ok_;
+};
+
+} // namespace anonymous
+
+void connection_pool::connection_pool_impl::open_entry(void * arg)
+{
+    open_entry_data & data = *static_cast<open_entry_data *>(arg);
+
+    try
     {
-        throw soci_error("Invalid pool position");
+        data.session_->open(*data.parameters_);
+        data.ok_ = true;
     }
-
-    int cc = pthread_mutex_lock(&(pimpl_->mtx_));
-    if (cc != 0)
+    catch (std::exception const & e)
     {
-        throw soci_error("Synchronization error");
+        data.error_ = e.what();
     }
-
-    if (pimpl_->sessions_[pos].first)
+    catch (...)
     {
-        pthread_mutex_unlock(&(pimpl_->mtx_));
-        throw soci_error("Cannot release pool entry (already free)");
+        data.error_ = "Unknown error";
     }
+}
 
-    pimpl_->sessions_[pos].first = true;
-
-    pthread_mutex_unlock(&(pimpl_->mtx_));
+void connection_pool::connection_pool_impl::maintenance_thread(void * arg)
+{
+    connection_pool_impl & impl = *static_cast<connection_pool_impl *>(arg);
 
-    pthread_cond_signal(&(pimpl_->cond_));
+    try
+    {
+        scoped_lock lock(impl);
+        impl.do_maintenance();
+    }
+    catch (...)
+    {
+        // There is nothing we can do about errors here, but at least don't
+        // terminate the entire program because of them.
+    }
 }
 
-#else
-// Windows implementation
+bool connection_pool::connection_pool_impl::connect_entry(std::size_t pos)
+{
+    bool ok = false;
+    session & sql = *entries_[pos].session_;
 
-#include <windows.h>
+    unlock();
+    try
+    {
+        sql.close();
+        sql.open(parameters_);
+        ok = true;
+    }
+    catch (...)
+    {
+        // Try again later.
+    }
+    lock();
 
-using namespace soci;
+    return ok;
+}
 
-struct connection_pool::connection_pool_impl
+void connection_pool::connection_pool_impl::do_maintenance()
 {
-    bool find_free(std::size_t & pos)
+    long long nextRetry = 0;
+    while (!stopping_)
     {
-        for (std::size_t i = 0; i != sessions_.size(); ++i)
+        long long const now = monotonic_time_ns();
+
+        // Opening the new sessions and reconnecting the broken ones is more
+        // urgent, as someone is probably waiting for them.
+        if (!opening_.empty() && now >= nextRetry)
         {
-            if (sessions_[i].first)
+            std::size_t const pos = opening_.back();
+            opening_.pop_back();
+
+            if (connect_entry(pos))
+            {
+                release(pos, monotonic_time_ns());
+            }
+            else
             {
-                pos = i;
-                return true;
+                opening_.push_back(pos);
+                nextRetry = now + reconnect_retry_interval_ns;
             }
+
+            continue;
         }
 
-        return false;
-    }
+        if (!broken_.empty() && now >= nextRetry)
+        {
+            std::size_t const pos = broken_.back();
+            broken_.pop_back();
 
-    // by convention, first == true means the entry is free (not used)
-    std::vector<std::pair<bool, session *> > sessions_;
+            if (connect_entry(pos))
+            {
+                ++stats_.reconnects;
+                release(pos, monotonic_time_ns());
+            }
+            else
+            {
+                broken_.push_back(pos);
+                nextRetry = now + reconnect_retry_interval_ns;
+            }
 
-    CRITICAL_SECTION mtx_;
-    HANDLE sem_;
-};
+            continue;
+        }
+
+        long long timeoutNs = -1;
+        if (!opening_.empty() || !broken_.empty())
+        {
+            timeoutNs = nextRetry - now;
+        }
+
+        // Close the session which has been idle for the longest time, which is
+        // always at the bottom of the stack of the free entries.
+        if (idleTimeoutNs_ >= 0 && stats_.openSessions > minSize_
+                && !free_.empty())
+        {
+            std::size_t const pos = free_.front();
+            long long const idle = now - entries_[pos].lastUsed_;
+            if (idle >= idleTimeoutNs_)
+            {
+                free_.erase(free_.begin());
+                entries_[pos].state_ = es_closed;
+                --stats_.openSessions;
+                ++stats_.evictions;
+
+                session & sql = *entries_[pos].session_;
+
+                unlock();
+                try
+                {
+                    sql.close();
+                }
+                catch (...)
+                {
+                    // Ignore errors while closing, we don't need it any more.
+                }
+                lock();
+
+                release_closed(pos);
+
+                continue;
+            }
+
+            long long const expiresIn = idleTimeoutNs_ - idle;
+            if (timeoutNs < 0 || expiresIn < timeoutNs)
+            {
+                timeoutNs = expiresIn;
+            }
+        }
+        else if (idleTimeoutNs_ >= 0 && timeoutNs < 0)
+        {
+            // Check again later, when more sessions may have been opened.
+            timeoutNs = idleTimeoutNs_;
+        }
+
+        wait_maintenance(timeoutNs);
+    }
+}
 
 connection_pool::connection_pool(std::size_t size)
 {
@@ -224,102 +756,186 @@ connection_pool::connection_pool(std::size_t size)
     }
 
     pimpl_ = new connection_pool_impl();
-    pimpl_->sessions_.resize(size);
+    pimpl_->entries_.resize(size);
+    pimpl_->free_.reserve(size);
     for (std::size_t i = 0; i != size; ++i)
     {
-        pimpl_->sessions_[i] = std::make_pair(true, new session());
-    }
-
-    InitializeCriticalSection(&(pimpl_->mtx_));
+        pimpl_->entries_[i].session_ = new session();
 
-    // initially all entries are available
-    HANDLE s = CreateSemaphore(NULL,
-        static_cast<LONG>(size), static_cast<LONG>(size), NULL);
-    if (s == NULL)
-    {
-        throw soci_error("Synchronization error");
+        // Push the entries in reverse order to lease them in the natural one.
+        pimpl_->free_.push_back(size - i - 1);
     }
 
-    pimpl_->sem_ = s;
+    pimpl_->stats_.size = size;
+    pimpl_->stats_.openSessions = size;
+
+    pimpl_->init_sync();
 }
 
-connection_pool::~connection_pool()
+connection_pool::connection_pool(connection_parameters const & parameters,
+    connection_pool_options const & options)
 {
-    for (std::size_t i = 0; i != pimpl_->sessions_.size(); ++i)
+    std::size_t const size = options.maxSize;
+    if (size == 0 || options.minSize > size)
     {
-        delete pimpl_->sessions_[i].second;
+        throw soci_error("Invalid pool size");
     }
 
-    DeleteCriticalSection(&(pimpl_->mtx_));
-    CloseHandle(pimpl_->sem_);
-
-    delete pimpl_;
-}
+    pimpl_ = new connection_pool_impl();
+    pimpl_->elastic_ = true;
+    pimpl_->validate_ = options.validateOnLease;
+    pimpl_->parameters_ = parameters;
+    pimpl_->minSize_ = options.minSize;
+    if (options.idleTimeout >= 0)
+    {
+        pimpl_->idleTimeoutNs_ = options.idleTimeout * 1000000LL;
+    }
 
-bool connection_pool::try_lease(std::size_t & pos, int timeout)
-{
-    DWORD cc = WaitForSingleObject(pimpl_->sem_,
-        timeout >= 0 ? static_cast<DWORD>(timeout) : INFINITE);
-    if (cc == WAIT_OBJECT_0)
+    pimpl_->entries_.resize(size);
+    pimpl_->free_.reserve(size);
+    pimpl_->closed_.reserve(size);
+    pimpl_->opening_.reserve(size);
+    for (std::size_t i = 0; i != size; ++i)
     {
-        // semaphore acquired, there is (at least) one free entry
+        pimpl_->entries_[i].session_ = new session();
+    }
 
-        EnterCriticalSection(&(pimpl_->mtx_));
+    pimpl_->stats_.size = size;
 
-        if (!pimpl_->find_free(pos))
+    std::string error;
+    try
+    {
+        // Open the initial sessions in parallel, as connecting to the database
+        // typically takes much longer than creating a thread.
+        std::vector<open_entry_data> data(options.minSize);
+        std::vector<thread_handle> threads;
+        threads.reserve(options.minSize);
+        for (std::size_t i = 0; i != options.minSize; ++i)
         {
-            // this should be impossible
-            throw soci_error("Getting connection from the pool unexpectedly failed");
+            data[i].session_ = pimpl_->entries_[i].session_;
+            data[i].parameters_ = &pimpl_->parameters_;
+            data[i].ok_ = false;
+
+            try
+            {
+                threads.push_back(start_thread(
+                    &connection_pool_impl::open_entry, &data[i]));
+            }
+            catch (...)
+            {
+                // Just open the session in this thread then.
+                connection_pool_impl::open_entry(&data[i]);
+            }
         }
 
-        pimpl_->sessions_[pos].first = false;
+        for (std::size_t i = 0; i != threads.size(); ++i)
+        {
+            join_thread(threads[i]);
+        }
 
-        LeaveCriticalSection(&(pimpl_->mtx_));
+        for (std::size_t i = 0; i != options.minSize; ++i)
+        {
+            if (!data[i].ok_)
+            {
+                error = data[i].error_;
+                break;
+            }
+        }
 
-        return true;
+        if (error.empty())
+        {
+            pimpl_->init_sync();
+        }
     }
-    else if (cc == WAIT_TIMEOUT)
+    catch (std::exception const & e)
     {
-        return false;
+        error = e.what();
     }
-    else
+
+    if (!error.empty())
     {
-        throw soci_error("Synchronization error");
+        for (std::size_t i = 0; i != size; ++i)
+        {
+            delete pimpl_->entries_[i].session_;
+        }
+
+        delete pimpl_;
+
+        throw soci_error("Failed to open connection pool session: " + error);
     }
-}
 
-void connection_pool::give_back(std::size_t pos)
-{
-    if (pos >= pimpl_->sessions_.size())
+    // The opened sessions are free while the remaining ones are closed, push
+    // both in reverse order to lease them in the natural one.
+    for (std::size_t i = size; i != 0; --i)
     {
-        throw soci_error("Invalid pool position");
+        if (i > options.minSize)
+        {
+            pimpl_->entries_[i - 1].state_ = connection_pool_impl::es_closed;
+            pimpl_->closed_.push_back(i - 1);
+        }
+        else
+        {
+            pimpl_->free_.push_back(i - 1);
+        }
     }
 
-    EnterCriticalSection(&(pimpl_->mtx_));
+    pimpl_->stats_.openSessions = options.minSize;
 
-    if (pimpl_->sessions_[pos].first)
+    long long const now = monotonic_time_ns();
+    for (std::size_t i = 0; i != options.minSize; ++i)
     {
-        LeaveCriticalSection(&(pimpl_->mtx_));
-        throw soci_error("Cannot release pool entry (already free)");
+        pimpl_->entries_[i].lastUsed_ = now;
     }
 
-    pimpl_->sessions_[pos].first = true;
+    try
+    {
+        pimpl_->maintenanceThread_ = start_thread(
+            &connection_pool_impl::maintenance_thread, pimpl_);
+    }
+    catch (...)
+    {
+        for (std::size_t i = 0; i != size; ++i)
+        {
+            delete pimpl_->entries_[i].session_;
+        }
 
-    LeaveCriticalSection(&(pimpl_->mtx_));
+        pimpl_->destroy_sync();
+        delete pimpl_;
 
-    ReleaseSemaphore(pimpl_->sem_, 1, NULL);
+        throw;
+    }
 }
 
-#endif // _WIN32
+connection_pool::~connection_pool()
+{
+    if (pimpl_->elastic_)
+    {
+        pimpl_->lock();
+        pimpl_->stopping_ = true;
+        pimpl_->signal_maintenance();
+        pimpl_->unlock();
+
+        join_thread(pimpl_->maintenanceThread_);
+    }
+
+    for (std::size_t i = 0; i != pimpl_->entries_.size(); ++i)
+    {
+        delete pimpl_->entries_[i].session_;
+    }
+
+    pimpl_->destroy_sync();
+
+    delete pimpl_;
+}
 
 session & connection_pool::at(std::size_t pos)
 {
-    if (pos >= pimpl_->sessions_.size())
+    if (pos >= pimpl_->entries_.size())
     {
         throw soci_error("Invalid pool position");
     }
 
-    return *(pimpl_->sessions_[pos].second);
+    return *(pimpl_->entries_[pos].session_);
 }
 
 std::size_t connection_pool::lease()
@@ -332,4 +948,83 @@ std::size_t connection_pool::lease()
     return pos;
 }
 
+bool connection_pool::try_lease(std::size_t & pos, int timeout)
+{
+    long long const start = monotonic_time_ns();
+
+    for (;;)
+    {
+        // When retrying after finding a broken session, only wait for the
+        // remaining part of the timeout.
+        int remaining = timeout;
+        if (timeout > 0)
+        {
+            long long const elapsedMs = (monotonic_time_ns() - start) / 1000000;
+            remaining = elapsedMs < timeout
+                            ? timeout - static_cast<int>(elapsedMs)
+                            : 0;
+        }
+
+        if (!pimpl_->acquire(pos, remaining, start))
+        {
+            return false;
+        }
+
+        // We own the entry now and can use its session without locking.
+        session & sql = *(pimpl_->entries_[pos].session_);
+
+        if (!pimpl_->validate_ || sql.is_connected())
+        {
+            return true;
+        }
+
+        // Let the maintenance thread reconnect this session and try to find
+        // another one.
+        connection_pool_impl::scoped_lock lock(*pimpl_);
+        pimpl_->unmark_leased();
+        pimpl_->entries_[pos].state_ = connection_pool_impl::es_broken;
+        pimpl_->broken_.push_back(pos);
+        pimpl_->signal_maintenance();
+    }
+}
+
+void connection_pool::give_back(std::size_t pos)
+{
+    if (pos >= pimpl_->entries_.size())
+    {
+        throw soci_error("Invalid pool position");
+    }
+
+    long long const now = monotonic_time_ns();
+
+    connection_pool_impl::scoped_lock lock(*pimpl_);
+
+    connection_pool_impl::entry & e = pimpl_->entries_[pos];
+    if (e.state_ != connection_pool_impl::es_leased)
+    {
+        throw soci_error("Cannot release pool entry (already free)");
+    }
+
+    connection_pool_stats & stats = pimpl_->stats_;
+    --stats.inUse;
+
+    unsigned long long const leased
+        = static_cast<unsigned long long>(now - e.leasedAt_);
+    stats.totalLeaseNs += leased;
+    if (leased > stats.maxLeaseNs)
+    {
+        stats.maxLeaseNs = leased;
+    }
+
+    pimpl_->release(pos, now);
+}
+
+connection_pool_stats connection_pool::get_stats() const
+{
+    connection_pool_impl::scoped_lock lock(*pimpl_);
+
+    connection_pool_stats stats = pimpl_->stats_;
+    stats.waiting = pimpl_->waiters_.size();
 
+    return stats;
+}
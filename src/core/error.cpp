@@ -123,6 +123,16 @@ soci_error::~soci_error() SOCI_NOEXCEPT
     delete info_;
 }
 
+soci_error* soci_error::clone() const
+{
+    return new soci_error(*this);
+}
+
+void soci_error::rethrow() const
+{
+    throw *this;
+}
+
 std::string soci_error::get_error_message() const
 {
     return std::runtime_error::what();
@@ -64,10 +64,12 @@ logger::logger(logger_impl * impl)
     {
         throw soci_error("Null logger implementation not allowed.");
     }
+
+    m_wantsMetrics = m_impl->wants_query_metrics();
 }
 
 logger::logger(logger const & other)
-    : m_impl(other.m_impl->clone())
+    : m_impl(other.m_impl->clone()), m_wantsMetrics(other.m_wantsMetrics)
 {
 }
 
@@ -75,6 +77,7 @@ logger& logger::operator=(logger const & other)
 {
     logger_impl * const implOld = m_impl;
     m_impl = other.m_impl->clone();
+    m_wantsMetrics = other.m_wantsMetrics;
     delete implOld;
 
     return *this;
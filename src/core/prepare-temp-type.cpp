@@ -45,3 +45,14 @@ prepare_temp_type & prepare_temp_type::operator,(into_type_ptr const & i)
     rcpi_->exchange(i);
     return *this;
 }
+
+prepare_temp_type & prepare_temp_type::operator,(fetch_size const & fs)
+{
+    if (fs.get() == 0)
+    {
+        throw soci_error("Invalid fetch size");
+    }
+
+    rcpi_->set_fetch_size(fs.get());
+    return *this;
+}
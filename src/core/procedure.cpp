@@ -19,6 +19,11 @@ procedure_impl::procedure_impl(prepare_temp_type const & prep)
 {
     ref_counted_prepare_info * prepInfo = prep.get_prepare_info();
 
+    if (prepInfo->get_fetch_size() != 1)
+    {
+        throw soci_error("fetch_size can only be used with rowset.");
+    }
+
     // take all bind/define info
     intos_.swap(prepInfo->intos_);
     uses_.swap(prepInfo->uses_);
@@ -0,0 +1,151 @@
+//
+// Copyright (C) 2004-2008 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define SOCI_SOURCE
+#include "soci/query-placeholders.h"
+#include <cctype>
+
+using namespace soci;
+using namespace soci::details;
+
+namespace // anonymous
+{
+
+bool is_name_char(char c)
+{
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+} // namespace anonymous
+
+void query_placeholders::parse(std::string const & query, int flags)
+{
+    names_.clear();
+    chunks_.clear();
+    positions_.clear();
+
+    enum { normal, in_quotes, in_line_comment, in_block_comment } state = normal;
+
+    // The closing quote character when in_quotes.
+    char quote = '\0';
+
+    std::string chunk;
+    chunk.reserve(query.size());
+
+    std::string::size_type const len = query.size();
+    for (std::string::size_type i = 0; i != len; ++i)
+    {
+        char const c = query[i];
+        char const next = i + 1 != len ? query[i + 1] : '\0';
+
+        switch (state)
+        {
+        case normal:
+            if (c == '\'' || c == '"' || c == '`')
+            {
+                quote = c;
+                state = in_quotes;
+            }
+            else if (c == '-' && next == '-')
+            {
+                state = in_line_comment;
+            }
+            else if (c == '/' && next == '*')
+            {
+                chunk += c;
+                chunk += next;
+                ++i;
+                state = in_block_comment;
+                continue;
+            }
+            else if (c == ':')
+            {
+                if (next == ':' || next == '=')
+                {
+                    // Cast or assignment operator, not a placeholder.
+                    chunk += c;
+                    chunk += next;
+                    ++i;
+                    continue;
+                }
+
+                if (is_name_char(next))
+                {
+                    std::string::size_type end = i + 1;
+                    while (end != len && is_name_char(query[end]))
+                    {
+                        ++end;
+                    }
+
+                    positions_[query.substr(i + 1, end - i - 1)]
+                        .push_back(names_.size());
+                    names_.push_back(query.substr(i + 1, end - i - 1));
+
+                    chunks_.push_back(chunk);
+                    chunk.clear();
+
+                    i = end - 1;
+                    continue;
+                }
+            }
+            break;
+
+        case in_quotes:
+            if (c == '\\' && (flags & backslash_escapes) && next != '\0')
+            {
+                chunk += c;
+                chunk += next;
+                ++i;
+                continue;
+            }
+
+            // Doubled quotes inside quotes are just handled as two
+            // consecutive quoted strings.
+            if (c == quote)
+            {
+                state = normal;
+            }
+            break;
+
+        case in_line_comment:
+            if (c == '\n')
+            {
+                state = normal;
+            }
+            break;
+
+        case in_block_comment:
+            if (c == '*' && next == '/')
+            {
+                chunk += c;
+                chunk += next;
+                ++i;
+                state = normal;
+                continue;
+            }
+            break;
+        }
+
+        chunk += c;
+    }
+
+    chunks_.push_back(chunk);
+}
+
+void query_placeholders::add_name(std::string const & name)
+{
+    positions_[name].push_back(names_.size());
+    names_.push_back(name);
+    chunks_.push_back(std::string());
+}
+
+std::vector<std::size_t> const *
+query_placeholders::find(std::string const & name) const
+{
+    positions_map::const_iterator const it = positions_.find(name);
+    return it == positions_.end() ? NULL : &it->second;
+}
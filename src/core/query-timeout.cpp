@@ -0,0 +1,224 @@
+//
+// Copyright (C) 2004-2016 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define SOCI_SOURCE
+#include "soci/error.h"
+#include "soci-clock.h"
+#include "soci-query-timeout.h"
+#include "soci-thread.h"
+#include <sstream>
+#include <vector>
+
+using namespace soci;
+using namespace soci::details;
+
+namespace // anonymous
+{
+
+// Thread cancelling the operations whose deadline has passed.
+class query_watchdog
+{
+public:
+    static query_watchdog & instance()
+    {
+        // This object is intentionally never destroyed, as its thread keeps
+        // using it until the program exits.
+        static query_watchdog * const watchdog = new query_watchdog;
+        return *watchdog;
+    }
+
+    void arm(query_timeout_guard * guard)
+    {
+        thread_lock lock(mutex_);
+
+        if (!started_)
+        {
+            detach_thread(start_thread(thread_func, this));
+            started_ = true;
+        }
+
+        guards_.push_back(guard);
+
+        // Wake up the thread for it to take the new deadline into account.
+        wakeup_.set();
+    }
+
+    // Return only once the guard can't be used by the thread any more.
+    void disarm(query_timeout_guard * guard)
+    {
+        for (;;)
+        {
+            {
+                thread_lock lock(mutex_);
+
+                for (std::size_t i = 0; i != guards_.size(); ++i)
+                {
+                    if (guards_[i] == guard)
+                    {
+                        guards_.erase(guards_.begin() + i);
+                        return;
+                    }
+                }
+
+                if (!guard->cancelling_)
+                {
+                    return;
+                }
+            }
+
+            // The thread is cancelling the operation of this guard right
+            // now, wait until it's done with it before letting the caller
+            // destroy the backend.
+            cancelled_.wait();
+        }
+    }
+
+private:
+    query_watchdog() : started_(false) {}
+
+    static void thread_func(void * arg)
+    {
+        static_cast<query_watchdog *>(arg)->run();
+    }
+
+    void run()
+    {
+        std::vector<query_timeout_guard *> expired;
+        for (;;)
+        {
+            // Time to wait until the nearest deadline or -1 to wait forever.
+            long long waitNs = -1;
+
+            {
+                thread_lock lock(mutex_);
+
+                long long const now = monotonic_time_ns();
+                for (std::size_t i = 0; i != guards_.size(); )
+                {
+                    query_timeout_guard * const guard = guards_[i];
+
+                    long long const left = guard->deadlineNs_ - now;
+                    if (left <= 0)
+                    {
+                        guard->expired_ = true;
+                        guard->cancelling_ = true;
+                        expired.push_back(guard);
+
+                        guards_.erase(guards_.begin() + i);
+                        continue;
+                    }
+
+                    if (waitNs == -1 || left < waitNs)
+                    {
+                        waitNs = left;
+                    }
+
+                    ++i;
+                }
+
+                if (!expired.empty())
+                {
+                    cancelled_.reset();
+                }
+
+                wakeup_.reset();
+            }
+
+            if (!expired.empty())
+            {
+                // Cancelling may require a network round trip, so don't keep
+                // the mutex locked while doing it, as this would block arming
+                // and disarming all the other guards. The expired guards
+                // can't be destroyed meanwhile, as disarm() waits for us.
+                for (std::size_t i = 0; i != expired.size(); ++i)
+                {
+                    try
+                    {
+                        expired[i]->backEnd_->cancel();
+                    }
+                    catch (...)
+                    {
+                        // The operation will just take longer to complete.
+                    }
+                }
+
+                {
+                    thread_lock lock(mutex_);
+
+                    for (std::size_t i = 0; i != expired.size(); ++i)
+                    {
+                        expired[i]->cancelling_ = false;
+                    }
+                }
+
+                expired.clear();
+                cancelled_.set();
+
+                // Check for the deadlines again, as more of them could have
+                // expired while we were cancelling.
+                continue;
+            }
+
+            if (waitNs == -1)
+            {
+                wakeup_.wait();
+            }
+            else
+            {
+                wakeup_.wait_for(waitNs);
+            }
+        }
+    }
+
+    thread_mutex mutex_;
+    thread_event wakeup_;
+    bool started_;
+
+    // Signaled when the thread is not cancelling any operations.
+    thread_event cancelled_;
+
+    // Only a few operations are typically in progress at any time, so a
+    // vector is good enough here.
+    std::vector<query_timeout_guard *> guards_;
+};
+
+} // namespace anonymous
+
+query_timeout_guard::query_timeout_guard(statement_backend * backEnd,
+    int timeoutMs)
+    : backEnd_(backEnd), deadlineNs_(0), expired_(false), cancelling_(false),
+      timeoutMs_(timeoutMs), armed_(false)
+{
+    if (timeoutMs_ > 0)
+    {
+        deadlineNs_ = monotonic_time_ns() + timeoutMs_ * 1000000LL;
+
+        query_watchdog::instance().arm(this);
+        armed_ = true;
+    }
+}
+
+void query_timeout_guard::disarm()
+{
+    if (armed_)
+    {
+        query_watchdog::instance().disarm(this);
+        armed_ = false;
+    }
+}
+
+void query_timeout_guard::throw_if_expired()
+{
+    disarm();
+
+    if (expired_)
+    {
+        std::ostringstream oss;
+        oss << "Query timeout of " << timeoutMs_ << "ms expired.";
+        throw query_timeout_error(oss.str());
+    }
+}
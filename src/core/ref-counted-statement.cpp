@@ -47,6 +47,17 @@ ref_counted_statement_base::ref_counted_statement_base(session& s)
 
 void ref_counted_statement::final_action()
 {
+    if (session_.get_statement_cache_size() != 0)
+    {
+        // If anything goes wrong, the statement is just destroyed together
+        // with this object instead of being returned to the cache.
+        st_.prepare_cached(session_.get_query());
+        st_.define_and_bind();
+        st_.execute(true);
+        st_.release_to_cache();
+        return;
+    }
+
     auto_statement_alloc auto_st_alloc(st_);
 
     st_.prepare(session_.get_query(), st_one_time_query);
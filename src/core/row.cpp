@@ -8,6 +8,7 @@
 #define SOCI_SOURCE
 #include "soci/row.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cctype>
 #include <sstream>
@@ -16,8 +17,24 @@
 using namespace soci;
 using namespace details;
 
+namespace // anonymous
+{
+
+// Compare the index elements by name only, to allow duplicate names.
+struct compare_index_names
+{
+    bool operator()(std::pair<std::string, std::size_t> const & lhs,
+                    std::pair<std::string, std::size_t> const & rhs) const
+    {
+        return lhs.first < rhs.first;
+    }
+};
+
+} // namespace anonymous
+
 row::row()
-    : uppercaseColumnNames_(false)
+    : indexSorted_(true)
+    , uppercaseColumnNames_(false)
     , currentPos_(0)
 {}
 
@@ -54,7 +71,8 @@ void row::add_properties(column_properties const &cp)
         columnName = originalName;
     }
 
-    index_[columnName] = columns_.size() - 1;
+    index_.push_back(std::make_pair(columnName, columns_.size() - 1));
+    indexSorted_ = false;
 }
 
 std::size_t row::size() const
@@ -64,22 +82,38 @@ std::size_t row::size() const
 
 void row::clean_up()
 {
-    std::size_t const hsize = holders_.size();
-    for (std::size_t i = 0; i != hsize; ++i)
-    {
-        delete holders_[i];
-        delete indicators_[i];
-    }
-
     columns_.clear();
     holders_.clear();
+    strings_.clear();
     indicators_.clear();
     index_.clear();
+    indexSorted_ = true;
+}
+
+void row::reserve(std::size_t numColumns)
+{
+    columns_.reserve(numColumns);
+    holders_.reserve(numColumns);
+    strings_.reserve(numColumns);
+    indicators_.reserve(numColumns);
+    index_.reserve(numColumns);
+}
+
+void row::check_can_add_holder() const
+{
+    // Adding more elements would reallocate the vectors and invalidate the
+    // pointers to their elements which were already bound.
+    if (holders_.size() == holders_.capacity() ||
+        strings_.size() == strings_.capacity() ||
+        indicators_.size() == indicators_.capacity())
+    {
+        throw soci_error("Not enough space reserved for row columns.");
+    }
 }
 
 indicator row::get_indicator(std::size_t pos) const
 {
-    return *indicators_.at(pos);
+    return indicators_.at(pos);
 }
 
 indicator row::get_indicator(std::string const &name) const
@@ -99,13 +133,23 @@ column_properties const & row::get_properties(std::string const &name) const
 
 std::size_t row::find_column(std::string const &name) const
 {
-    std::map<std::string, std::size_t>::const_iterator it = index_.find(name);
-    if (it == index_.end())
+    if (!indexSorted_)
+    {
+        // Stable sort ensures that the last column with the given name is
+        // found if there are several of them.
+        std::stable_sort(index_.begin(), index_.end(), compare_index_names());
+        indexSorted_ = true;
+    }
+
+    name_index::const_iterator const it = std::upper_bound(index_.begin(),
+        index_.end(), std::make_pair(name, std::size_t(0)),
+        compare_index_names());
+    if (it == index_.begin() || (it - 1)->first != name)
     {
         std::ostringstream msg;
         msg << "Column '" << name << "' not found";
         throw soci_error(msg.str());
     }
 
-    return it->second;
+    return (it - 1)->second;
 }
@@ -11,6 +11,13 @@
 #include "soci/connection-pool.h"
 #include "soci/soci-backend.h"
 #include "soci/query_transformation.h"
+// std
+#include <list>
+#include <map>
+#ifdef SOCI_HAVE_CXX11
+#include <unordered_map>
+#endif
+#include <utility>
 
 using namespace soci;
 using namespace soci::details;
@@ -72,11 +79,138 @@ private:
 
 } // namespace anonymous
 
+struct session::statement_cache_impl
+{
+    statement_cache_impl() : maxSize_(0), hits_(0), misses_(0) {}
+
+    ~statement_cache_impl()
+    {
+        shrink(0);
+    }
+
+    statement_backend * acquire(std::string const & query)
+    {
+        index_type::iterator const it = index_.find(query);
+        if (it == index_.end() || it->second.used_)
+        {
+            ++misses_;
+            return NULL;
+        }
+
+        ++hits_;
+
+        // The statement remains in the cache while it's used, but is marked
+        // as such, so that it's not destroyed from under our feet if the
+        // cache is shrunk or given to another statement for the same query.
+        it->second.used_ = true;
+        lru_.splice(lru_.begin(), lru_, it->second.lru_);
+
+        return it->second.backend_;
+    }
+
+    void release(std::string const & query, statement_backend * backend)
+    {
+        index_type::iterator const it = index_.find(query);
+        if (it != index_.end())
+        {
+            // If another statement for the same query had been put into the
+            // cache while this one was used, just keep that one.
+            if (it->second.backend_ != backend)
+            {
+                destroy(backend);
+                return;
+            }
+
+            it->second.used_ = false;
+        }
+        else
+        {
+            if (maxSize_ == 0)
+            {
+                destroy(backend);
+                return;
+            }
+
+            index_type::iterator const added =
+                index_.insert(index_type::value_type(query, entry())).first;
+            added->second.backend_ = backend;
+            added->second.used_ = false;
+
+            // The list refers to the key stored in the index, which remains
+            // valid until the entry is erased, to avoid copying the string.
+            lru_.push_front(&added->first);
+            added->second.lru_ = lru_.begin();
+        }
+
+        shrink(maxSize_);
+    }
+
+    // Destroy the least recently used statements until no more than the
+    // given number of them remains. Statements currently in use are just
+    // forgotten and will be put back into the cache when they're released.
+    void shrink(std::size_t size)
+    {
+        while (index_.size() > size)
+        {
+            index_type::iterator const it = index_.find(*lru_.back());
+            lru_.pop_back();
+
+            statement_backend * const backend = it->second.backend_;
+            bool const used = it->second.used_;
+            index_.erase(it);
+
+            if (!used)
+            {
+                destroy(backend);
+            }
+        }
+    }
+
+    static void destroy(statement_backend * backend)
+    {
+        try
+        {
+            backend->clean_up();
+        }
+        catch (...)
+        {
+            // We're only freeing the resources here, so there is nothing
+            // useful to do with the errors and throwing would leak the
+            // remaining statements.
+        }
+
+        delete backend;
+    }
+
+    // The most recently used statements are at the front of the list.
+    typedef std::list<std::string const *> lru_type;
+    lru_type lru_;
+
+    struct entry
+    {
+        statement_backend * backend_;
+        bool used_;
+        lru_type::iterator lru_;
+    };
+
+#ifdef SOCI_HAVE_CXX11
+    typedef std::unordered_map<std::string, entry> index_type;
+#else
+    typedef std::map<std::string, entry> index_type;
+#endif
+    index_type index_;
+
+    std::size_t maxSize_;
+    unsigned long long hits_;
+    unsigned long long misses_;
+};
+
 session::session()
     : once(this), prepare(this), query_transformation_(NULL),
       logger_(new standard_logger_impl),
       uppercaseColumnNames_(false), backEnd_(NULL),
-      isFromPool_(false), pool_(NULL)
+      isFromPool_(false), pool_(NULL), statementCache_(NULL),
+      queryTimeoutMs_(0)
 {
 }
 
@@ -85,7 +219,8 @@ session::session(connection_parameters const & parameters)
       logger_(new standard_logger_impl),
       lastConnectParameters_(parameters),
       uppercaseColumnNames_(false), backEnd_(NULL),
-      isFromPool_(false), pool_(NULL)
+      isFromPool_(false), pool_(NULL), statementCache_(NULL),
+      queryTimeoutMs_(0)
 {
     open(lastConnectParameters_);
 }
@@ -96,7 +231,8 @@ session::session(backend_factory const & factory,
     logger_(new standard_logger_impl),
       lastConnectParameters_(factory, connectString),
       uppercaseColumnNames_(false), backEnd_(NULL),
-      isFromPool_(false), pool_(NULL)
+      isFromPool_(false), pool_(NULL), statementCache_(NULL),
+      queryTimeoutMs_(0)
 {
     open(lastConnectParameters_);
 }
@@ -107,7 +243,8 @@ session::session(std::string const & backendName,
       logger_(new standard_logger_impl),
       lastConnectParameters_(backendName, connectString),
       uppercaseColumnNames_(false), backEnd_(NULL),
-      isFromPool_(false), pool_(NULL)
+      isFromPool_(false), pool_(NULL), statementCache_(NULL),
+      queryTimeoutMs_(0)
 {
     open(lastConnectParameters_);
 }
@@ -117,7 +254,8 @@ session::session(std::string const & connectString)
       logger_(new standard_logger_impl),
       lastConnectParameters_(connectString),
       uppercaseColumnNames_(false), backEnd_(NULL),
-      isFromPool_(false), pool_(NULL)
+      isFromPool_(false), pool_(NULL), statementCache_(NULL),
+      queryTimeoutMs_(0)
 {
     open(lastConnectParameters_);
 }
@@ -125,7 +263,8 @@ session::session(std::string const & connectString)
 session::session(connection_pool & pool)
     : query_transformation_(NULL),
       logger_(new standard_logger_impl),
-      isFromPool_(true), pool_(&pool)
+      isFromPool_(true), pool_(&pool), statementCache_(NULL),
+      queryTimeoutMs_(0)
 {
     poolPosition_ = pool.lease();
     session & pooledSession = pool.at(poolPosition_);
@@ -144,6 +283,7 @@ session::~session()
     else
     {
         delete query_transformation_;
+        delete statementCache_;
         delete backEnd_;
     }
 }
@@ -200,6 +340,8 @@ void session::close()
     }
     else
     {
+        clear_statement_cache();
+
         delete backEnd_;
         backEnd_ = NULL;
     }
@@ -560,6 +702,126 @@ std::string session::get_dummy_from_clause() const
     return clause;
 }
 
+void session::set_statement_cache_size(std::size_t size)
+{
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).set_statement_cache_size(size);
+    }
+    else
+    {
+        if (statementCache_ == NULL)
+        {
+            if (size == 0)
+            {
+                return;
+            }
+
+            statementCache_ = new statement_cache_impl();
+        }
+
+        statementCache_->maxSize_ = size;
+        statementCache_->shrink(size);
+    }
+}
+
+std::size_t session::get_statement_cache_size() const
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).get_statement_cache_size();
+    }
+    else
+    {
+        return statementCache_ ? statementCache_->maxSize_ : 0;
+    }
+}
+
+void session::set_query_timeout(int timeoutMs)
+{
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).set_query_timeout(timeoutMs);
+    }
+    else
+    {
+        queryTimeoutMs_ = timeoutMs;
+    }
+}
+
+int session::get_query_timeout() const
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).get_query_timeout();
+    }
+    else
+    {
+        return queryTimeoutMs_;
+    }
+}
+
+unsigned long long session::get_statement_cache_hits() const
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).get_statement_cache_hits();
+    }
+    else
+    {
+        return statementCache_ ? statementCache_->hits_ : 0;
+    }
+}
+
+unsigned long long session::get_statement_cache_misses() const
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).get_statement_cache_misses();
+    }
+    else
+    {
+        return statementCache_ ? statementCache_->misses_ : 0;
+    }
+}
+
+statement_backend * session::acquire_cached_statement(std::string const & query)
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).acquire_cached_statement(query);
+    }
+    else
+    {
+        return statementCache_ ? statementCache_->acquire(query) : NULL;
+    }
+}
+
+void session::release_cached_statement(std::string const & query,
+    statement_backend * backend)
+{
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).release_cached_statement(query, backend);
+    }
+    else if (statementCache_)
+    {
+        statementCache_->release(query, backend);
+    }
+    else
+    {
+        statement_cache_impl::destroy(backend);
+    }
+}
+
+void session::clear_statement_cache()
+{
+    if (statementCache_)
+    {
+        statementCache_->shrink(0);
+    }
+}
+
 void session::set_failover_callback(failover_callback & callback)
 {
     ensureConnected(backEnd_);
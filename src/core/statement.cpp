@@ -11,30 +11,46 @@
 #include "soci/into-type.h"
 #include "soci/use-type.h"
 #include "soci/values.h"
+#include "soci/column-batch.h"
+#include "soci-clock.h"
 #include "soci-compiler.h"
+#include "soci-query-timeout.h"
+#include "soci-thread.h"
 #include <ctime>
-#include <cctype>
+#include <exception>
 
 using namespace soci;
 using namespace soci::details;
 
 
 statement_impl::statement_impl(session & s)
-    : session_(s), refCount_(1), row_(0),
-      fetchSize_(1), initialFetchSize_(1),
-      alreadyDescribed_(false)
+    : session_(s), refCount_(1), placeholdersParsed_(false), row_(0),
+      columnBatch_(NULL), fetchSize_(1), initialFetchSize_(1),
+      alreadyDescribed_(false), executeStartNs_(0), async_(NULL), timeoutMs_(-1),
+      metricsDurationNs_(0), metricsRows_(0), metricsActive_(false)
 {
     backEnd_ = s.make_statement_backend();
 }
 
 statement_impl::statement_impl(prepare_temp_type const & prep)
     : session_(prep.get_prepare_info()->session_),
-      refCount_(1), row_(0), fetchSize_(1), alreadyDescribed_(false)
+      refCount_(1), placeholdersParsed_(false),
+      row_(0), columnBatch_(NULL), fetchSize_(1), alreadyDescribed_(false),
+      executeStartNs_(0), async_(NULL), timeoutMs_(-1),
+      metricsDurationNs_(0), metricsRows_(0), metricsActive_(false)
 {
-    backEnd_ = session_.make_statement_backend();
-
     ref_counted_prepare_info * prepInfo = prep.get_prepare_info();
 
+    // Only rowset uses the fetch size and it resets it before creating the
+    // statement, so don't silently ignore it if it's specified for anything
+    // else.
+    if (prepInfo->get_fetch_size() != 1)
+    {
+        throw soci_error("fetch_size can only be used with rowset.");
+    }
+
+    backEnd_ = session_.make_statement_backend();
+
     // take all bind/define info
     intos_.swap(prepInfo->intos_);
     uses_.swap(prepInfo->uses_);
@@ -81,49 +97,16 @@ void statement_impl::bind(values & values)
             // - or positional
 
             std::string const& useName = (*it)->get_name();
-            if (useName.empty())
+            if (useName.empty() || get_placeholders().find(useName) != NULL)
             {
-                // positional use element
-
                 int position = static_cast<int>(uses_.size());
                 (*it)->bind(*this, position);
                 uses_.push_back(*it);
-                indicators_.push_back(values.indicators_[cnt]);
+                valuesUses_.push_back(*it);
             }
             else
             {
-                // named use element - check if it is used
-                std::string const placeholder = ":" + useName;
-
-                std::size_t pos = query_.find(placeholder);
-                while (pos != std::string::npos)
-                {
-                    // Retrieve next char after placeholder
-                    // make sure we do not go out of range on the string
-                    const char nextChar = (pos + placeholder.size()) < query_.size() ?
-                                          query_[pos + placeholder.size()] : '\0';
-
-                    if (std::isalnum(nextChar))
-                    {
-                        // We got a partial match only,
-                        // keep looking for the placeholder
-                        pos = query_.find(placeholder, pos + placeholder.size());
-                    }
-                    else
-                    {
-                        int position = static_cast<int>(uses_.size());
-                        (*it)->bind(*this, position);
-                        uses_.push_back(*it);
-                        indicators_.push_back(values.indicators_[cnt]);
-                        // Ok we found it, done
-                        break;
-                    }
-                }
-                // In case we couldn't find the placeholder
-                if (pos == std::string::npos)
-                {
-                    values.add_unused(*it, values.indicators_[cnt]);
-                }
+                values.add_unused(*it);
             }
 
             cnt++;
@@ -133,7 +116,7 @@ void statement_impl::bind(values & values)
     {
         for (std::size_t i = ++cnt; i != values.uses_.size(); ++i)
         {
-            values.add_unused(values.uses_[i], values.indicators_[i]);
+            values.add_unused(values.uses_[i]);
         }
 
         rethrow_current_exception_with_context("binding parameters of");
@@ -163,23 +146,39 @@ void statement_impl::bind_clean_up()
     for (std::size_t i = usize; i != 0; --i)
     {
         uses_[i - 1]->clean_up();
-        delete uses_[i - 1];
-        uses_.resize(i - 1);
-    }
 
-    std::size_t const indsize = indicators_.size();
-    for (std::size_t i = 0; i != indsize; ++i)
-    {
-        delete indicators_[i];
-        indicators_[i] = NULL;
+        // the elements bound by bind(values) are owned by the values object
+        // and are destroyed by use_type<values>::clean_up() which comes
+        // before them in uses_
+        if (!valuesUses_.empty() && valuesUses_.back() == uses_[i - 1])
+        {
+            valuesUses_.pop_back();
+        }
+        else
+        {
+            delete uses_[i - 1];
+        }
+        uses_.resize(i - 1);
     }
 
     row_ = NULL;
+    columnBatch_ = NULL;
     alreadyDescribed_ = false;
 }
 
 void statement_impl::clean_up()
 {
+    cancel_async();
+
+    try
+    {
+        finish_query_metrics();
+    }
+    catch (...)
+    {
+        // Errors in the logger must not prevent us from cleaning up.
+    }
+
     bind_clean_up();
     if (backEnd_ != NULL)
     {
@@ -194,10 +193,28 @@ void statement_impl::prepare(std::string const & query,
 {
     try
     {
+        finish_query_metrics();
+
         query_ = query;
+        placeholdersParsed_ = false;
         session_.log_query(query);
 
-        backEnd_->prepare(query, eType);
+        logger const & log = session_.get_logger();
+        if (log.wants_query_metrics())
+        {
+            start_query_metrics();
+
+            long long const start = monotonic_time_ns();
+            backEnd_->prepare(query, eType);
+            long long const duration = monotonic_time_ns() - start;
+
+            metricsDurationNs_ += duration;
+            log.query_prepared(query_, duration);
+        }
+        else
+        {
+            backEnd_->prepare(query, eType);
+        }
     }
     catch (...)
     {
@@ -205,6 +222,64 @@ void statement_impl::prepare(std::string const & query,
     }
 }
 
+query_placeholders const & statement_impl::get_placeholders()
+{
+    if (query_placeholders const * const p = backEnd_->get_placeholders())
+    {
+        return *p;
+    }
+
+    if (!placeholdersParsed_)
+    {
+        placeholders_.parse(query_);
+        placeholdersParsed_ = true;
+    }
+
+    return placeholders_;
+}
+
+void statement_impl::prepare_cached(std::string const & query)
+{
+    statement_backend * const cached = session_.acquire_cached_statement(query);
+    if (cached == NULL)
+    {
+        alloc();
+        prepare(query, st_repeatable_query);
+        return;
+    }
+
+    // The backend statement created by our ctor was never used, so there is
+    // nothing to clean up in it.
+    delete backEnd_;
+    backEnd_ = cached;
+
+    query_ = query;
+    placeholdersParsed_ = false;
+    session_.log_query(query);
+
+    if (session_.get_logger().wants_query_metrics())
+    {
+        start_query_metrics();
+    }
+}
+
+void statement_impl::release_to_cache()
+{
+    finish_query_metrics();
+
+    bind_clean_up();
+
+    if (backEnd_ != NULL && backEnd_->reset_for_reuse())
+    {
+        session_.release_cached_statement(query_, backEnd_);
+        backEnd_ = NULL;
+    }
+    else
+    {
+        clean_up();
+    }
+}
+
 void statement_impl::define_and_bind()
 {
     int definePosition = 1;
@@ -262,102 +337,452 @@ bool statement_impl::execute(bool withDataExchange)
 {
     try
     {
-        initialFetchSize_ = intos_size();
+        if (async_ != NULL)
+        {
+            throw soci_error("Asynchronous execution is still in progress.");
+        }
 
-        if (intos_.empty() == false && initialFetchSize_ == 0)
+        int const num = begin_execute(withDataExchange);
+
+        statement_backend::exec_fetch_result res;
         {
-            // this can happen only with into-vectors elements
-            // and is not allowed when calling execute
-            throw soci_error("Vectors of size 0 are not allowed.");
+            query_timeout_guard timeoutGuard(backEnd_, effective_timeout());
+            try
+            {
+                res = backEnd_->execute(num);
+            }
+            catch (soci_error const &)
+            {
+                timeoutGuard.throw_if_expired();
+                throw;
+            }
         }
 
-        fetchSize_ = initialFetchSize_;
+        return end_execute(res, num);
+    }
+    catch (...)
+    {
+        rethrow_current_exception_with_context("executing");
+    }
+}
+
+int statement_impl::begin_execute(bool withDataExchange)
+{
+    executeStartNs_ = session_.get_logger().wants_query_metrics()
+                        ? monotonic_time_ns()
+                        : 0;
+
+    initialFetchSize_ = intos_size();
 
-        // pre-use should be executed before inspecting the sizes of use
-        // elements, as they can be resized in type conversion routines
+    if (intos_.empty() == false && initialFetchSize_ == 0)
+    {
+        // this can happen only with into-vectors elements
+        // and is not allowed when calling execute
+        throw soci_error("Vectors of size 0 are not allowed.");
+    }
 
-        pre_use();
+    fetchSize_ = initialFetchSize_;
 
-        std::size_t const bindSize = uses_size();
+    // pre-use should be executed before inspecting the sizes of use
+    // elements, as they can be resized in type conversion routines
 
-        if (bindSize > 1 && fetchSize_ > 1)
+    pre_use();
+
+    std::size_t const bindSize = uses_size();
+
+    if (bindSize > 1 && fetchSize_ > 1)
+    {
+        throw soci_error(
+             "Bulk insert/update and bulk select not allowed in same query");
+    }
+
+    // looks like a hack and it is - row description should happen
+    // *after* the use elements were completely prepared
+    // and *before* the into elements are touched, so that the row
+    // description process can inject more into elements for
+    // implicit data exchange
+    if (row_ != NULL && alreadyDescribed_ == false)
+    {
+        describe();
+        define_for_row();
+    }
+    else if (columnBatch_ != NULL && alreadyDescribed_ == false)
+    {
+        describe_column_batch();
+    }
+
+    int num = 0;
+    if (withDataExchange)
+    {
+        num = 1;
+
+        pre_fetch();
+
+        if (static_cast<int>(fetchSize_) > num)
         {
-            throw soci_error(
-                 "Bulk insert/update and bulk select not allowed in same query");
+            num = static_cast<int>(fetchSize_);
         }
+        if (static_cast<int>(bindSize) > num)
+        {
+            num = static_cast<int>(bindSize);
+        }
+    }
+
+    pre_exec(num);
+
+    return num;
+}
+
+bool statement_impl::end_execute(statement_backend::exec_fetch_result res,
+    int num)
+{
+    bool gotData = false;
+
+    if (res == statement_backend::ef_success)
+    {
+        // the "success" means that the statement executed correctly
+        // and for select statement this also means that some rows were read
 
-        // looks like a hack and it is - row description should happen
-        // *after* the use elements were completely prepared
-        // and *before* the into elements are touched, so that the row
-        // description process can inject more into elements for
-        // implicit data exchange
-        if (row_ != NULL && alreadyDescribed_ == false)
+        if (num > 0)
         {
-            describe();
-            define_for_row();
+            gotData = true;
+
+            // ensure into vectors have correct size
+            resize_intos(static_cast<std::size_t>(num));
         }
+    }
+    else // res == ef_no_data
+    {
+        // the "no data" means that the end-of-rowset condition was hit
+        // but still some rows might have been read (the last bunch of rows)
+        // it can also mean that the statement did not produce any results
+
+        gotData = fetchSize_ > 1 ? resize_intos() : false;
+    }
+
+    if (num > 0)
+    {
+        post_fetch(gotData, false);
+    }
+
+    post_use(gotData);
+
+    logger const & log = session_.get_logger();
+    if (log.wants_query_metrics())
+    {
+        long long const duration = monotonic_time_ns() - executeStartNs_;
+        std::size_t const rows = fetched_rows(gotData);
+
+        metricsDurationNs_ += duration;
+        metricsRows_ += rows;
+        log.query_executed(query_, duration, rows);
+    }
+
+    session_.set_got_data(gotData);
+    return gotData;
+}
+
+namespace soci
+{
 
-        int num = 0;
-        if (withDataExchange)
+namespace details
+{
+
+// State of an asynchronous execution.
+//
+// When the backend doesn't support executing the statement asynchronously
+// itself, it is executed by one of the threads of async_pool below and the
+// fields after native_ are used to communicate with it.
+struct async_execution
+{
+    async_execution(statement_backend * backEnd, int num, int timeoutMs)
+        : backEnd_(backEnd), num_(num), native_(false),
+          timeoutGuard_(backEnd, timeoutMs),
+          res_(statement_backend::ef_no_data), error_(NULL)
+    {
+    }
+
+    ~async_execution() { delete error_; }
+
+    void run()
+    {
+        try
+        {
+            res_ = backEnd_->execute(num_);
+        }
+        catch (soci_error const & e)
+        {
+            // Preserve the dynamic type of the exception to allow the caller
+            // to get all the backend-specific information from it.
+            error_ = e.clone();
+        }
+        catch (std::exception const & e)
         {
-            num = 1;
+            error_ = new soci_error(e.what());
+        }
+        catch (...)
+        {
+            error_ = new soci_error("Unknown error while executing statement.");
+        }
+
+        // This must be the last thing done with this object in this thread, as
+        // it can be destroyed by the statement as soon as it's signaled.
+        done_.set();
+    }
 
-            pre_fetch();
+    statement_backend * const backEnd_;
+    int const num_;
+    bool native_;
 
-            if (static_cast<int>(fetchSize_) > num)
+    // The timeout applies to the entire asynchronous execution, i.e. until
+    // finish_execute_async() returns.
+    query_timeout_guard timeoutGuard_;
+
+    thread_event done_;
+    statement_backend::exec_fetch_result res_;
+    soci_error * error_;
+
+    SOCI_NOT_COPYABLE(async_execution)
+};
+
+} // namespace details
+
+} // namespace soci
+
+namespace // anonymous
+{
+
+// Pool of threads used for executing statements asynchronously when the
+// backend can't do it.
+//
+// New threads are created on demand when all the existing ones are busy and
+// at most max_idle_threads of them are kept around after they become idle.
+class async_pool
+{
+public:
+    static async_pool & instance()
+    {
+        // This object is intentionally never destroyed, as the idle threads
+        // still use it when the program exits.
+        static async_pool * const pool = new async_pool;
+        return *pool;
+    }
+
+    void submit(async_execution * exec)
+    {
+        thread_lock lock(mutex_);
+
+        if (idle_.empty())
+        {
+            worker * const w = new worker;
+            w->exec_ = exec;
+            try
             {
-                num = static_cast<int>(fetchSize_);
+                detach_thread(start_thread(worker_func, w));
             }
-            if (static_cast<int>(bindSize) > num)
+            catch (...)
             {
-                num = static_cast<int>(bindSize);
+                delete w;
+                throw;
             }
         }
+        else
+        {
+            worker * const w = idle_.back();
+            idle_.pop_back();
 
-        pre_exec(num);
+            w->exec_ = exec;
+            w->wakeup_.set();
+        }
+    }
 
-        statement_backend::exec_fetch_result res = backEnd_->execute(num);
+private:
+    static std::size_t const max_idle_threads = 4;
 
-        bool gotData = false;
+    struct worker
+    {
+        worker() : exec_(NULL) {}
 
-        if (res == statement_backend::ef_success)
+        async_execution * exec_;
+        thread_event wakeup_;
+    };
+
+    async_pool() {}
+
+    static void worker_func(void * arg)
+    {
+        worker * const w = static_cast<worker *>(arg);
+        async_pool & pool = instance();
+
+        for (;;)
         {
-            // the "success" means that the statement executed correctly
-            // and for select statement this also means that some rows were read
+            w->exec_->run();
 
-            if (num > 0)
             {
-                gotData = true;
+                thread_lock lock(pool.mutex_);
+
+                if (pool.idle_.size() >= max_idle_threads)
+                {
+                    break;
+                }
 
-                // ensure into vectors have correct size
-                resize_intos(static_cast<std::size_t>(num));
+                w->exec_ = NULL;
+                w->wakeup_.reset();
+                pool.idle_.push_back(w);
             }
+
+            w->wakeup_.wait();
         }
-        else // res == ef_no_data
+
+        delete w;
+    }
+
+    thread_mutex mutex_;
+    std::vector<worker *> idle_;
+};
+
+} // namespace anonymous
+
+void statement_impl::execute_async(bool withDataExchange)
+{
+    try
+    {
+        if (async_ != NULL)
         {
-            // the "no data" means that the end-of-rowset condition was hit
-            // but still some rows might have been read (the last bunch of rows)
-            // it can also mean that the statement did not produce any results
+            throw soci_error("Asynchronous execution is already in progress.");
+        }
+
+        int const num = begin_execute(withDataExchange);
 
-            gotData = fetchSize_ > 1 ? resize_intos() : false;
+        async_ = new async_execution(backEnd_, num, effective_timeout());
+        if (backEnd_->execute_async(num))
+        {
+            async_->native_ = true;
+        }
+        else
+        {
+            async_pool::instance().submit(async_);
         }
+    }
+    catch (...)
+    {
+        delete async_;
+        async_ = NULL;
 
-        if (num > 0)
+        rethrow_current_exception_with_context("executing");
+    }
+}
+
+bool statement_impl::is_async_ready()
+{
+    if (async_ == NULL)
+    {
+        throw soci_error("No asynchronous execution in progress.");
+    }
+
+    return async_->native_ ? backEnd_->is_async_ready()
+                           : async_->done_.is_set();
+}
+
+bool statement_impl::finish_execute_async()
+{
+    if (async_ == NULL)
+    {
+        throw soci_error("No asynchronous execution in progress.");
+    }
+
+    try
+    {
+        statement_backend::exec_fetch_result res;
+        int const num = async_->num_;
+
+        if (async_->native_)
         {
-            post_fetch(gotData, false);
+            try
+            {
+                res = backEnd_->finish_execute_async(num);
+            }
+            catch (soci_error const &)
+            {
+                async_->timeoutGuard_.throw_if_expired();
+                throw;
+            }
         }
+        else
+        {
+            async_->done_.wait();
 
-        post_use(gotData);
+            if (async_->error_ != NULL)
+            {
+                async_->timeoutGuard_.throw_if_expired();
 
-        session_.set_got_data(gotData);
-        return gotData;
+                // This throws a copy, so it's fine that the original is
+                // destroyed together with async_ below.
+                async_->error_->rethrow();
+            }
+
+            res = async_->res_;
+        }
+
+        delete async_;
+        async_ = NULL;
+
+        return end_execute(res, num);
     }
     catch (...)
     {
+        // The execution is over even if it failed.
+        delete async_;
+        async_ = NULL;
+
         rethrow_current_exception_with_context("executing");
     }
 }
 
+int statement_impl::get_native_socket()
+{
+    if (async_ == NULL || !async_->native_)
+    {
+        return -1;
+    }
+
+    return backEnd_->get_native_socket();
+}
+
+int statement_impl::effective_timeout() const
+{
+    return timeoutMs_ >= 0 ? timeoutMs_ : session_.get_query_timeout();
+}
+
+void statement_impl::cancel_async()
+{
+    if (async_ == NULL)
+    {
+        return;
+    }
+
+    // We can't interrupt the execution, but we must wait until it completes
+    // before releasing the backend statement it uses.
+    if (async_->native_)
+    {
+        try
+        {
+            backEnd_->finish_execute_async(async_->num_);
+        }
+        catch (...)
+        {
+            // Errors are ignored here, as the result is discarded anyhow.
+        }
+    }
+    else
+    {
+        async_->done_.wait();
+    }
+
+    delete async_;
+    async_ = NULL;
+}
+
 long long statement_impl::get_affected_rows()
 {
     try
@@ -374,6 +799,11 @@ bool statement_impl::fetch()
 {
     try
     {
+        logger const & log = session_.get_logger();
+        long long const start = log.wants_query_metrics()
+                                    ? monotonic_time_ns()
+                                    : 0;
+
         if (fetchSize_ == 0)
         {
             truncate_intos();
@@ -404,7 +834,20 @@ bool statement_impl::fetch()
             fetchSize_ = newFetchSize;
         }
 
-        statement_backend::exec_fetch_result const res = backEnd_->fetch(static_cast<int>(fetchSize_));
+        statement_backend::exec_fetch_result res;
+        {
+            query_timeout_guard timeoutGuard(backEnd_, effective_timeout());
+            try
+            {
+                res = backEnd_->fetch(static_cast<int>(fetchSize_));
+            }
+            catch (soci_error const &)
+            {
+                timeoutGuard.throw_if_expired();
+                throw;
+            }
+        }
+
         if (res == statement_backend::ef_success)
         {
             // the "success" means that some number of rows was read
@@ -433,6 +876,17 @@ bool statement_impl::fetch()
         }
 
         post_fetch(gotData, true);
+
+        if (log.wants_query_metrics())
+        {
+            long long const duration = monotonic_time_ns() - start;
+            std::size_t const rows = fetched_rows(gotData);
+
+            metricsDurationNs_ += duration;
+            metricsRows_ += rows;
+            log.rows_fetched(query_, duration, rows);
+        }
+
         session_.set_got_data(gotData);
         return gotData;
     }
@@ -442,6 +896,41 @@ bool statement_impl::fetch()
     }
 }
 
+std::size_t statement_impl::fetched_rows(bool gotData)
+{
+    if (!gotData || (intos_.empty() && intosForRow_.empty()))
+    {
+        return 0;
+    }
+
+    // With vector into elements, they were resized to the number of rows
+    // actually fetched.
+    return initialFetchSize_ > 1 ? intos_size() : 1;
+}
+
+void statement_impl::start_query_metrics()
+{
+    metricsDurationNs_ = 0;
+    metricsRows_ = 0;
+    metricsActive_ = true;
+}
+
+void statement_impl::finish_query_metrics()
+{
+    if (!metricsActive_)
+    {
+        return;
+    }
+
+    metricsActive_ = false;
+
+    logger const & log = session_.get_logger();
+    if (log.wants_query_metrics())
+    {
+        log.query_finished(query_, metricsDurationNs_, metricsRows_);
+    }
+}
+
 std::size_t statement_impl::intos_size()
 {
     // this function does not need to take into account intosForRow_ elements,
@@ -668,6 +1157,8 @@ void statement_impl::describe()
     row_->clean_up();
 
     int const numcols = backEnd_->prepare_for_describe();
+    row_->reserve(static_cast<std::size_t>(numcols));
+
     for (int i = 1; i <= numcols; ++i)
     {
         data_type dtype;
@@ -717,6 +1208,41 @@ void statement_impl::describe()
     alreadyDescribed_ = true;
 }
 
+void statement_impl::describe_column_batch()
+{
+    if (intos_.size() != 1)
+    {
+        throw soci_error(
+            "Column batch can't be used with other into elements.");
+    }
+
+    // Check for the backend support before executing the query to describe
+    // it, the batch is only filled by the backend when fetching.
+    if (!backEnd_->set_column_batch(columnBatch_))
+    {
+        throw soci_error("Column batches are not supported by this backend.");
+    }
+
+    columnBatch_->clean_up();
+
+    int const numcols = backEnd_->prepare_for_describe();
+    for (int i = 1; i <= numcols; ++i)
+    {
+        data_type dtype;
+        std::string columnName;
+
+        backEnd_->describe_column(i, dtype, columnName);
+
+        column_properties props;
+        props.set_name(columnName);
+        props.set_data_type(dtype);
+
+        columnBatch_->add_column(props);
+    }
+
+    alreadyDescribed_ = true;
+}
+
 } // namespace details
 } // namespace soci
 
@@ -732,6 +1258,18 @@ void statement_impl::set_row(row * r)
     row_->uppercase_column_names(session_.get_uppercase_column_names());
 }
 
+void statement_impl::set_column_batch(column_batch * b)
+{
+    if (row_ != NULL || columnBatch_ != NULL)
+    {
+        throw soci_error(
+            "Column batch can't be used with other into elements.");
+    }
+
+    columnBatch_ = b;
+    columnBatch_->uppercase_column_names(session_.get_uppercase_column_names());
+}
+
 std::string statement_impl::rewrite_for_procedure_call(std::string const & query)
 {
     return backEnd_->rewrite_for_procedure_call(query);
@@ -10,13 +10,88 @@
 #include "soci/row.h"
 
 #include <cstddef>
-#include <map>
 #include <sstream>
 #include <string>
 
 using namespace soci;
 using namespace soci::details;
 
+namespace // anonymous
+{
+
+// Used to align all the objects allocated in the arena suitably for any type.
+union max_align
+{
+    long double ld_;
+    long long ll_;
+    double d_;
+    void * p_;
+};
+
+std::size_t const arena_alignment = sizeof(max_align);
+
+// Enough for a few fields of any types, the subsequent blocks are bigger.
+std::size_t const arena_initial_block_size = 1024;
+
+} // namespace anonymous
+
+void * values_arena::allocate(std::size_t size)
+{
+    size = (size + arena_alignment - 1) / arena_alignment * arena_alignment;
+
+    if (blocks_.empty() || used_ + size > blockSize_)
+    {
+        std::size_t newSize
+            = blocks_.empty() ? arena_initial_block_size : 2 * blockSize_;
+        if (newSize < size)
+        {
+            newSize = size;
+        }
+
+        blocks_.reserve(blocks_.size() + 1);
+        blocks_.push_back(new char[newSize]);
+        blockSize_ = newSize;
+        used_ = 0;
+    }
+
+    void * const p = blocks_.back() + used_;
+    used_ += size;
+    return p;
+}
+
+void values_arena::release()
+{
+    for (std::size_t i = 0; i != blocks_.size(); ++i)
+    {
+        delete [] blocks_[i];
+    }
+
+    blocks_.clear();
+    blockSize_ = 0;
+    used_ = 0;
+}
+
+std::size_t values::find_name(std::string const & name) const
+{
+    // The elements are usually looked up in the order in which they were
+    // created, so check the one after the last one set first.
+    std::size_t const count = names_.size();
+    if (setPos_ < count && names_[setPos_] == name)
+    {
+        return setPos_;
+    }
+
+    for (std::size_t i = 0; i != count; ++i)
+    {
+        if (names_[i] == name)
+        {
+            return i;
+        }
+    }
+
+    return count;
+}
+
 indicator values::get_indicator(std::size_t pos) const
 {
     if (row_)
@@ -37,14 +112,14 @@ indicator values::get_indicator(std::string const& name) const
     }
     else
     {
-        std::map<std::string, std::size_t>::const_iterator it = index_.find(name);
-        if (it == index_.end())
+        std::size_t const pos = find_name(name);
+        if (pos == uses_.size())
         {
             std::ostringstream msg;
             msg << "Column '" << name << "' not found";
             throw soci_error(msg.str());
         }
-        return *indicators_[it->second];
+        return *indicators_[pos];
     }
 }
 
@@ -99,6 +99,11 @@ struct PhonebookEntry2 : public PhonebookEntry
 {
 };
 
+// entry using positional values in its type conversion
+struct PhonebookEntry4 : public PhonebookEntry
+{
+};
+
 class PhonebookEntry3
 {
 public:
@@ -281,6 +286,24 @@ template<> struct type_conversion<PhonebookEntry3>
     }
 };
 
+template<> struct type_conversion<PhonebookEntry4>
+{
+    typedef soci::values base_type;
+
+    static void from_base(values const &v, indicator /* ind */, PhonebookEntry4 &pe)
+    {
+        pe.name = v.get<std::string>(0);
+        pe.phone = v.get<std::string>(1, "<NULL>");
+    }
+
+    static void to_base(PhonebookEntry4 const &pe, values &v, indicator &ind)
+    {
+        v << pe.name;
+        v.set<std::string>(pe.phone, pe.phone.empty() ? i_null : i_ok);
+        ind = i_ok;
+    }
+};
+
 } // namespace soci
 
 namespace soci
@@ -2203,6 +2226,26 @@ TEST_CASE_METHOD(common_tests, "Named parameters with similar names", "[core][us
     }
 }
 
+TEST_CASE_METHOD(common_tests, "Named parameters inside string literals", "[core][use][named-params]")
+{
+    soci::session sql(backEndFactory_, connectString_);
+
+    auto_table_creator tableCreator(tc_.table_creator_1(sql));
+
+    // Only the values whose names appear outside of the string literal must
+    // be bound, the other ones must be ignored.
+    soci::values v;
+    v.set("passwd", std::string("abc"));
+    v.set("other", std::string("xyz"));
+
+    sql << "INSERT INTO soci_test(str,name) VALUES(':other', :passwd)", use(v);
+
+    std::string str, name;
+    sql << "SELECT str, name FROM soci_test", into(str), into(name);
+    CHECK(str == ":other");
+    CHECK(name == "abc");
+}
+
 // transaction test
 TEST_CASE_METHOD(common_tests, "Transactions", "[core][transaction]")
 {
@@ -2730,6 +2773,41 @@ TEST_CASE_METHOD(common_tests, "Prepared insert with ORM", "[core][orm]")
     CHECK(count == 2);
 }
 
+TEST_CASE_METHOD(common_tests, "Prepared insert with positional ORM", "[core][orm]")
+{
+    soci::session sql(backEndFactory_, connectString_);
+
+    sql.uppercase_column_names(true);
+    auto_table_creator tableCreator(tc_.table_creator_3(sql));
+
+    PhonebookEntry4 temp;
+    statement insertStatement = (sql.prepare << "insert into soci_test values (:n, :p)", use(temp));
+
+    // The values bound by the first execution must be updated in place by the
+    // subsequent ones.
+    for (int i = 0; i != 3; ++i)
+    {
+        std::ostringstream oss;
+        oss << "name" << i;
+        temp.name = oss.str();
+        temp.phone = i == 1 ? std::string() : "phone";
+        insertStatement.execute(true);
+    }
+
+    int count = 0;
+    sql << "select count(*) from soci_test", into(count);
+    CHECK(count == 3);
+
+    indicator ind;
+    std::string phone;
+    sql << "select phone from soci_test where name = 'name1'", into(phone, ind);
+    CHECK(ind == i_null);
+
+    sql << "select phone from soci_test where name = 'name2'", into(phone, ind);
+    CHECK(ind == i_ok);
+    CHECK(phone == "phone");
+}
+
 TEST_CASE_METHOD(common_tests, "Partial match with ORM", "[core][orm]")
 {
     soci::session sql(backEndFactory_, connectString_);
@@ -3149,6 +3227,78 @@ TEST_CASE_METHOD(common_tests, "Reading strings from rowset", "[core][rowset]")
 
 }
 
+// test for reading rowset with multiple rows fetched at once
+TEST_CASE_METHOD(common_tests, "Reading rowset in batches", "[core][rowset]")
+{
+    soci::session sql(backEndFactory_, connectString_);
+
+    auto_table_creator tableCreator(tc_.table_creator_1(sql));
+    for (int i = 1; i <= 10; ++i)
+    {
+        std::string const str(i, 'x');
+        sql << "insert into soci_test(id, str) values(:id, :str)",
+            use(i), use(str);
+    }
+
+    SECTION("Last batch is incomplete")
+    {
+        rowset<int> rs = (sql.prepare
+                << "select id from soci_test order by id asc",
+                fetch_size(3));
+
+        int expected = 1;
+        for (rowset<int>::const_iterator it = rs.begin(); it != rs.end(); ++it)
+        {
+            CHECK(*it == expected++);
+        }
+
+        CHECK(expected == 11);
+    }
+
+    SECTION("Last batch is complete")
+    {
+        int id = 3;
+        rowset<std::string> rs = (sql.prepare
+                << "select str from soci_test where id > :id order by id asc",
+                use(id), fetch_size(7));
+
+        std::vector<std::string> v(rs.begin(), rs.end());
+        REQUIRE(v.size() == 7);
+        CHECK(v[0] == "xxxx");
+        CHECK(v[6] == "xxxxxxxxxx");
+    }
+
+    SECTION("Batch is bigger than the result")
+    {
+        rowset<int> rs = (sql.prepare
+                << "select id from soci_test where id > 7",
+                fetch_size(100));
+
+        CHECK(std::distance(rs.begin(), rs.end()) == 3);
+    }
+
+    SECTION("Fetch size is not supported for rows")
+    {
+        CHECK_THROWS_AS(rowset<row>((sql.prepare
+                << "select id from soci_test",
+                fetch_size(4))), soci_error&);
+    }
+
+    SECTION("Fetch size is not supported for statements")
+    {
+        std::vector<int> ids(10);
+        CHECK_THROWS_AS(statement((sql.prepare
+                << "select id from soci_test",
+                into(ids), fetch_size(4))), soci_error&);
+    }
+
+    SECTION("Invalid fetch size")
+    {
+        CHECK_THROWS_AS((sql.prepare << "select id from soci_test",
+                fetch_size(0)), soci_error&);
+    }
+}
+
 // test for handling troublemaker
 TEST_CASE_METHOD(common_tests, "Rowset expected exception", "[core][exception][rowset]")
 {
@@ -5244,6 +5394,315 @@ TEST_CASE_METHOD(common_tests, "Logger", "[core][log]")
     sql.set_logger(logger_orig);
 }
 
+TEST_CASE_METHOD(common_tests, "Logger metrics", "[core][log]")
+{
+    // Logger class collecting the statement metrics.
+    class test_metrics_log_impl : public soci::logger_impl
+    {
+    public:
+        explicit test_metrics_log_impl(std::vector<std::string>& events)
+            : m_events(events)
+        {
+        }
+
+        virtual void start_query(std::string const &)
+        {
+        }
+
+        virtual bool wants_query_metrics() const { return true; }
+
+        virtual void query_prepared(std::string const &, long long durationNs)
+        {
+            add_event("prepared", durationNs, 0);
+        }
+
+        virtual void query_executed(std::string const &, long long durationNs,
+            std::size_t rows)
+        {
+            add_event("executed", durationNs, rows);
+        }
+
+        virtual void rows_fetched(std::string const &, long long durationNs,
+            std::size_t rows)
+        {
+            add_event("fetched", durationNs, rows);
+        }
+
+        virtual void query_finished(std::string const &, long long durationNs,
+            std::size_t rows)
+        {
+            add_event("finished", durationNs, rows);
+        }
+
+    private:
+        void add_event(char const* name, long long durationNs, std::size_t rows)
+        {
+            CHECK( durationNs >= 0 );
+
+            std::ostringstream os;
+            os << name << ' ' << rows;
+            m_events.push_back(os.str());
+        }
+
+        virtual logger_impl* do_clone() const
+        {
+            return new test_metrics_log_impl(m_events);
+        }
+
+        std::vector<std::string>& m_events;
+    };
+
+    soci::session sql(backEndFactory_, connectString_);
+    auto_table_creator tableCreator(tc_.table_creator_1(sql));
+
+    soci::logger const logger_orig = sql.get_logger();
+
+    std::vector<std::string> events;
+    sql.set_logger(new test_metrics_log_impl(events));
+
+    SECTION("One-time query")
+    {
+        sql << "insert into soci_test(id) values(1)";
+
+        REQUIRE( events.size() == 3 );
+        CHECK( events[0] == "prepared 0" );
+        CHECK( events[1] == "executed 0" );
+        CHECK( events[2] == "finished 0" );
+    }
+
+    SECTION("Prepared statement")
+    {
+        {
+            int id;
+            statement st = (sql.prepare <<
+                "insert into soci_test(id) values(:id)", use(id));
+            for (id = 1; id <= 5; ++id)
+            {
+                st.execute(true);
+            }
+        }
+
+        REQUIRE( events.size() == 7 );
+        CHECK( events[0] == "prepared 0" );
+        CHECK( events[5] == "executed 0" );
+        CHECK( events[6] == "finished 0" );
+
+        events.clear();
+
+        {
+            std::vector<int> ids(2);
+            statement st = (sql.prepare <<
+                "select id from soci_test order by id", into(ids));
+            st.execute();
+            while (st.fetch())
+                ;
+        }
+
+        // We fetch 2 + 2 + 1 rows and then get the end of the result set.
+        REQUIRE( events.size() == 6 );
+        CHECK( events[0] == "prepared 0" );
+        CHECK( events[1] == "executed 0" );
+        CHECK( events[2] == "fetched 2" );
+        CHECK( events[3] == "fetched 2" );
+        CHECK( events[4] == "fetched 1" );
+        CHECK( events[5] == "finished 5" );
+    }
+
+    sql.set_logger(logger_orig);
+}
+
+TEST_CASE_METHOD(common_tests, "Asynchronous execution", "[core][async]")
+{
+    soci::session sql(backEndFactory_, connectString_);
+    auto_table_creator tableCreator(tc_.table_creator_1(sql));
+
+    int id;
+    statement ins = (sql.prepare <<
+        "insert into soci_test(id) values(:id)", use(id));
+    for (id = 1; id <= 3; ++id)
+    {
+        async_result r = ins.execute_async(true);
+        CHECK( !r.get() );
+    }
+
+    // Errors are reported using the same exception as by execute().
+    {
+        sql << "create unique index soci_test_id on soci_test(id)";
+
+        id = 1;
+        soci_error::error_category category = soci_error::unknown;
+        std::type_info const* errorType = NULL;
+        try
+        {
+            ins.execute(true);
+            FAIL( "exception expected for duplicate id" );
+        }
+        catch (soci_error const& e)
+        {
+            category = e.get_error_category();
+            errorType = &typeid(e);
+        }
+
+        try
+        {
+            ins.execute_async(true).get();
+            FAIL( "exception expected for duplicate id" );
+        }
+        catch (soci_error const& e)
+        {
+            CHECK( e.get_error_category() == category );
+            CHECK( typeid(e) == *errorType );
+        }
+    }
+
+    std::vector<int> ids(10);
+    statement st = (sql.prepare <<
+        "select id from soci_test order by id", into(ids));
+
+    async_result r = st.execute_async(true);
+
+    // The statement can't be executed again until the result is retrieved.
+    CHECK_THROWS_AS( st.execute(true), soci_error& );
+
+    while (!r.ready())
+    {
+        // A real program would wait for r.native_socket() to become readable
+        // if it's valid instead of busy looping here.
+    }
+
+    CHECK( r.get() );
+    REQUIRE( ids.size() == 3 );
+    CHECK( ids[0] == 1 );
+    CHECK( ids[2] == 3 );
+
+    // There is nothing to wait for any more.
+    CHECK_THROWS_AS( r.get(), soci_error& );
+
+    // Destroying the statement while the execution is pending must be safe.
+    {
+        int count;
+        statement cnt = (sql.prepare <<
+            "select count(*) from soci_test", into(count));
+        cnt.execute_async(true);
+    }
+
+    int count = 0;
+    sql << "select count(*) from soci_test", into(count);
+    CHECK( count == 3 );
+}
+
+TEST_CASE_METHOD(common_tests, "Column batch", "[core][column-batch]")
+{
+    soci::session sql(backEndFactory_, connectString_);
+    auto_table_creator tableCreator(tc_.table_creator_1(sql));
+
+    {
+        int id;
+        std::string str;
+        indicator ind;
+        statement ins = (sql.prepare <<
+            "insert into soci_test(id, str) values(:id, :str)",
+            use(id), use(str, ind));
+
+        char const* const strs[] = { "a", "bc", "", NULL, "def" };
+        for (id = 1; id <= 5; ++id)
+        {
+            if (strs[id - 1])
+            {
+                str = strs[id - 1];
+                ind = i_ok;
+            }
+            else
+            {
+                ind = i_null;
+            }
+
+            ins.execute(true);
+        }
+    }
+
+    column_batch batch(3);
+    statement st = (sql.prepare <<
+        "select id, str from soci_test order by id", into(batch));
+
+    try
+    {
+        st.execute();
+    }
+    catch (soci_error const& e)
+    {
+        if (e.get_error_message().find("not supported") == std::string::npos)
+            throw;
+
+        WARN("Column batches not supported by this backend, skipping the test.");
+        return;
+    }
+
+    REQUIRE( st.fetch() );
+    REQUIRE( batch.get_number_of_columns() == 2 );
+    CHECK( batch.get_properties(0).get_data_type() == dt_integer );
+    CHECK( batch.get_properties(1).get_data_type() == dt_string );
+    CHECK( batch.find_column(batch.get_properties(1).get_name()) == 1 );
+
+    // The values must be retrieved using the type of the column.
+    CHECK_THROWS_AS( batch.get_values<double>(0), soci_error& );
+    CHECK_THROWS_AS( batch.get_offsets(0), soci_error& );
+
+    REQUIRE( batch.size() == 3 );
+    int const* ids = batch.get_values<int>(0);
+    CHECK( ids[0] == 1 );
+    CHECK( ids[1] == 2 );
+    CHECK( ids[2] == 3 );
+
+    std::size_t len = 0;
+    char const* s = batch.get_string(1, 0, len);
+    CHECK( std::string(s, len) == "a" );
+    s = batch.get_string(1, 1, len);
+    CHECK( std::string(s, len) == "bc" );
+
+    // Some databases (e.g. Oracle) return NULL instead of empty strings.
+    if ( !batch.is_null(1, 2) )
+    {
+        batch.get_string(1, 2, len);
+        CHECK( len == 0 );
+    }
+
+    std::size_t const* offsets = batch.get_offsets(1);
+    CHECK( offsets[0] == 0 );
+    CHECK( offsets[1] == 1 );
+    CHECK( offsets[2] == 3 );
+    CHECK( std::string(batch.get_bytes(1), offsets[2]) == "abc" );
+
+    // The second batch is partial and contains a NULL value.
+    REQUIRE( st.fetch() );
+    REQUIRE( batch.size() == 2 );
+    ids = batch.get_values<int>(0);
+    CHECK( ids[0] == 4 );
+    CHECK( ids[1] == 5 );
+    CHECK( batch.is_null(1, 0) );
+    CHECK( !batch.is_null(1, 1) );
+    CHECK( batch.get_validity(0)[0] == 3 );
+    CHECK( batch.get_validity(1)[0] == 2 );
+    s = batch.get_string(1, 1, len);
+    CHECK( std::string(s, len) == "def" );
+    CHECK_THROWS_AS( batch.is_null(1, 2), soci_error& );
+
+    CHECK( !st.fetch() );
+    CHECK( batch.size() == 0 );
+
+    // Executing the statement again fetches the first batch immediately.
+    REQUIRE( st.execute(true) );
+    REQUIRE( batch.size() == 3 );
+    CHECK( batch.get_values<int>(0)[0] == 1 );
+    CHECK( batch.get_values<int>(0)[2] == 3 );
+
+    // The batch can't be combined with other into elements.
+    int id;
+    statement st2 = (sql.prepare <<
+        "select id, str from soci_test", into(batch), into(id));
+    CHECK_THROWS_AS( st2.execute(true), soci_error& );
+}
+
 // These tests are disabled by default, as they require manual intevention, but
 // can be run by explicitly giving their names on the command line.
 
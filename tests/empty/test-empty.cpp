@@ -18,6 +18,12 @@
 #include <cstdlib>
 #include <ctime>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
 using namespace soci;
 
 std::string connectString;
@@ -141,6 +147,202 @@ TEST_CASE("Dummy test", "[empty]")
     }
 }
 
+TEST_CASE("Statement cache", "[empty]")
+{
+    soci::session sql(backEnd, connectString);
+
+    CHECK(sql.get_statement_cache_size() == 0);
+
+    // Nothing is cached by default.
+    sql << "select";
+    sql << "select";
+    CHECK(sql.get_statement_cache_hits() == 0);
+    CHECK(sql.get_statement_cache_misses() == 0);
+
+    sql.set_statement_cache_size(2);
+    CHECK(sql.get_statement_cache_size() == 2);
+
+    int i = 7;
+    sql << "select", into(i);
+    sql << "insert", use(i);
+    sql << "select", into(i);
+    CHECK(sql.get_statement_cache_hits() == 1);
+    CHECK(sql.get_statement_cache_misses() == 2);
+
+    // This evicts the least recently used "insert".
+    sql << "update", use(i);
+    sql << "insert", use(i);
+    CHECK(sql.get_statement_cache_hits() == 1);
+    CHECK(sql.get_statement_cache_misses() == 4);
+
+    // Only the most recently used "insert" is kept after shrinking.
+    sql.set_statement_cache_size(1);
+    sql << "insert", use(i);
+    sql << "update", use(i);
+    CHECK(sql.get_statement_cache_hits() == 2);
+    CHECK(sql.get_statement_cache_misses() == 5);
+
+    sql.set_statement_cache_size(0);
+    sql << "insert", use(i);
+    CHECK(sql.get_statement_cache_hits() == 2);
+    CHECK(sql.get_statement_cache_misses() == 5);
+}
+
+TEST_CASE("Connection pool", "[empty][pool]")
+{
+    soci::connection_pool pool(3);
+
+    // Sessions are leased in order initially.
+    CHECK(pool.lease() == 0);
+    CHECK(pool.lease() == 1);
+
+    // And then the most recently given back one is reused first.
+    pool.give_back(0);
+    pool.give_back(1);
+    CHECK(pool.lease() == 1);
+    CHECK(pool.lease() == 0);
+    CHECK(pool.lease() == 2);
+
+    std::size_t pos = 17;
+    CHECK(!pool.try_lease(pos, 0));
+    CHECK(!pool.try_lease(pos, 10));
+    CHECK(pos == 17);
+
+    soci::connection_pool_stats stats = pool.get_stats();
+    CHECK(stats.size == 3);
+    CHECK(stats.inUse == 3);
+    CHECK(stats.waiting == 0);
+    CHECK(stats.leases == 5);
+    CHECK(stats.waits == 1);
+    CHECK(stats.timeouts == 2);
+    CHECK(stats.totalWaitNs >= stats.maxWaitNs);
+    CHECK(stats.maxWaitNs >= 10000000);
+
+    pool.give_back(2);
+    CHECK_THROWS_AS(pool.give_back(2), soci::soci_error&);
+
+    CHECK(pool.try_lease(pos, 0));
+    CHECK(pos == 2);
+
+    pool.give_back(0);
+    pool.give_back(1);
+    pool.give_back(2);
+
+    stats = pool.get_stats();
+    CHECK(stats.inUse == 0);
+    CHECK(stats.leases == 6);
+    CHECK(stats.totalLeaseNs >= stats.maxLeaseNs);
+}
+
+static void sleep_ms(int ms)
+{
+#ifdef _WIN32
+    Sleep(ms);
+#else
+    usleep(ms * 1000);
+#endif
+}
+
+TEST_CASE("Elastic connection pool", "[empty][pool]")
+{
+    connection_parameters params(backEnd, connectString);
+
+    connection_pool_options options;
+    options.minSize = 2;
+    options.maxSize = 3;
+    options.idleTimeout = 50;
+
+    soci::connection_pool pool(params, options);
+
+    // Only the minimal number of sessions is opened initially.
+    CHECK(pool.get_stats().openSessions == 2);
+    CHECK(pool.at(0).is_connected());
+    CHECK(pool.at(1).is_connected());
+    CHECK(!pool.at(2).is_connected());
+
+    // And the rest is opened on demand, in the background: try_lease()
+    // doesn't wait for it to happen.
+    {
+        soci::session sql0(pool);
+        soci::session sql1(pool);
+
+        std::size_t pos = 17;
+        CHECK(!pool.try_lease(pos, 0));
+        CHECK(pos == 17);
+
+        bool leased = false;
+        for (int n = 0; n < 100 && !leased; ++n)
+        {
+            leased = pool.try_lease(pos, 0);
+            if (!leased)
+            {
+                sleep_ms(10);
+            }
+        }
+
+        REQUIRE(leased);
+        CHECK(pos == 2);
+        CHECK(pool.at(pos).is_connected());
+        CHECK(pool.get_stats().openSessions == 3);
+        CHECK(pool.get_stats().waits == 0);
+        pool.give_back(pos);
+    }
+
+    {
+        soci::session sql0(pool);
+        soci::session sql1(pool);
+        soci::session sql2(pool);
+        CHECK(sql2.is_connected());
+        CHECK(pool.get_stats().openSessions == 3);
+
+        std::size_t pos;
+        CHECK(!pool.try_lease(pos, 0));
+    }
+
+    // Broken sessions are not returned but reconnected in the background.
+    std::size_t const pos = pool.lease();
+    pool.at(pos).close();
+    pool.give_back(pos);
+
+    // The same session can only be leased again if it had been already
+    // reconnected by the maintenance thread.
+    std::size_t const pos2 = pool.lease();
+    CHECK((pos2 != pos || pool.get_stats().reconnects == 1));
+    CHECK(pool.at(pos2).is_connected());
+    pool.give_back(pos2);
+
+    for (int n = 0; n < 100 && pool.get_stats().reconnects == 0; ++n)
+    {
+        sleep_ms(10);
+    }
+
+    CHECK(pool.get_stats().reconnects == 1);
+    CHECK(pool.at(pos).is_connected());
+
+    // Idle sessions are closed, but not below the minimal number.
+    for (int n = 0; n < 100 && pool.get_stats().openSessions != 2; ++n)
+    {
+        sleep_ms(10);
+    }
+
+    soci::connection_pool_stats const stats = pool.get_stats();
+    CHECK(stats.openSessions == 2);
+    CHECK(stats.evictions == 1);
+    CHECK(stats.inUse == 0);
+
+    // Closed session is reopened when needed again.
+    {
+        soci::session sql0(pool);
+        soci::session sql1(pool);
+        soci::session sql2(pool);
+        CHECK(sql0.is_connected());
+        CHECK(sql1.is_connected());
+        CHECK(sql2.is_connected());
+    }
+
+    options.minSize = 4;
+    CHECK_THROWS_AS(soci::connection_pool(params, options), soci::soci_error&);
+}
 
 int main(int argc, char** argv)
 {
@@ -794,6 +794,286 @@ TEST_CASE("MySQL last insert id", "[mysql][last-insert-id]")
     CHECK(id == 42);
 }
 
+struct prepared_table_creator : table_creator_base
+{
+    prepared_table_creator(soci::session & sql)
+        : table_creator_base(sql)
+    {
+        sql << "create table soci_test(id integer, d double, s text, "
+            "t datetime, u bigint unsigned)";
+    }
+};
+
+TEST_CASE("MySQL prepared statements", "[mysql][prepared]")
+{
+    soci::session sql(backEnd, connectString + " prepared=1");
+
+    prepared_table_creator tableCreator(sql);
+
+    std::vector<int> ids;
+    std::vector<double> ds;
+    std::vector<std::string> ss;
+    std::vector<std::tm> ts;
+    std::vector<unsigned long long> us;
+    std::vector<indicator> inds;
+    for (int i = 0; i != 100; ++i)
+    {
+        ids.push_back(i);
+        ds.push_back(i + 0.5);
+        ss.push_back(std::string(i * 10, 'x') + "'\\:");
+
+        std::tm t = std::tm();
+        t.tm_year = 120;
+        t.tm_mon = 1;
+        t.tm_mday = 1 + i % 28;
+        t.tm_hour = i % 24;
+        t.tm_min = 30;
+        ts.push_back(t);
+
+        us.push_back(0xffffffffffffff00ULL + i % 10);
+        inds.push_back(i % 3 ? i_ok : i_null);
+    }
+
+    statement ins = (sql.prepare <<
+        "insert into soci_test(id, d, s, t, u) values(:i, :d, :s, :t, :u)",
+        use(ids), use(ds), use(ss, inds), use(ts), use(us));
+    ins.execute(true);
+    CHECK(ins.get_affected_rows() == 100);
+
+    // Check that the same statement can be reused with different values.
+    int id = 100;
+    double d = -1.25;
+    std::string str = "single";
+    std::tm t = ts[0];
+    unsigned long long u = 17;
+    indicator ind = i_null;
+    statement ins1 = (sql.prepare <<
+        "insert into soci_test(id, d, s, t, u) values(:i, :d, :s, :t, :u)",
+        use(id), use(d), use(str), use(t), use(u, ind));
+    ins1.execute(true);
+    id = 101;
+    ind = i_ok;
+    ins1.execute(true);
+
+    int count = 0;
+    sql << "select count(*) from soci_test where u is null", into(count);
+    CHECK(count == 1);
+
+    SECTION("vectors")
+    {
+        std::vector<int> ids2(30);
+        std::vector<double> ds2(30);
+        std::vector<std::string> ss2(30);
+        std::vector<std::tm> ts2(30);
+        std::vector<unsigned long long> us2(30);
+        std::vector<indicator> inds2(30);
+
+        statement st = (sql.prepare <<
+            "select id, d, s, t, u from soci_test where id < :n order by id",
+            use(id, "n"), into(ids2), into(ds2), into(ss2, inds2),
+            into(ts2), into(us2));
+
+        id = 100;
+        st.execute();
+
+        int total = 0;
+        while (st.fetch())
+        {
+            for (std::size_t i = 0; i != ids2.size(); ++i, ++total)
+            {
+                CHECK(ids2[i] == total);
+                CHECK(ds2[i] == ids[total] + 0.5);
+                if (total % 3)
+                {
+                    REQUIRE(inds2[i] == i_ok);
+                    CHECK(ss2[i] == ss[total]);
+                }
+                else
+                {
+                    CHECK(inds2[i] == i_null);
+                }
+                CHECK(ts2[i].tm_mday == ts[total].tm_mday);
+                CHECK(ts2[i].tm_hour == ts[total].tm_hour);
+                CHECK(ts2[i].tm_min == 30);
+                CHECK(us2[i] == us[total]);
+            }
+        }
+
+        CHECK(total == 100);
+
+        // Execute the same statement again with a different parameter.
+        id = 10;
+        ids2.resize(30);
+        st.execute(true);
+        CHECK(ids2.size() == 10);
+    }
+
+    SECTION("single values and rows")
+    {
+        statement st = (sql.prepare <<
+            "select d, s, u from soci_test where id = :id or id = :id + 1000",
+            use(id, "id"), into(d), into(str), into(u, ind));
+
+        id = 100;
+        st.execute(true);
+        CHECK(d == -1.25);
+        CHECK(str == "single");
+        CHECK(ind == i_null);
+
+        id = 101;
+        st.execute(true);
+        CHECK(ind == i_ok);
+        CHECK(u == 17);
+
+        row r;
+        statement st2 = (sql.prepare <<
+            "select id, d, s, t from soci_test where id = :id",
+            use(id), into(r));
+        id = 2;
+        st2.execute(true);
+        CHECK(r.get<int>(0) == 2);
+        CHECK(r.get<double>(1) == 2.5);
+        CHECK(r.get<std::string>(2) == ss[2]);
+        CHECK(r.get<std::tm>(3).tm_mday == 3);
+    }
+}
+
+TEST_CASE("MySQL vector fetch with many columns", "[mysql][vector]")
+{
+    soci::session sql(backEnd, connectString);
+
+    prepared_table_creator tableCreator(sql);
+
+    for (int i = 0; i != 25; ++i)
+    {
+        double const d = i / 4.;
+        std::string const str(i, 'z');
+        unsigned long long const u = i * 1000ULL;
+        sql << "insert into soci_test(id, d, s, u) values(:i, :d, :s, :u)",
+            use(i), use(d), use(str), use(u);
+    }
+
+    std::vector<int> ids(10);
+    std::vector<double> ds(10);
+    std::vector<std::string> ss(10);
+    std::vector<std::tm> ts(10);
+    std::vector<indicator> tinds(10);
+    std::vector<unsigned long long> us(10);
+    statement st = (sql.prepare <<
+        "select id, d, s, t, u from soci_test order by id",
+        into(ids), into(ds), into(ss), into(ts, tinds), into(us));
+    st.execute();
+
+    int n = 0;
+    while (st.fetch())
+    {
+        for (std::size_t i = 0; i != ids.size(); ++i, ++n)
+        {
+            CHECK(ids[i] == n);
+            CHECK(ds[i] == n / 4.);
+            CHECK(ss[i] == std::string(n, 'z'));
+            CHECK(tinds[i] == i_null);
+            CHECK(us[i] == n * 1000ULL);
+        }
+    }
+
+    CHECK(n == 25);
+}
+
+void check_streaming_results(std::string const& options)
+{
+    soci::session sql(backEnd, connectString + options);
+
+    prepared_table_creator tableCreator(sql);
+
+    int const numRows = 1000;
+    std::vector<int> ids;
+    std::vector<std::string> ss;
+    std::vector<indicator> inds;
+    for (int i = 0; i != numRows; ++i)
+    {
+        ids.push_back(i);
+        ss.push_back(std::string(i, 'y'));
+        inds.push_back(i % 5 ? i_ok : i_null);
+    }
+    sql << "insert into soci_test(id, s) values(:i, :s)", use(ids), use(ss, inds);
+
+    // Fetch the rows one by one.
+    {
+        soci::rowset<soci::row> rs = (sql.prepare <<
+            "select id, s from soci_test order by id");
+
+        int n = 0;
+        for (soci::rowset<soci::row>::const_iterator it = rs.begin();
+             it != rs.end();
+             ++it, ++n)
+        {
+            soci::row const& r = *it;
+            CHECK(r.get<int>(0) == n);
+            if (n % 5)
+            {
+                CHECK(r.get<std::string>(1) == ss[n]);
+            }
+            else
+            {
+                CHECK(r.get_indicator(1) == i_null);
+            }
+        }
+
+        CHECK(n == numRows);
+    }
+
+    // Fetch the rows in batches.
+    {
+        std::vector<int> ids2(64);
+        std::vector<std::string> ss2(64);
+        std::vector<indicator> inds2(64);
+        statement st = (sql.prepare <<
+            "select id, s from soci_test order by id",
+            into(ids2), into(ss2, inds2));
+        st.execute();
+
+        int n = 0;
+        while (st.fetch())
+        {
+            for (std::size_t i = 0; i != ids2.size(); ++i, ++n)
+            {
+                CHECK(ids2[i] == n);
+                CHECK(inds2[i] == (n % 5 ? i_ok : i_null));
+                if (inds2[i] == i_ok)
+                {
+                    CHECK(ss2[i] == ss[n]);
+                }
+            }
+        }
+
+        CHECK(n == numRows);
+    }
+
+    {
+        // Not all rows are fetched here, but this shouldn't prevent the
+        // subsequent statements from working.
+        int id = -1;
+        sql << "select id from soci_test order by id", into(id);
+        CHECK(id == 0);
+
+        int count = 0;
+        sql << "select count(*) from soci_test", into(count);
+        CHECK(count == numRows);
+    }
+}
+
+TEST_CASE("MySQL streaming results", "[mysql][use-result]")
+{
+    check_streaming_results(" use_result=1");
+}
+
+TEST_CASE("MySQL streaming prepared statements results",
+    "[mysql][use-result][prepared]")
+{
+    check_streaming_results(" use_result=1 prepared=1");
+}
+
 std::string escape_string(soci::session& sql, const std::string& s)
 {
     mysql_session_backend* backend = static_cast<mysql_session_backend*>(
@@ -7,6 +7,7 @@
 
 #include "soci/soci.h"
 #include "soci/postgresql/soci-postgresql.h"
+#include "soci/postgresql/bulk-loader.h"
 #include "common-tests.h"
 #include <iostream>
 #include <sstream>
@@ -499,6 +500,474 @@ TEST_CASE("PostgreSQL get affected rows", "[postgresql][affected-rows]")
     CHECK(st2.get_affected_rows() == 5);
 }
 
+TEST_CASE("PostgreSQL statement cache", "[postgresql][statement-cache]")
+{
+    soci::session sql(backEnd, connectString);
+
+    table_creator_for_test11 tableCreator(sql);
+
+    sql.set_statement_cache_size(2);
+
+    for (int i = 0; i != 10; i++)
+    {
+        sql << "insert into soci_test(val) values(:val)", use(i);
+    }
+
+    CHECK(sql.get_statement_cache_hits() == 9);
+    CHECK(sql.get_statement_cache_misses() == 1);
+
+    int count = 0;
+    sql << "select count(*) from soci_test", into(count);
+    CHECK(count == 10);
+
+    // The cached statements are prepared on the server, including this one,
+    // and the least recently used of them is deallocated when it's evicted.
+    int prepared = 0;
+    sql << "select count(*) from pg_prepared_statements", into(prepared);
+    CHECK(prepared == 3);
+
+    sql << "select count(*) from pg_prepared_statements", into(prepared);
+    CHECK(prepared == 2);
+
+    CHECK(sql.get_statement_cache_hits() == 10);
+    CHECK(sql.get_statement_cache_misses() == 3);
+
+    sql.set_statement_cache_size(0);
+
+    sql << "select count(*) from pg_prepared_statements", into(prepared);
+    CHECK(prepared == 0);
+}
+
+TEST_CASE("PostgreSQL pipeline mode bulk insert", "[postgresql][pipeline]")
+{
+#ifdef LIBPQ_HAS_PIPELINING
+    soci::session sql(backEnd, connectString + " pipeline=true");
+
+    table_creator_for_test11 tableCreator(sql);
+
+    std::vector<int> v;
+    for (int i = 0; i != 2500; ++i)
+    {
+        v.push_back(i);
+    }
+
+    statement st = (sql.prepare <<
+        "insert into soci_test(val) values(:val)", use(v));
+    st.execute(true);
+    CHECK(st.get_affected_rows() == 2500);
+
+    int count = 0;
+    sql << "select count(*) from soci_test", into(count);
+    CHECK(count == 2500);
+
+    // One-time queries use the pipeline too.
+    sql << "delete from soci_test where val = :val", use(v);
+    sql << "select count(*) from soci_test", into(count);
+    CHECK(count == 0);
+
+    // An error in the middle of the batch is reported and, outside of an
+    // explicit transaction, none of the rows is inserted.
+    std::vector<std::string> w(3, "1");
+    w[1] = "a";
+    statement st2 = (sql.prepare <<
+        "insert into soci_test(val) values(:val)", use(w));
+    CHECK_THROWS_AS(st2.execute(true), soci_error&);
+    CHECK(st2.get_affected_rows() == 0);
+
+    // The session must remain usable after the error.
+    sql << "select count(*) from soci_test", into(count);
+    CHECK(count == 0);
+#else
+    WARN("Pipeline mode not supported by this libpq version.");
+#endif
+}
+
+TEST_CASE("PostgreSQL fetch size", "[postgresql][fetchsize]")
+{
+    soci::session sql(backEnd, connectString + " fetchsize=7");
+
+    table_creator_for_test11 tableCreator(sql);
+
+    std::vector<int> v;
+    for (int i = 0; i != 100; ++i)
+    {
+        v.push_back(i);
+    }
+    sql << "insert into soci_test(val) values(:val)", use(v);
+
+    SECTION("Bulk fetch")
+    {
+        // Use a vector size which is not a multiple of the fetch size.
+        std::vector<int> w(10);
+        statement st = (sql.prepare <<
+            "select val from soci_test order by val", into(w));
+        st.execute();
+
+        int expected = 0;
+        while (st.fetch())
+        {
+            // All batches must be full as the number of rows is a multiple
+            // of the vector size.
+            CHECK(w.size() == 10);
+            for (std::size_t i = 0; i != w.size(); ++i)
+            {
+                CHECK(w[i] == expected++);
+            }
+            w.resize(10);
+        }
+        CHECK(expected == 100);
+    }
+
+    SECTION("Fetch size greater than vector size")
+    {
+        soci::session sql2(backEnd, connectString + " fetchsize=25");
+
+        std::vector<int> w(10);
+        statement st = (sql2.prepare <<
+            "select val from soci_test order by val", into(w));
+        st.execute();
+
+        int expected = 0;
+        while (st.fetch())
+        {
+            CHECK(w.size() == 10);
+            for (std::size_t i = 0; i != w.size(); ++i)
+            {
+                CHECK(w[i] == expected++);
+            }
+            w.resize(10);
+        }
+        CHECK(expected == 100);
+    }
+
+    SECTION("Holdable cursor only outside of transaction")
+    {
+        std::vector<int> w(10);
+        int holdable = -1;
+
+        {
+            soci::transaction tr(sql);
+
+            statement st = (sql.prepare <<
+                "select val from soci_test order by val", into(w));
+            st.execute(true);
+
+            sql << "select count(*) from pg_cursors where is_holdable",
+                into(holdable);
+            CHECK(holdable == 0);
+
+            tr.commit();
+        }
+
+        statement st = (sql.prepare <<
+            "select val from soci_test order by val", into(w));
+        st.execute(true);
+
+        sql << "select count(*) from pg_cursors where is_holdable",
+            into(holdable);
+        CHECK(holdable == 1);
+    }
+
+    SECTION("Cursor closed by the end of its transaction")
+    {
+        std::vector<int> w(10);
+
+        soci::transaction tr(sql);
+
+        statement st = (sql.prepare <<
+            "select val from soci_test order by val", into(w));
+        st.execute(true);
+
+        tr.commit();
+
+        // Re-executing the statement must not fail, nor abort the current
+        // transaction, because the previous cursor doesn't exist any more.
+        soci::transaction tr2(sql);
+
+        w.resize(10);
+        st.execute(true);
+        REQUIRE(w.size() == 10);
+        CHECK(w[0] == 0);
+
+        int count = 0;
+        sql << "select count(*) from soci_test", into(count);
+        CHECK(count == 100);
+
+        tr2.commit();
+    }
+
+    SECTION("Single fetch")
+    {
+        int const n = 50;
+        int val = 0;
+        statement st = (sql.prepare <<
+            "select val from soci_test where val < :n order by val",
+            use(n), into(val));
+        st.execute();
+
+        int expected = 0;
+        while (st.fetch())
+        {
+            CHECK(val == expected++);
+        }
+        CHECK(expected == 50);
+    }
+
+    SECTION("Rowset")
+    {
+        soci::transaction tr(sql);
+
+        int expected = 0;
+        soci::rowset<soci::row> rs = (sql.prepare <<
+            "select val from soci_test order by val");
+        for (soci::rowset<soci::row>::const_iterator it = rs.begin();
+             it != rs.end(); ++it)
+        {
+            CHECK(it->get<int>(0) == expected++);
+        }
+        CHECK(expected == 100);
+
+        tr.commit();
+    }
+
+    SECTION("Partial fetch")
+    {
+        // Abandoning the cursor before reading all rows must not prevent
+        // executing further statements.
+        int val = 0;
+        statement st = (sql.prepare <<
+            "select val from soci_test order by val", into(val));
+        st.execute(true);
+        CHECK(val == 0);
+        st.execute(true);
+        CHECK(val == 0);
+
+        int count = 0;
+        sql << "select count(*) from soci_test", into(count);
+        CHECK(count == 100);
+    }
+}
+
+TEST_CASE("PostgreSQL asynchronous execution after error", "[postgresql][async]")
+{
+    soci::session sql(backEnd, connectString);
+
+    table_creator_for_test11 tableCreator(sql);
+
+    std::string val;
+    statement st = (sql.prepare <<
+        "insert into soci_test(val) values(:val)", use(val));
+
+    val = "not a number";
+    CHECK_THROWS_AS(st.execute(true), postgresql_soci_error&);
+
+    // The error from the previous execution must not be reported again.
+    val = "17";
+    CHECK_NOTHROW(st.execute_async(true).get());
+
+    int count = 0;
+    sql << "select count(*) from soci_test where val = 17", into(count);
+    CHECK(count == 1);
+}
+
+struct table_creator_for_binary : table_creator_base
+{
+    table_creator_for_binary(soci::session & sql)
+        : table_creator_base(sql)
+    {
+        sql << "create table soci_test(id integer, sh int2, ll int8, "
+               "d float8, b boolean, tm timestamp, dt date, txt text, "
+               "bin bytea)";
+    }
+};
+
+TEST_CASE("PostgreSQL binary format", "[postgresql][binary]")
+{
+    soci::session sql(backEnd, connectString + " binary=true");
+
+    table_creator_for_binary tableCreator(sql);
+
+    std::tm tm = std::tm();
+    tm.tm_year = 2023 - 1900;
+    tm.tm_mon = 6 - 1;
+    tm.tm_mday = 17;
+    tm.tm_hour = 22;
+    tm.tm_min = 51;
+    tm.tm_sec = 3;
+
+    {
+        int id = 1;
+        short sh = -7;
+        long long ll = 9000000000LL;
+        double d = 3.25;
+        int b = 1;
+        std::string txt("hello");
+
+        statement st = (sql.prepare <<
+            "insert into soci_test(id, sh, ll, d, b, tm, dt, txt, bin) "
+            "values(:id, :sh, :ll, :d, :b, :tm, :tm, :txt, '\\x0102')",
+            use(id, "id"), use(sh, "sh"), use(ll, "ll"), use(d, "d"),
+            use(b, "b"), use(tm, "tm"), use(txt, "txt"));
+        st.execute(true);
+
+        // Re-executing the statement must use the new values.
+        id = 2;
+        sh = 32000;
+        st.execute(true);
+
+        int count = 0;
+        sql << "select count(*) from soci_test where sh = 32000", into(count);
+        CHECK(count == 1);
+    }
+
+    {
+        int id = 0;
+        short sh = 0;
+        long long ll = 0;
+        double d = 0;
+        int b = 0;
+        std::tm tm2 = std::tm();
+        std::tm dt = std::tm();
+        std::string txt, bin, llStr;
+        int const wantedId = 1;
+
+        statement st = (sql.prepare <<
+            "select id, sh, ll, d, b, tm, dt, txt, bin, ll "
+            "from soci_test where id = :id",
+            use(wantedId), into(id), into(sh), into(ll), into(d), into(b),
+            into(tm2), into(dt), into(txt), into(bin), into(llStr));
+        st.execute(true);
+
+        CHECK(id == 1);
+        CHECK(sh == -7);
+        CHECK(ll == 9000000000LL);
+        CHECK(d == 3.25);
+        CHECK(b == 1);
+        CHECK(tm2.tm_year == 2023 - 1900);
+        CHECK(tm2.tm_mon == 6 - 1);
+        CHECK(tm2.tm_mday == 17);
+        CHECK(tm2.tm_hour == 22);
+        CHECK(tm2.tm_min == 51);
+        CHECK(tm2.tm_sec == 3);
+        CHECK(dt.tm_year == 2023 - 1900);
+        CHECK(dt.tm_mday == 17);
+        CHECK(dt.tm_hour == 0);
+        CHECK(txt == "hello");
+
+        // The values of non-text types are represented in the same way as
+        // in text mode when converting them to strings.
+        CHECK(bin == "\\x0102");
+        CHECK(llStr == "9000000000");
+    }
+
+    {
+        std::vector<int> ids(3);
+        std::vector<double> ds(3);
+        ids[0] = 10; ds[0] = 0.5;
+        ids[1] = 11; ds[1] = -1.5;
+        ids[2] = 12; ds[2] = 1e100;
+
+        std::vector<indicator> inds(3, i_ok);
+        inds[1] = i_null;
+
+        statement st = (sql.prepare <<
+            "insert into soci_test(id, d) values(:id, :d)",
+            use(ids), use(ds, inds));
+        st.execute(true);
+        CHECK(st.get_affected_rows() == 3);
+
+        std::vector<int> ids2(10);
+        std::vector<double> ds2(10);
+        std::vector<indicator> inds2(10);
+        statement st2 = (sql.prepare <<
+            "select id, d from soci_test where id >= 10 order by id",
+            into(ids2), into(ds2, inds2));
+        st2.execute(true);
+
+        REQUIRE(ids2.size() == 3);
+        CHECK(ids2[0] == 10);
+        CHECK(ds2[0] == 0.5);
+        CHECK(inds2[1] == i_null);
+        CHECK(ds2[2] == 1e100);
+    }
+}
+
+struct table_creator_for_binary_strings : table_creator_base
+{
+    table_creator_for_binary_strings(soci::session & sql)
+        : table_creator_base(sql)
+    {
+        sql << "create table soci_test(id integer, tm timestamp, dt date, "
+               "r real, d float8)";
+    }
+};
+
+TEST_CASE("PostgreSQL binary format values as strings",
+    "[postgresql][binary]")
+{
+    soci::session sql(backEnd, connectString + " binary=true");
+
+    table_creator_for_binary_strings tableCreator(sql);
+
+    sql << "insert into soci_test(id, tm, dt, r, d) values"
+           "(1, '2023-06-17 12:00:00.123456', '2023-06-17', 0.1, 0.1),"
+           "(2, 'infinity', 'infinity', 'Infinity', 'NaN'),"
+           "(3, '-infinity', '-infinity', '-Infinity', 1e100)";
+
+    // Retrieve the same values in text format using a one-time query to
+    // compare them with the values retrieved by a prepared statement.
+    for (int id = 1; id <= 3; ++id)
+    {
+        std::string tmText, dtText, rText, dText;
+        sql << "select tm, dt, r, d from soci_test where id = :id",
+            use(id), into(tmText), into(dtText), into(rText), into(dText);
+
+        std::string tm, dt, r, d;
+        statement st = (sql.prepare <<
+            "select tm, dt, r, d from soci_test where id = :id",
+            use(id), into(tm), into(dt), into(r), into(d));
+        st.execute(true);
+
+        CHECK(tm == tmText);
+        CHECK(dt == dtText);
+        CHECK(r == rText);
+        CHECK(d == dText);
+
+        if (id == 1)
+        {
+            CHECK(tm == "2023-06-17 12:00:00.123456");
+            CHECK(r == "0.1");
+            CHECK(d == "0.1");
+        }
+        else if (id == 2)
+        {
+            CHECK(tm == "infinity");
+            CHECK(dt == "infinity");
+        }
+        else
+        {
+            CHECK(tm == "-infinity");
+            CHECK(dt == "-infinity");
+        }
+    }
+
+    // Values retrieved as numbers or dates still use binary format.
+    {
+        std::tm tm = std::tm();
+        double d = 0;
+        int const id = 1;
+        statement st = (sql.prepare <<
+            "select tm, d from soci_test where id = :id",
+            use(id), into(tm), into(d));
+        st.execute(true);
+
+        CHECK(tm.tm_year == 2023 - 1900);
+        CHECK(tm.tm_hour == 12);
+        CHECK(tm.tm_sec == 0);
+        CHECK(d == 0.1);
+    }
+}
+
 // test INSERT INTO ... RETURNING syntax
 
 struct table_creator_for_test12 : table_creator_base
@@ -1125,6 +1594,106 @@ struct table_creator_three : public table_creator_base
     }
 };
 
+TEST_CASE("PostgreSQL bulk loader", "[postgresql][copy]")
+{
+    soci::session sql(backEnd, connectString);
+
+    table_creator_three tableCreator(sql);
+
+    SECTION("vectors")
+    {
+        std::vector<std::string> names;
+        std::vector<std::string> phones;
+        std::vector<indicator> inds;
+        for (int i = 0; i != 1000; ++i)
+        {
+            std::ostringstream oss;
+            oss << "name\t" << i << "\\";
+            names.push_back(oss.str());
+            phones.push_back("123");
+            inds.push_back(i % 2 ? i_null : i_ok);
+        }
+
+        bulk_loader loader(sql, "soci_test", "name, phone");
+        loader.exchange(use(names));
+        loader.exchange(use(phones, inds));
+        loader.load();
+        CHECK(loader.finish() == 1000);
+
+        int count = 0;
+        sql << "select count(*) from soci_test where phone is null",
+            into(count);
+        CHECK(count == 500);
+
+        // check that the special characters were transmitted correctly
+        sql << "select count(*) from soci_test where name = :name",
+            use(names[0]), into(count);
+        CHECK(count == 1);
+    }
+
+    SECTION("ORM")
+    {
+        PhonebookEntry p;
+
+        // use elements bound by name must have the same names as the columns
+        bulk_loader loader(sql, "soci_test", "NAME, PHONE");
+        loader.exchange(use(p));
+        for (int i = 0; i != 10; ++i)
+        {
+            std::ostringstream oss;
+            oss << "person " << i;
+            p.name = oss.str();
+            p.phone = "456";
+            loader.load();
+        }
+
+        CHECK(loader.finish() == 10);
+
+        int count = 0;
+        sql << "select count(*) from soci_test where phone = '456'",
+            into(count);
+        CHECK(count == 10);
+    }
+
+    SECTION("named with quoted columns")
+    {
+        // the order of the use elements doesn't matter when binding by name
+        std::string phone("789");
+        std::string name("somebody");
+
+        bulk_loader loader(sql, "soci_test", " \"phone\" , name ");
+        loader.exchange(use(name, "name"));
+        loader.exchange(use(phone, "phone"));
+        loader.load();
+        CHECK(loader.finish() == 1);
+
+        int count = 0;
+        sql << "select count(*) from soci_test "
+               "where name = 'somebody' and phone = '789'",
+            into(count);
+        CHECK(count == 1);
+    }
+
+    SECTION("error")
+    {
+        // name column is not nullable
+        std::string name;
+        indicator ind = i_null;
+
+        {
+            bulk_loader loader(sql, "soci_test", "name");
+            loader.exchange(use(name, ind));
+            loader.load();
+            CHECK_THROWS_AS(loader.finish(), soci_error&);
+        }
+
+        // The session must remain usable.
+        int count = -1;
+        sql << "select count(*) from soci_test", into(count);
+        CHECK(count == 0);
+    }
+}
+
 struct table_creator_for_get_affected_rows : table_creator_base
 {
     table_creator_for_get_affected_rows(soci::session & sql)
@@ -12,6 +12,7 @@
 #include <sstream>
 #include <string>
 #include <cmath>
+#include <cstdio>
 #include <cstring>
 #include <ctime>
 
@@ -147,6 +148,185 @@ TEST_CASE("SQLite use and vector into", "[sqlite][use][into][vector]")
 }
 
 
+TEST_CASE("SQLite vector into strings in batches", "[sqlite][into][vector]")
+{
+    soci::session sql(backEnd, connectString);
+
+    test3_table_creator tableCreator(sql);
+
+    for (int i = 0; i != 7; ++i)
+    {
+        std::string const name(i * 10, static_cast<char>('a' + i));
+        indicator ind = i == 3 ? i_null : i_ok;
+        sql << "insert into soci_test(id, name, subname) values(:id, :name, 'x')",
+            use(i), use(name, ind);
+    }
+
+    // The last batch is smaller than the previous ones and the buffers used
+    // for the previous batches are reused for it.
+    std::vector<std::string> names(3);
+    std::vector<indicator> inds(3);
+    statement st = (sql.prepare <<
+        "select name from soci_test order by id", into(names, inds));
+    st.execute();
+
+    int n = 0;
+    while (st.fetch())
+    {
+        for (std::size_t i = 0; i != names.size(); ++i, ++n)
+        {
+            if (n == 3)
+            {
+                CHECK(inds[i] == i_null);
+            }
+            else
+            {
+                REQUIRE(inds[i] == i_ok);
+                CHECK(names[i] == std::string(n * 10, static_cast<char>('a' + n)));
+            }
+        }
+    }
+
+    CHECK(n == 7);
+}
+
+struct test5_table_creator : table_creator_base
+{
+    test5_table_creator(soci::session & sql) : table_creator_base(sql)
+    {
+        sql << "create table soci_test(id integer primary key, name varchar, tm datetime)";
+    }
+};
+
+TEST_CASE("SQLite bulk insert", "[sqlite][use][vector]")
+{
+    soci::session sql(backEnd, connectString);
+
+    test5_table_creator tableCreator(sql);
+
+    std::vector<int> ids;
+    std::vector<std::string> names;
+    std::vector<indicator> inds;
+    std::vector<std::tm> tms;
+    for (int i = 0; i != 5; ++i)
+    {
+        ids.push_back(i);
+        names.push_back(std::string(i + 1, 'x'));
+        inds.push_back(i == 2 ? i_null : i_ok);
+
+        std::tm t = std::tm();
+        t.tm_year = 120;
+        t.tm_mon = 0;
+        t.tm_mday = i + 1;
+        tms.push_back(t);
+    }
+
+    sql << "insert into soci_test(id, name, tm) values(:id, :name, :tm)",
+        use(ids), use(names, inds), use(tms);
+
+    std::vector<std::string> names2(10);
+    std::vector<indicator> inds2(10);
+    std::vector<std::tm> tms2(10);
+    sql << "select name, tm from soci_test order by id",
+        into(names2, inds2), into(tms2);
+    REQUIRE(names2.size() == 5);
+    for (int i = 0; i != 5; ++i)
+    {
+        if (i == 2)
+        {
+            CHECK(inds2[i] == i_null);
+        }
+        else
+        {
+            CHECK(names2[i] == names[i]);
+        }
+        CHECK(tms2[i].tm_mday == i + 1);
+    }
+
+    SECTION("Rows before the failing one are kept")
+    {
+        std::vector<int> moreIds;
+        moreIds.push_back(10);
+        moreIds.push_back(11);
+        moreIds.push_back(1); // duplicate
+        moreIds.push_back(12);
+
+        CHECK_THROWS_AS((sql << "insert into soci_test(id) values(:id)",
+            use(moreIds)), soci_error&);
+
+        int count = 0;
+        sql << "select count(*) from soci_test", into(count);
+        CHECK(count == 7);
+    }
+
+    SECTION("Bulk insert in a transaction can be rolled back")
+    {
+        std::vector<int> moreIds;
+        moreIds.push_back(10);
+        moreIds.push_back(11);
+
+        {
+            transaction tr(sql);
+            sql << "insert into soci_test(id) values(:id)", use(moreIds);
+        }
+
+        int count = 0;
+        sql << "select count(*) from soci_test", into(count);
+        CHECK(count == 5);
+    }
+}
+
+TEST_CASE("SQLite bulk savepoint", "[sqlite][use][vector]")
+{
+    // A file is needed to use more than one connection to the same database.
+    char const* const dbname = "soci_bulk_savepoint_test.db";
+    std::remove(dbname);
+
+    {
+        soci::session sql(backEnd,
+            std::string("db=") + dbname + " bulk_savepoint=true");
+        soci::session sql2(backEnd, std::string("db=") + dbname);
+
+        sql << "create table soci_test(id integer primary key)";
+
+        std::vector<int> ids;
+        ids.push_back(1);
+        ids.push_back(2);
+        ids.push_back(3);
+
+        sql << "insert into soci_test(id) values(:id)", use(ids);
+
+        int count = 0;
+        sql2 << "select count(*) from soci_test", into(count);
+        CHECK(count == 3);
+
+        SECTION("Failure to commit doesn't leave a transaction open")
+        {
+            // Reading in a transaction in another connection prevents the
+            // savepoint from being committed.
+            sql2.begin();
+            sql2 << "select count(*) from soci_test", into(count);
+
+            std::vector<int> moreIds;
+            moreIds.push_back(10);
+            moreIds.push_back(11);
+
+            CHECK_THROWS_AS((sql << "insert into soci_test(id) values(:id)",
+                use(moreIds)), soci_error&);
+
+            sql2.rollback();
+
+            // Starting a transaction would fail if one were still open.
+            sql.begin();
+            sql << "select count(*) from soci_test", into(count);
+            CHECK(count == 3);
+            sql.commit();
+        }
+    }
+
+    std::remove(dbname);
+}
+
 // Test case from Amnon David 11/1/2007
 // I've noticed that table schemas in SQLite3 can sometimes have typeless
 // columns. One (and only?) example is the sqlite_sequence that sqlite
@@ -339,6 +519,123 @@ TEST_CASE("SQLite std::tm bind", "[sqlite][std-tm-bind]")
     CHECK(std::mktime(&result.front()) == std::mktime(&datetime));
 }
 
+TEST_CASE("SQLite statement cache", "[sqlite][statement-cache]")
+{
+    soci::session sql(backEnd, connectString);
+    test3_table_creator tableCreator(sql);
+
+    sql.set_statement_cache_size(10);
+
+    for (int i = 0; i != 10; ++i)
+    {
+        std::string const name = i % 2 ? "john" : "ann";
+        sql << "insert into soci_test(id, name) values(:id, :name)",
+            use(i, "id"), use(name, "name");
+    }
+
+    CHECK(sql.get_statement_cache_hits() == 9);
+    CHECK(sql.get_statement_cache_misses() == 1);
+
+    // The same query can be reused with different kinds of elements.
+    int count = 0;
+    std::string const john = "john";
+    sql << "select count(*) from soci_test where name = :name",
+        use(john), into(count);
+    CHECK(count == 5);
+
+    std::string const ann = "ann";
+    std::vector<int> ids(10);
+    sql << "select id from soci_test where name = :name",
+        use(ann, "name"), into(ids);
+    REQUIRE(ids.size() == 5);
+    CHECK(ids[4] == 8);
+
+    int id = 0;
+    sql << "select id from soci_test where name = :name",
+        use(john), into(id);
+    CHECK(id == 1);
+
+    CHECK(sql.get_statement_cache_hits() == 10);
+    CHECK(sql.get_statement_cache_misses() == 3);
+
+    // The statement above was not fully consumed, check that it doesn't
+    // prevent the table from being dropped once it's in the cache.
+    sql << "drop table soci_test";
+    sql << "create table soci_test(id integer, name varchar, subname varchar)";
+    sql << "select count(*) from soci_test where name = :name",
+        use(john), into(count);
+    CHECK(count == 0);
+
+    CHECK(sql.get_statement_cache_hits() == 11);
+    CHECK(sql.get_statement_cache_misses() == 5);
+}
+
+TEST_CASE("SQLite asynchronous execution error", "[sqlite][async]")
+{
+    soci::session sql(backEnd, connectString);
+
+    test5_table_creator tableCreator(sql);
+
+    int id = 1;
+    statement ins = (sql.prepare <<
+        "insert into soci_test(id) values(:id)", use(id));
+    ins.execute(true);
+
+    // The backend-specific exception is preserved when the statement is
+    // executed in another thread.
+    try
+    {
+        ins.execute_async(true).get();
+        FAIL("Expected exception not thrown");
+    }
+    catch (sqlite3_soci_error const& e)
+    {
+        CHECK((e.result() & 0xff) == SQLITE_CONSTRAINT);
+    }
+}
+
+TEST_CASE("SQLite query timeout", "[sqlite][timeout]")
+{
+    soci::session sql(backEnd, connectString);
+
+    // This query takes much longer than the timeout to execute.
+    char const* const slowQuery =
+        "with recursive c(x) as (select 1 union all select x + 1 from c) "
+        "select max(x) from (select x from c limit 1000000000)";
+
+    long long n = 0;
+
+    sql.set_query_timeout(100);
+    CHECK(sql.get_query_timeout() == 100);
+
+    try
+    {
+        sql << slowQuery, into(n);
+        FAIL("Expected exception not thrown");
+    }
+    catch (soci_error const& e)
+    {
+        CHECK(e.get_error_category() == soci_error::query_timeout);
+    }
+
+    // The timeout doesn't affect the next queries.
+    sql << "select 17", into(n);
+    CHECK(n == 17);
+
+    // It can also be set for just one statement, overriding the session one.
+    sql.set_query_timeout(0);
+
+    statement st = (sql.prepare << slowQuery, into(n));
+    st.set_timeout(100);
+    CHECK_THROWS_AS(st.execute(true), query_timeout_error&);
+
+    st.set_timeout(-1);
+    CHECK(st.get_timeout() == -1);
+
+    sql << "select 42", into(n);
+    CHECK(n == 42);
+}
+
 // DDL Creation objects for common tests
 struct table_creator_one : public table_creator_base
 {